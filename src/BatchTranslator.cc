@@ -0,0 +1,116 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <cstdio>
+#include <cstdint>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <exception>
+#include <iomanip>
+
+#include "BatchTranslator.hh"
+#include "BinaryReader.hh"
+#include "OutputFile.hh"
+#include "Util.hh"
+
+namespace turtle {
+	
+	BatchTranslator::Result BatchTranslator::translate(const Job &job)
+	{
+		typedef std::chrono::high_resolution_clock Clock;
+		
+		Clock::time_point start = Clock::now();
+		
+		Result result { job.input, job.output, 0, 0.0, std::string() };
+		
+		try {
+			std::string::size_type slash = job.output.find_last_of('/');
+			if (slash != std::string::npos && !makeDirectories(job.output.substr(0, slash)))
+				throw IOException("could not create directory for " + job.output);
+			
+			OutputFile file(job.output);
+			std::unique_ptr<TripleSink> sink = m_factory(file.stream());
+			sink->start();
+			m_reader(job.input, sink.get());
+			sink->end();
+			file.close();
+			result.count = sink->count();
+		} catch (ParseException &e) {
+			result.error = e.line() == -1 ? std::string("parse error: ") + e.what() : "parse error at line " + std::to_string(e.line()) + ": " + e.what();
+		} catch (std::exception &e) {
+			result.error = e.what();
+		}
+		
+		if (!result.error.empty())
+			std::remove(job.output.c_str());
+		
+		Clock::duration d = Clock::now() - start;
+		result.ms = static_cast<double>(1000 * d.count() * Clock::duration::period::num) / static_cast<double>(Clock::duration::period::den);
+		
+		return result;
+	}
+	
+	std::vector<BatchTranslator::Result> BatchTranslator::run(const std::vector<Job> &jobs, unsigned threads)
+	{
+		std::vector<std::uint64_t> sizes;
+		std::vector<std::size_t> schedule;
+		for (std::size_t i = 0; i < jobs.size(); i++) {
+			sizes.push_back(fileSize(jobs[i].input));
+			schedule.push_back(i);
+		}
+		
+		std::stable_sort(schedule.begin(), schedule.end(), [&sizes](std::size_t a, std::size_t b) { return sizes[a] > sizes[b]; });
+		
+		std::vector<Result> results(jobs.size());
+		std::size_t next = 0;
+		std::mutex mutex;
+		
+		auto work = [&]() {
+			for (;;) {
+				std::size_t i;
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					if (next == schedule.size())
+						return;
+					i = schedule[next++];
+				}
+				
+				results[i] = translate(jobs[i]);
+			}
+		};
+		
+		threads = std::max(1u, std::min(threads, static_cast<unsigned>(jobs.size())));
+		
+		std::vector<std::thread> pool;
+		for (unsigned t = 1; t < threads; t++)
+			pool.emplace_back(work);
+		work();
+		for (std::thread &t : pool)
+			t.join();
+		
+		return results;
+	}
+	
+	void BatchTranslator::summary(std::ostream &out, const std::vector<Result> &results)
+	{
+		out << "input\toutput\ttriples\tms\terror\n" << std::fixed << std::setprecision(1);
+		for (const Result &r : results)
+			out << r.input << '\t' << r.output << '\t' << r.count << '\t' << r.ms << '\t' << r.error << '\n';
+	}
+	
+}
@@ -0,0 +1,76 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef N3_BATCHTRANSLATOR_HH
+#define N3_BATCHTRANSLATOR_HH
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <ostream>
+#include <functional>
+
+#include "Parser.hh"
+#include "ParallelReader.hh"
+
+namespace turtle {
+	
+	///
+	/// Translates every input to an output file of its own, on a pool of
+	/// threads, the largest inputs first. A failing input does not stop the
+	/// others, its error is recorded in the result and its output removed.
+	///
+	class BatchTranslator {
+	public:
+		/// creates the sink chain writing to out
+		typedef std::function<std::unique_ptr<TripleSink> (std::ostream &out)> SinkFactory;
+		typedef ParallelReader::Reader Reader;
+		
+		struct Job {
+			std::string input;
+			std::string output;
+		};
+		
+		struct Result {
+			std::string input;
+			std::string output;
+			unsigned count;
+			double ms;
+			std::string error; // empty on success
+		};
+		
+	private:
+		SinkFactory m_factory;
+		Reader m_reader;
+		
+		Result translate(const Job &job);
+		
+	public:
+		BatchTranslator(SinkFactory factory, Reader reader) : m_factory(factory), m_reader(reader)
+		{
+			// nop
+		}
+		
+		/// results are in the order of jobs
+		std::vector<Result> run(const std::vector<Job> &jobs, unsigned threads);
+		
+		/// Tab separated: input, output, triples, milliseconds, error.
+		static void summary(std::ostream &out, const std::vector<Result> &results);
+	};
+
+}
+
+#endif /* N3_BATCHTRANSLATOR_HH */
@@ -0,0 +1,248 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#ifndef N3_BINARY_HH
+#define N3_BINARY_HH
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+#include <streambuf>
+#include <stdexcept>
+
+namespace turtle {
+	
+	class BinaryFormatException : public std::runtime_error {
+	public:
+		explicit BinaryFormatException(const std::string &message = std::string()) : std::runtime_error(message) {}
+	};
+	
+	///
+	/// Stream buffer appending everything written to it to a std::string.
+	///
+	class StringOutputBuffer : public std::streambuf {
+		std::string &m_target;
+	protected:
+		int_type overflow(int_type c) override
+		{
+			if (!traits_type::eq_int_type(c, traits_type::eof()))
+				m_target.push_back(traits_type::to_char_type(c));
+			
+			return traits_type::not_eof(c);
+		}
+		
+		std::streamsize xsputn(const char_type *s, std::streamsize n) override
+		{
+			m_target.append(s, n);
+			
+			return n;
+		}
+	public:
+		explicit StringOutputBuffer(std::string &target) : std::streambuf(), m_target(target) {}
+	};
+	
+	///
+	/// Stream buffer reading from a range of characters, without copying them.
+	///
+	class StringInputBuffer : public std::streambuf {
+	public:
+		StringInputBuffer(const char *data, std::size_t length) : std::streambuf()
+		{
+			char *p = const_cast<char *>(data);
+			setg(p, p, p + length);
+		}
+		
+		explicit StringInputBuffer(const std::string &data) : StringInputBuffer(data.data(), data.size()) {}
+	};
+	
+	namespace binary {
+		
+		/// LEB128 encoding of unsigned integers.
+		inline void writeVarInt(std::streambuf *out, std::uint64_t value)
+		{
+			while (value >= 0x80) {
+				out->sputc(static_cast<char>((value & 0x7F) | 0x80));
+				value >>= 7;
+			}
+			out->sputc(static_cast<char>(value));
+		}
+		
+		inline void writeVarInt(std::string &out, std::uint64_t value)
+		{
+			while (value >= 0x80) {
+				out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+				value >>= 7;
+			}
+			out.push_back(static_cast<char>(value));
+		}
+		
+		inline std::uint64_t readVarInt(std::streambuf *in)
+		{
+			std::uint64_t value = 0;
+			
+			for (int shift = 0; shift < 64; shift += 7) {
+				std::streambuf::int_type c = in->sbumpc();
+				if (std::streambuf::traits_type::eq_int_type(c, std::streambuf::traits_type::eof()))
+					throw BinaryFormatException("unexpected end of input");
+				
+				value |= static_cast<std::uint64_t>(c & 0x7F) << shift;
+				if (!(c & 0x80))
+					return value;
+			}
+			
+			throw BinaryFormatException("invalid variable length integer");
+		}
+		
+		inline void writeString(std::streambuf *out, const std::string &s)
+		{
+			writeVarInt(out, s.length());
+			out->sputn(s.data(), s.length());
+		}
+		
+		/// Reads in chunks, so that a corrupt length fails at the end of the input rather than on allocation.
+		inline void readBytes(std::streambuf *in, std::string &s, std::uint64_t length)
+		{
+			const std::size_t CHUNK = 65536;
+			
+			s.clear();
+			while (s.length() < length) {
+				std::size_t offset = s.length();
+				std::size_t n = static_cast<std::size_t>(std::min<std::uint64_t>(length - offset, CHUNK));
+				s.resize(offset + n);
+				if (static_cast<std::size_t>(in->sgetn(&s[offset], n)) != n)
+					throw BinaryFormatException("unexpected end of input");
+			}
+		}
+		
+		inline void readString(std::streambuf *in, std::string &s)
+		{
+			readBytes(in, s, readVarInt(in));
+		}
+		
+		inline void readMagic(std::streambuf *in, const char *magic, std::size_t length)
+		{
+			std::string m;
+			readBytes(in, m, length);
+			if (m.compare(0, length, magic, length) != 0)
+				throw BinaryFormatException("unrecognized file format");
+		}
+		
+		/// Zigzag encoding, maps signed integers of small magnitude to small unsigned integers.
+		inline std::uint64_t zigzag(std::int64_t value)
+		{
+			return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+		}
+		
+		inline std::int64_t unzigzag(std::uint64_t value)
+		{
+			return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+		}
+		
+		/// Number of bits needed to store values up to and including max.
+		inline unsigned bits(std::uint64_t max)
+		{
+			unsigned n = 0;
+			while (max) {
+				++n;
+				max >>= 1;
+			}
+			return n;
+		}
+		
+		///
+		/// Fixed width bit packed integer array (HDT "log sequence").
+		///
+		class PackedArray {
+			std::vector<std::uint64_t> m_words;
+			std::size_t m_size;
+			unsigned m_width;
+		public:
+			PackedArray(unsigned width = 0) : m_words(), m_size(0), m_width(width) {}
+			
+			unsigned width() const { return m_width; }
+			std::size_t size() const { return m_size; }
+			
+			void push_back(std::uint64_t value)
+			{
+				if (m_width) {
+					std::size_t bit = m_size * m_width;
+					std::size_t word = bit / 64, offset = bit % 64;
+					
+					if (word + 1 >= m_words.size())
+						m_words.resize(word + 2, 0);
+					
+					m_words[word] |= value << offset;
+					if (offset + m_width > 64)
+						m_words[word + 1] |= value >> (64 - offset);
+				}
+				
+				++m_size;
+			}
+			
+			std::uint64_t operator[](std::size_t index) const
+			{
+				if (!m_width)
+					return 0;
+				
+				std::size_t bit = index * m_width;
+				std::size_t word = bit / 64, offset = bit % 64;
+				std::uint64_t mask = m_width == 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << m_width) - 1;
+				
+				std::uint64_t value = m_words[word] >> offset;
+				if (offset + m_width > 64)
+					value |= m_words[word + 1] << (64 - offset);
+				
+				return value & mask;
+			}
+			
+			void write(std::streambuf *out) const
+			{
+				writeVarInt(out, m_size);
+				out->sputc(static_cast<char>(m_width));
+				
+				std::size_t bytes = (m_size * m_width + 7) / 8;
+				for (std::size_t i = 0; i < bytes; i++)
+					out->sputc(static_cast<char>(m_words[i / 8] >> (8 * (i % 8))));
+			}
+			
+			void read(std::streambuf *in)
+			{
+				std::uint64_t size = readVarInt(in);
+				std::streambuf::int_type w = in->sbumpc();
+				if (w < 0 || w > 64 || size > std::numeric_limits<std::size_t>::max() / 64)
+					throw BinaryFormatException("invalid packed array");
+				m_size  = static_cast<std::size_t>(size);
+				m_width = static_cast<unsigned>(w);
+				
+				std::size_t bytes = (m_size * m_width + 7) / 8;
+				std::string data;
+				readBytes(in, data, bytes);
+				
+				m_words.assign(bytes / 8 + 2, 0);
+				for (std::size_t i = 0; i < bytes; i++)
+					m_words[i / 8] |= static_cast<std::uint64_t>(static_cast<unsigned char>(data[i])) << (8 * (i % 8));
+			}
+		};
+		
+	}
+
+}
+
+#endif /* N3_BINARY_HH */
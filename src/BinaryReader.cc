@@ -0,0 +1,158 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#include "BinaryReader.hh"
+
+namespace turtle {
+	
+	const std::string &BinaryTermDecoder::language()
+	{
+		std::uint64_t distance = binary::readVarInt(m_inbuf);
+		if (distance)
+			return m_languages.get(distance);
+		
+		m_languages.add(string());
+		
+		return m_string;
+	}
+	
+	std::shared_ptr<const URIResource> BinaryTermDecoder::iri()
+	{
+		std::uint64_t distance = binary::readVarInt(m_inbuf);
+		if (distance)
+			return m_iris.get(distance);
+		
+		std::shared_ptr<const URIResource> r = std::make_shared<URIResource>(string());
+		m_iris.add(r);
+		
+		return r;
+	}
+	
+	std::shared_ptr<const N3Node> BinaryTermDecoder::term()
+	{
+		return term(tag());
+	}
+	
+	std::shared_ptr<const N3Node> BinaryTermDecoder::term(BinaryTag::Type t)
+	{
+		switch (t) {
+			case BinaryTag::Iri :
+				return iri();
+			case BinaryTag::Blank : {
+				std::uint64_t distance = binary::readVarInt(m_inbuf);
+				if (distance)
+					return m_blanks.get(distance);
+				
+				std::shared_ptr<const BlankNode> b = std::make_shared<BlankNode>(string());
+				m_blanks.add(b);
+				
+				return b;
+			}
+			case BinaryTag::String :
+				return std::make_shared<StringLiteral>(string());
+			case BinaryTag::LangString : {
+				std::string lexical = string();
+				return std::make_shared<StringLiteral>(lexical, m_languageEntries.intern(language()));
+			}
+			case BinaryTag::Typed : {
+				std::string lexical = string();
+				return std::make_shared<OtherLiteral>(lexical, m_datatypes.intern(iri()->uri()));
+			}
+			case BinaryTag::Integer :
+				return std::make_shared<IntegerLiteral>(std::to_string(binary::unzigzag(binary::readVarInt(m_inbuf))));
+			case BinaryTag::IntegerLexical :
+				return std::make_shared<IntegerLiteral>(string());
+			case BinaryTag::Decimal : {
+				std::int64_t unscaled = binary::unzigzag(binary::readVarInt(m_inbuf));
+				return std::make_shared<DecimalLiteral>(BinaryTermEncoder::formatDecimal(unscaled, binary::readVarInt(m_inbuf)));
+			}
+			case BinaryTag::DecimalLexical :
+				return std::make_shared<DecimalLiteral>(string());
+			case BinaryTag::Double :
+				return std::make_shared<DoubleLiteral>(string());
+			case BinaryTag::True :
+				return std::make_shared<BooleanLiteral>(BooleanLiteral::VALUE_TRUE);
+			case BinaryTag::False :
+				return std::make_shared<BooleanLiteral>(BooleanLiteral::VALUE_FALSE);
+			case BinaryTag::BooleanLexical :
+				return std::make_shared<BooleanLiteral>(string());
+			case BinaryTag::List : {
+				std::uint64_t n = binary::readVarInt(m_inbuf);
+				std::shared_ptr<RDFList> list = std::make_shared<RDFList>();
+				for (std::uint64_t i = 0; i < n; i++)
+					list->add(term()->clone());
+				return list;
+			}
+			default :
+				throw BinaryFormatException("unknown term type " + std::to_string(t));
+		}
+	}
+	
+	void BinaryReader::read()
+	{
+		binary::readMagic(m_inbuf, BinaryWriter::MAGIC, BinaryWriter::MAGIC_LENGTH);
+		std::uint64_t cacheSize = binary::readVarInt(m_inbuf);
+		if (cacheSize > BinaryTermEncoder::CACHE_SIZE)
+			throw BinaryFormatException("cache size " + std::to_string(cacheSize) + " exceeds " + std::to_string(BinaryTermEncoder::CACHE_SIZE));
+		m_decoder.resize(cacheSize);
+		
+		std::string prefix, ns;
+		
+		for (std::streambuf::int_type c = m_inbuf->sbumpc(); !std::streambuf::traits_type::eq_int_type(c, std::streambuf::traits_type::eof()); c = m_inbuf->sbumpc()) {
+			switch (c) {
+				case BinaryTag::Triple : {
+					std::shared_ptr<const N3Node> subject  = m_decoder.term();
+					std::shared_ptr<const URIResource> property = m_decoder.iri();
+					std::shared_ptr<const N3Node> object   = m_decoder.term();
+					
+					const Resource *s = dynamic_cast<const Resource *>(subject.get());
+					if (!s)
+						throw BinaryFormatException("literal used as subject");
+					
+					m_sink->triple(*s, *property, *object);
+					break;
+				}
+				case BinaryTag::Quad : {
+					std::shared_ptr<const N3Node> subject  = m_decoder.term();
+					std::shared_ptr<const URIResource> property = m_decoder.iri();
+					std::shared_ptr<const N3Node> object   = m_decoder.term();
+					std::shared_ptr<const N3Node> graph    = m_decoder.term();
+					
+					const Resource *s = dynamic_cast<const Resource *>(subject.get());
+					const Resource *g = dynamic_cast<const Resource *>(graph.get());
+					if (!s || !g)
+						throw BinaryFormatException("literal used as subject or graph");
+					
+					m_sink->quad(*s, *property, *object, *g);
+					break;
+				}
+				case BinaryTag::Prefix :
+					binary::readString(m_inbuf, prefix);
+					binary::readString(m_inbuf, ns);
+					m_sink->prefix(prefix, ns);
+					break;
+				case BinaryTag::Document :
+					binary::readString(m_inbuf, ns);
+					m_sink->document(ns);
+					break;
+				default :
+					throw BinaryFormatException("unknown record type " + std::to_string(c));
+			}
+		}
+	}
+	
+}
@@ -0,0 +1,137 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#ifndef N3_BINARYREADER_HH
+#define N3_BINARYREADER_HH
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <memory>
+#include <istream>
+
+#include "Parser.hh"
+#include "Model.hh"
+#include "Binary.hh"
+#include "BinaryWriter.hh"
+
+namespace turtle {
+	
+	///
+	/// Counterpart of ReferenceCache, holds the last size() values read.
+	///
+	template<typename T>
+	class ReferenceTable {
+		std::vector<T> m_ring;
+		std::uint64_t m_next;
+	public:
+		explicit ReferenceTable(std::size_t size) : m_ring(size), m_next(0) {}
+		
+		void resize(std::size_t size)
+		{
+			m_ring.assign(size, T());
+			m_next = 0;
+		}
+		
+		void add(const T &value)
+		{
+			if (!m_ring.empty())
+				m_ring[m_next++ % m_ring.size()] = value;
+		}
+		
+		const T &get(std::uint64_t distance) const
+		{
+			if (distance > m_next || distance > m_ring.size())
+				throw BinaryFormatException("invalid back reference");
+			
+			return m_ring[(m_next - distance) % m_ring.size()];
+		}
+	};
+	
+	
+	class BinaryTermDecoder {
+		
+		std::streambuf *m_inbuf;
+		ReferenceTable<std::shared_ptr<const URIResource>> m_iris;
+		ReferenceTable<std::shared_ptr<const BlankNode>> m_blanks;
+		ReferenceTable<std::string> m_languages;
+		InternCache m_languageEntries;
+		InternCache m_datatypes;
+		std::string m_string;
+		
+		BinaryTag::Type tag()
+		{
+			std::streambuf::int_type c = m_inbuf->sbumpc();
+			if (std::streambuf::traits_type::eq_int_type(c, std::streambuf::traits_type::eof()))
+				throw BinaryFormatException("unexpected end of input");
+			
+			return static_cast<BinaryTag::Type>(c);
+		}
+		
+		const std::string &string()
+		{
+			binary::readString(m_inbuf, m_string);
+			
+			return m_string;
+		}
+		
+		const std::string &language();
+		
+	public:
+		explicit BinaryTermDecoder(std::streambuf *inbuf, std::size_t cacheSize = BinaryTermEncoder::CACHE_SIZE) : m_inbuf(inbuf), m_iris(cacheSize), m_blanks(cacheSize), m_languages(cacheSize), m_languageEntries(), m_datatypes(), m_string()
+		{
+			// nop
+		}
+		
+		void resize(std::size_t cacheSize)
+		{
+			m_iris.resize(cacheSize);
+			m_blanks.resize(cacheSize);
+			m_languages.resize(cacheSize);
+		}
+		
+		std::shared_ptr<const URIResource> iri();
+		std::shared_ptr<const N3Node> term();
+		std::shared_ptr<const N3Node> term(BinaryTag::Type t);
+	};
+	
+	
+	///
+	/// Reads the output of BinaryWriter and passes it on to a TripleSink.
+	///
+	class BinaryReader {
+		
+		std::streambuf *m_inbuf;
+		TripleSink *m_sink;
+		BinaryTermDecoder m_decoder;
+		
+	public:
+		BinaryReader(std::istream *in, TripleSink *sink) : m_inbuf(in->rdbuf()), m_sink(sink), m_decoder(in->rdbuf()) {}
+		
+		/// true if the next byte of in starts the BinaryWriter::MAGIC header
+		static bool accepts(std::istream &in)
+		{
+			return in.peek() == 0x8A;
+		}
+		
+		void read();
+	};
+
+}
+
+#endif /* N3_BINARYREADER_HH */
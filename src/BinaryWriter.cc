@@ -0,0 +1,176 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#include "BinaryWriter.hh"
+
+namespace turtle {
+	
+	const char BinaryWriter::MAGIC[] = "\x8A" "CTB\r\n\x1A\n";
+	
+	void BinaryTermEncoder::visit(const URIResource &resource)
+	{
+		tag(BinaryTag::Iri);
+		reference(m_iris, resource.uri());
+	}
+	
+	void BinaryTermEncoder::visit(const BlankNode &blankNode)
+	{
+		tag(BinaryTag::Blank);
+		reference(m_blanks, blankNode.id());
+	}
+	
+	void BinaryTermEncoder::visit(const Literal &literal)
+	{
+		tag(BinaryTag::Typed);
+		binary::writeString(m_outbuf, literal.lexical());
+		reference(m_iris, literal.datatype());
+	}
+	
+	void BinaryTermEncoder::visit(const RDFList &list)
+	{
+		tag(BinaryTag::List);
+		binary::writeVarInt(m_outbuf, list.size());
+		for (const N3Node *n : list)
+			n->visit(*this);
+	}
+	
+	void BinaryTermEncoder::visit(const BooleanLiteral &literal)
+	{
+		const std::string &lexical = literal.lexical();
+		
+		if (lexical == BooleanLiteral::VALUE_TRUE.lexical()) {
+			tag(BinaryTag::True);
+		} else if (lexical == BooleanLiteral::VALUE_FALSE.lexical()) {
+			tag(BinaryTag::False);
+		} else {
+			tag(BinaryTag::BooleanLexical);
+			binary::writeString(m_outbuf, lexical);
+		}
+	}
+	
+	void BinaryTermEncoder::visit(const IntegerLiteral &literal)
+	{
+		std::int64_t value;
+		
+		if (parseInteger(literal.lexical(), &value)) {
+			tag(BinaryTag::Integer);
+			binary::writeVarInt(m_outbuf, binary::zigzag(value));
+		} else {
+			tag(BinaryTag::IntegerLexical);
+			binary::writeString(m_outbuf, literal.lexical());
+		}
+	}
+	
+	void BinaryTermEncoder::visit(const DoubleLiteral &literal)
+	{
+		// the lexical form is kept, printing a double seldom gives back the original form
+		tag(BinaryTag::Double);
+		binary::writeString(m_outbuf, literal.lexical());
+	}
+	
+	void BinaryTermEncoder::visit(const DecimalLiteral &literal)
+	{
+		std::int64_t unscaled;
+		std::uint64_t scale;
+		
+		if (parseDecimal(literal.lexical(), &unscaled, &scale)) {
+			tag(BinaryTag::Decimal);
+			binary::writeVarInt(m_outbuf, binary::zigzag(unscaled));
+			binary::writeVarInt(m_outbuf, scale);
+		} else {
+			tag(BinaryTag::DecimalLexical);
+			binary::writeString(m_outbuf, literal.lexical());
+		}
+	}
+	
+	void BinaryTermEncoder::visit(const StringLiteral &literal)
+	{
+		if (literal.language().empty()) {
+			tag(BinaryTag::String);
+			binary::writeString(m_outbuf, literal.lexical());
+		} else {
+			tag(BinaryTag::LangString);
+			binary::writeString(m_outbuf, literal.lexical());
+			reference(m_languages, literal.language());
+		}
+	}
+	
+	///
+	/// Only accepts the forms that are reproduced exactly by std::to_string:
+	/// no '+' sign, no leading zeros, no "-0", at most 18 digits.
+	///
+	bool BinaryTermEncoder::parseInteger(const std::string &lexical, std::int64_t *value)
+	{
+		std::size_t length = lexical.length();
+		std::size_t i = (length > 0 && lexical[0] == '-') ? 1 : 0;
+		std::size_t digits = length - i;
+		
+		if (digits == 0 || digits > 18 || (lexical[i] == '0' && (digits > 1 || i == 1)))
+			return false;
+		
+		std::int64_t v = 0;
+		for (; i < length; i++) {
+			unsigned d = static_cast<unsigned char>(lexical[i]) - '0';
+			if (d > 9)
+				return false;
+			v = 10 * v + d;
+		}
+		
+		*value = lexical[0] == '-' ? -v : v;
+		
+		return true;
+	}
+	
+	bool BinaryTermEncoder::parseDecimal(const std::string &lexical, std::int64_t *unscaled, std::uint64_t *scale)
+	{
+		std::size_t p = lexical.find('.');
+		if (p == std::string::npos || p + 1 == lexical.length())
+			return false;
+		
+		std::string digits = lexical.substr(0, p) + lexical.substr(p + 1);
+		
+		bool negative = !digits.empty() && digits[0] == '-';
+		std::size_t start = negative ? 1 : 0;
+		while (start + 1 < digits.length() && digits[start] == '0')
+			++start;
+		
+		std::int64_t v;
+		if (!parseInteger(digits.substr(start), &v))
+			return false;
+		
+		*unscaled = negative ? -v : v;
+		*scale    = lexical.length() - p - 1;
+		
+		return formatDecimal(*unscaled, *scale) == lexical;
+	}
+	
+	std::string BinaryTermEncoder::formatDecimal(std::int64_t unscaled, std::uint64_t scale)
+	{
+		std::string digits = std::to_string(unscaled < 0 ? -unscaled : unscaled);
+		
+		if (digits.length() <= scale)
+			digits.insert(0, scale + 1 - digits.length(), '0');
+		
+		digits.insert(digits.length() - scale, 1, '.');
+		
+		if (unscaled < 0)
+			digits.insert(0, 1, '-');
+		
+		return digits;
+	}
+	
+}
@@ -0,0 +1,226 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#ifndef N3_BINARYWRITER_HH
+#define N3_BINARYWRITER_HH
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <ostream>
+
+#include "Parser.hh"
+#include "Model.hh"
+#include "Binary.hh"
+
+namespace turtle {
+	
+	///
+	/// Record and term tags of the binary row format:
+	///
+	/// stream   -> MAGIC varint(cache size) record*
+	/// record   -> Document string | Prefix string string | Triple term iri term | Quad term iri term term
+	/// term     -> Iri iri | Blank ref | String string | LangString string ref | Typed string iri
+	///           | Integer varint(zigzag) | Decimal varint(zigzag unscaled) varint(scale) | True | False
+	///           | IntegerLexical string | DecimalLexical string | Double string | BooleanLexical string
+	///           | List varint(n) term*n
+	/// iri, ref -> varint(0) string | varint(distance to earlier occurrence)
+	/// string   -> varint(length) bytes
+	///
+	struct BinaryTag {
+		
+		typedef unsigned char Type;
+		
+		static const Type Document       = 'D';
+		static const Type Prefix         = 'P';
+		static const Type Triple         = 'T';
+		static const Type Quad           = 'Q';
+		
+		static const Type Iri            = 1;
+		static const Type Blank          = 2;
+		static const Type String         = 3;
+		static const Type LangString     = 4;
+		static const Type Typed          = 5;
+		static const Type Integer        = 6;
+		static const Type IntegerLexical = 7;
+		static const Type Decimal        = 8;
+		static const Type DecimalLexical = 9;
+		static const Type Double         = 10;
+		static const Type True           = 11;
+		static const Type False          = 12;
+		static const Type BooleanLexical = 13;
+		static const Type List           = 14;
+	};
+	
+	
+	///
+	/// Remembers the last size() strings written, so that repeated ones can be
+	/// replaced by their distance to the earlier occurrence.
+	///
+	class ReferenceCache {
+		std::vector<std::string> m_ring;
+		std::unordered_map<std::string, std::uint64_t> m_index;
+		std::uint64_t m_next;
+	public:
+		explicit ReferenceCache(std::size_t size) : m_ring(size), m_index(), m_next(0) {}
+		
+		std::size_t size() const { return m_ring.size(); }
+		
+		/// Returns the distance to the previous occurrence of value (1 for the last one), or 0 if value was not present.
+		std::uint64_t reference(const std::string &value)
+		{
+			if (m_ring.empty())
+				return 0;
+			
+			auto i = m_index.find(value);
+			if (i != m_index.end())
+				return m_next - i->second;
+			
+			std::string &slot = m_ring[m_next % m_ring.size()];
+			if (m_next >= m_ring.size())
+				m_index.erase(slot);
+			
+			slot = value;
+			m_index.emplace(value, m_next++);
+			
+			return 0;
+		}
+	};
+	
+	
+	class BinaryTermEncoder : public N3NodeVisitor {
+		
+		std::streambuf *m_outbuf;
+		ReferenceCache m_iris;
+		ReferenceCache m_blanks;
+		ReferenceCache m_languages;
+		
+		void reference(ReferenceCache &cache, const std::string &value)
+		{
+			std::uint64_t distance = cache.reference(value);
+			binary::writeVarInt(m_outbuf, distance);
+			if (!distance)
+				binary::writeString(m_outbuf, value);
+		}
+		
+		void tag(BinaryTag::Type t)
+		{
+			m_outbuf->sputc(static_cast<char>(t));
+		}
+		
+	public:
+		static const std::size_t CACHE_SIZE = 4096;
+		
+		/// cacheSize 0 makes every encoded term self-contained.
+		explicit BinaryTermEncoder(std::streambuf *outbuf, std::size_t cacheSize = CACHE_SIZE) : N3NodeVisitor(), m_outbuf(outbuf), m_iris(cacheSize), m_blanks(cacheSize), m_languages(cacheSize)
+		{
+			// nop
+		}
+		
+		std::size_t cacheSize() const { return m_iris.size(); }
+		
+		void iri(const std::string &uri)
+		{
+			reference(m_iris, uri);
+		}
+		
+		void visit(const URIResource &resource) override;
+		void visit(const BlankNode &blankNode) override;
+		void visit(const Literal &literal) override;
+		void visit(const RDFList &list) override;
+		void visit(const BooleanLiteral &literal) override;
+		void visit(const IntegerLiteral &literal) override;
+		void visit(const DoubleLiteral &literal) override;
+		void visit(const DecimalLiteral &literal) override;
+		void visit(const StringLiteral &literal) override;
+		
+		static bool parseInteger(const std::string &lexical, std::int64_t *value);
+		static bool parseDecimal(const std::string &lexical, std::int64_t *unscaled, std::uint64_t *scale);
+		static std::string formatDecimal(std::int64_t unscaled, std::uint64_t scale);
+	};
+	
+	
+	///
+	/// Writes triples in a compact streaming binary format, meant for passing
+	/// triples between cturtle processes. Read it back with BinaryReader.
+	///
+	class BinaryWriter : public TripleSink {
+		
+		std::streambuf *m_outbuf;
+		BinaryTermEncoder m_encoder;
+		unsigned m_count;
+		
+	public:
+		static const char MAGIC[];
+		static const std::size_t MAGIC_LENGTH = 8;
+		
+		explicit BinaryWriter(std::ostream &out) : TripleSink(), m_outbuf(out.rdbuf()), m_encoder(out.rdbuf()), m_count(0)
+		{
+			// nop
+		}
+		
+		void start() override
+		{
+			m_outbuf->sputn(MAGIC, MAGIC_LENGTH);
+			binary::writeVarInt(m_outbuf, m_encoder.cacheSize());
+		}
+		
+		void end() override
+		{
+			m_outbuf->pubsync();
+		}
+		
+		void document(const std::string &source) override
+		{
+			m_outbuf->sputc(static_cast<char>(BinaryTag::Document));
+			binary::writeString(m_outbuf, source);
+		}
+		
+		void prefix(const std::string &prefix, const std::string &ns) override
+		{
+			m_outbuf->sputc(static_cast<char>(BinaryTag::Prefix));
+			binary::writeString(m_outbuf, prefix);
+			binary::writeString(m_outbuf, ns);
+		}
+		
+		void triple(const Resource &subject, const URIResource &property, const N3Node &object) override
+		{
+			m_outbuf->sputc(static_cast<char>(BinaryTag::Triple));
+			subject.visit(m_encoder);
+			m_encoder.iri(property.uri());
+			object.visit(m_encoder);
+			m_count++;
+		}
+		
+		void quad(const Resource &subject, const URIResource &property, const N3Node &object, const Resource &graph) override
+		{
+			m_outbuf->sputc(static_cast<char>(BinaryTag::Quad));
+			subject.visit(m_encoder);
+			m_encoder.iri(property.uri());
+			object.visit(m_encoder);
+			graph.visit(m_encoder);
+			m_count++;
+		}
+		
+		unsigned count() const override { return m_count; }
+	};
+
+}
+
+#endif /* N3_BINARYWRITER_HH */
@@ -42,6 +42,16 @@ namespace turtle {
 		}
 		
 		void initialize();
+		
+		const std::string &prefix() const { return m_prefix; }
+		unsigned counter() const { return m_c; }
+		
+		/// continues with the ids of an earlier generator
+		void restore(const std::string &prefix, unsigned counter)
+		{
+			m_prefix = prefix;
+			m_c = counter;
+		}
 	};
 
 }
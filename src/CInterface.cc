@@ -0,0 +1,224 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#define CTURTLE_BUILD
+
+#include <cstring>
+#include <string>
+#include <istream>
+#include <exception>
+
+#include "cturtle.h"
+#include "Parser.hh"
+#include "Model.hh"
+#include "Uri.hh"
+#include "ListExpander.hh"
+#include "Binary.hh"
+#include "FileDescriptorBuffer.hh"
+#include "Version.hh"
+
+namespace {
+	
+	const std::string LANG_STRING = "http://www.w3.org/1999/02/22-rdf-syntax-ns#langString";
+	
+	/// thrown when a callback asks to stop
+	struct Aborted {};
+	
+	///
+	/// Points a cturtle_term at the strings of a node, nothing is copied.
+	///
+	class TermConverter : public turtle::N3NodeVisitor {
+		
+		cturtle_term *m_term;
+		
+		void set(cturtle_term_type type, const std::string &value)
+		{
+			m_term->type = type;
+			m_term->value = value.data();
+			m_term->value_length = value.length();
+			m_term->datatype = nullptr;
+			m_term->datatype_length = 0;
+			m_term->language = nullptr;
+			m_term->language_length = 0;
+		}
+		
+		void literal(const turtle::Literal &literal)
+		{
+			set(CTURTLE_LITERAL, literal.lexical());
+			m_term->datatype = literal.datatype().data();
+			m_term->datatype_length = literal.datatype().length();
+		}
+		
+	public:
+		TermConverter() : N3NodeVisitor(), m_term(nullptr) {}
+		
+		void convert(const turtle::N3Node &node, cturtle_term *term)
+		{
+			m_term = term;
+			node.visit(*this);
+		}
+		
+		void visit(const turtle::URIResource &resource) override { set(CTURTLE_IRI, resource.uri()); }
+		void visit(const turtle::BlankNode &blankNode) override  { set(CTURTLE_BLANK, blankNode.id()); }
+		
+		void visit(const turtle::Literal &literal) override        { this->literal(literal); }
+		void visit(const turtle::BooleanLiteral &literal) override { this->literal(literal); }
+		void visit(const turtle::IntegerLiteral &literal) override { this->literal(literal); }
+		void visit(const turtle::DoubleLiteral &literal) override  { this->literal(literal); }
+		void visit(const turtle::DecimalLiteral &literal) override { this->literal(literal); }
+		
+		void visit(const turtle::StringLiteral &literal) override
+		{
+			this->literal(literal);
+			
+			const std::string &language = literal.language();
+			if (!language.empty()) {
+				m_term->datatype = LANG_STRING.data();
+				m_term->datatype_length = LANG_STRING.length();
+				m_term->language = language.data();
+				m_term->language_length = language.length();
+			}
+		}
+		
+		void visit(const turtle::RDFList &list) override
+		{
+			// nop, expanded before conversion
+		}
+	};
+	
+	
+	class CallbackSink : public turtle::TripleSink {
+		
+		const cturtle_callbacks *m_callbacks;
+		turtle::ListExpander m_lists;
+		TermConverter m_converter;
+		cturtle_term m_terms[4];
+		unsigned m_count;
+		
+		void emit(const turtle::Resource &subject, const turtle::URIResource &property, const turtle::N3Node &object, const turtle::Resource *graph)
+		{
+			m_converter.convert(subject, &m_terms[0]);
+			m_converter.convert(property, &m_terms[1]);
+			m_converter.convert(object, &m_terms[2]);
+			if (graph)
+				m_converter.convert(*graph, &m_terms[3]);
+			
+			m_count++;
+			
+			if (m_callbacks->triple(m_callbacks->user_data, &m_terms[0], &m_terms[1], &m_terms[2], graph ? &m_terms[3] : nullptr))
+				throw Aborted();
+		}
+		
+	public:
+		explicit CallbackSink(const cturtle_callbacks *callbacks) : TripleSink(), m_callbacks(callbacks), m_lists(), m_converter(), m_terms(), m_count(0)
+		{
+			// nop
+		}
+		
+		void start() override {}
+		void end() override {}
+		void document(const std::string &source) override {}
+		
+		void prefix(const std::string &prefix, const std::string &ns) override
+		{
+			if (m_callbacks->prefix)
+				m_callbacks->prefix(m_callbacks->user_data, prefix.data(), prefix.length(), ns.data(), ns.length());
+		}
+		
+		void triple(const turtle::Resource &subject, const turtle::URIResource &property, const turtle::N3Node &object) override
+		{
+			m_lists.triple(subject, property, object, [this](const turtle::Resource &s, const turtle::URIResource &p, const turtle::N3Node &o) { emit(s, p, o, nullptr); });
+		}
+		
+		void quad(const turtle::Resource &subject, const turtle::URIResource &property, const turtle::N3Node &object, const turtle::Resource &graph) override
+		{
+			m_lists.triple(subject, property, object, [this, &graph](const turtle::Resource &s, const turtle::URIResource &p, const turtle::N3Node &o) { emit(s, p, o, &graph); });
+		}
+		
+		unsigned count() const override { return m_count; }
+	};
+	
+	cturtle_status fail(cturtle_error *error, cturtle_status status, int line, const char *message)
+	{
+		if (error) {
+			error->line = line;
+			std::strncpy(error->message, message, sizeof(error->message) - 1);
+			error->message[sizeof(error->message) - 1] = '\0';
+		}
+		
+		return status;
+	}
+	
+	cturtle_status parse(std::istream &in, const char *base, cturtle_syntax syntax, const cturtle_callbacks *callbacks, cturtle_error *error)
+	{
+		if (!base || !callbacks || !callbacks->triple || syntax < CTURTLE_TURTLE || syntax > CTURTLE_NQUADS)
+			return fail(error, CTURTLE_ERROR, -1, "invalid argument");
+		
+		try {
+			CallbackSink sink(callbacks);
+			turtle::Parser parser(&in, turtle::Uri(base), &sink, static_cast<turtle::Parser::Syntax>(syntax));
+			parser.parse();
+		} catch (Aborted &) {
+			return fail(error, CTURTLE_ABORTED, -1, "aborted");
+		} catch (turtle::ParseException &e) {
+			return fail(error, CTURTLE_PARSE_ERROR, e.line(), e.what());
+		} catch (std::exception &e) {
+			return fail(error, CTURTLE_ERROR, -1, e.what());
+		} catch (...) {
+			return fail(error, CTURTLE_ERROR, -1, "unknown error");
+		}
+		
+		return fail(error, CTURTLE_OK, -1, "");
+	}
+}
+
+
+extern "C" {
+	
+	const char *cturtle_version(void)
+	{
+		return CTURTLE_VERSION_STR;
+	}
+	
+	cturtle_status cturtle_parse_buffer(const char *data, size_t length, const char *base_uri, cturtle_syntax syntax, const cturtle_callbacks *callbacks, cturtle_error *error)
+	{
+		if (!data && length)
+			return fail(error, CTURTLE_ERROR, -1, "invalid argument");
+		
+		turtle::StringInputBuffer buffer(data, length);
+		std::istream in(&buffer);
+		
+		return parse(in, base_uri, syntax, callbacks, error);
+	}
+	
+	cturtle_status cturtle_parse_fd(int fd, const char *base_uri, cturtle_syntax syntax, const cturtle_callbacks *callbacks, cturtle_error *error)
+	{
+		if (fd < 0)
+			return fail(error, CTURTLE_IO_ERROR, -1, "invalid file descriptor");
+		
+		turtle::FileDescriptorInputBuffer buffer(fd);
+		std::istream in(&buffer);
+		
+		cturtle_status status = parse(in, base_uri, syntax, callbacks, error);
+		
+		// the parser saw the failed read as the end of the input
+		if (buffer.error() && status != CTURTLE_ABORTED)
+			return fail(error, CTURTLE_IO_ERROR, -1, std::strerror(buffer.error()));
+		
+		return status;
+	}
+	
+}
@@ -0,0 +1,114 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include "Checkpoint.hh"
+#include "OutputFile.hh"
+#include "Util.hh"
+
+namespace turtle {
+	
+	namespace {
+		const std::string HEADER = "cturtle-checkpoint 1";
+	}
+	
+	void Checkpoint::save(const std::string &fileName) const
+	{
+		std::string temporary = fileName + ".tmp";
+		{
+			std::ofstream out(temporary, std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
+			
+			out << HEADER << '\n';
+			if (!input.empty())
+				out << "input\t" << input << '\n';
+			out << "offset\t" << offset << '\n';
+			out << "line\t" << line << '\n';
+			out << "count\t" << count << '\n';
+			if (output)
+				out << "output\t" << *output << '\n';
+			out << "base\t" << state.base << '\n';
+			out << "blanks\t" << state.blankPrefix << '\t' << state.blankCounter << '\n';
+			for (const auto &p : state.prefixes)
+				out << "prefix\t" << p.first << '\t' << p.second << '\n';
+			
+			out.close();
+			if (!out)
+				throw IOException("error writing checkpoint " + temporary);
+		}
+		
+		// otherwise a crash after the rename can leave an empty checkpoint
+		if (!syncFile(temporary))
+			throw IOException("error writing checkpoint " + temporary);
+		
+		std::remove(fileName.c_str()); // rename does not replace files on Windows
+		if (std::rename(temporary.c_str(), fileName.c_str()) != 0)
+			throw IOException("error writing checkpoint " + fileName);
+	}
+	
+	bool Checkpoint::load(const std::string &fileName, Checkpoint &checkpoint)
+	{
+		if (!exists(fileName))
+			return false;
+		
+		std::ifstream in(fileName, std::ios_base::in | std::ios_base::binary);
+		std::string line;
+		if (!std::getline(in, line) || line != HEADER)
+			throw IOException(fileName + " is not a checkpoint");
+		
+		checkpoint = Checkpoint { 0, 1, 0, Parser::State { std::string(), std::map<std::string, std::string>(), std::string(), 0 }, std::string(), Optional<std::uint64_t>() };
+		
+		while (std::getline(in, line)) {
+			std::istringstream fields(line);
+			std::string key, a, b;
+			std::getline(fields, key, '\t');
+			std::getline(fields, a, '\t');
+			std::getline(fields, b);
+			
+			try {
+				if (key == "input")
+					checkpoint.input = a;
+				else if (key == "output")
+					checkpoint.output = static_cast<std::uint64_t>(std::stoull(a));
+				else if (key == "offset")
+					checkpoint.offset = std::stoull(a);
+				else if (key == "line")
+					checkpoint.line = std::stoull(a);
+				else if (key == "count")
+					checkpoint.count = std::stoull(a);
+				else if (key == "base")
+					checkpoint.state.base = a;
+				else if (key == "blanks") {
+					checkpoint.state.blankPrefix = a;
+					checkpoint.state.blankCounter = static_cast<unsigned>(std::stoul(b));
+				} else if (key == "prefix")
+					checkpoint.state.prefixes[a] = b;
+				else
+					throw IOException("unknown entry \"" + key + "\" in checkpoint " + fileName);
+			} catch (std::logic_error &e) { // std::stoull
+				throw IOException("invalid entry \"" + key + "\" in checkpoint " + fileName);
+			}
+		}
+		
+		if (checkpoint.state.base.empty() || checkpoint.state.blankPrefix.empty())
+			throw IOException("incomplete checkpoint " + fileName);
+		
+		return true;
+	}
+	
+}
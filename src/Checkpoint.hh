@@ -0,0 +1,50 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef N3_CHECKPOINT_HH
+#define N3_CHECKPOINT_HH
+
+#include <cstdint>
+#include <string>
+
+#include "Parser.hh"
+#include "Optional.hh"
+
+namespace turtle {
+	
+	///
+	/// Where to continue parsing an input: the byte offset of a statement
+	/// boundary, with the line and triple count at that point and the
+	/// parser state. Stored as a small text file.
+	///
+	struct Checkpoint {
+		std::uint64_t offset;
+		std::uint64_t line;   // line number at offset, the first line is 1
+		std::uint64_t count;  // triples before offset
+		Parser::State state;
+		std::string input;    // the file offset refers to, when there are several
+		Optional<std::uint64_t> output; // size of the output file at offset, if it is known
+		
+		/// Replaces fileName atomically, once the new contents are on disk. Throws IOException.
+		void save(const std::string &fileName) const;
+		
+		/// false when fileName does not exist. Throws IOException when it can not be read.
+		static bool load(const std::string &fileName, Checkpoint &checkpoint);
+	};
+
+}
+
+#endif /* N3_CHECKPOINT_HH */
@@ -16,50 +16,154 @@
 
 #include "CommandLine.hh"
 
+#include <algorithm>
+
 namespace turtle {
 	
 	const std::string CommandLine::N3P      = "n3p";
 	const std::string CommandLine::N3P_RDIV = "n3p-rdiv";
+	const std::string CommandLine::N3P_DICT = "n3p-dict";
+	const std::string CommandLine::N3P_CLUSTERED = "n3p-clustered";
 	const std::string CommandLine::NTRIPLES = "nt";
+	const std::string CommandLine::TURTLE   = "ttl";
+	const std::string CommandLine::TRIG     = "trig";
+	const std::string CommandLine::NQUADS   = "nq";
+	const std::string CommandLine::NQUADS_DOC = "nq-doc";
+	const std::string CommandLine::HDT      = "hdt";
+	const std::string CommandLine::BINARY   = "binary";
+	
+	const std::string CommandLine::SUBJECT   = "subject";
+	const std::string CommandLine::PREDICATE = "predicate";
+	
+	/// Accepts "-x=value", "-xvalue" and "-x value" when argv[i] starts with option "-x".
+	bool CommandLine::value(const std::string &option, int &i, int argc, char *argv[], std::string &value)
+	{
+		std::string arg = argv[i];
+		
+		if (arg[option.length()] == '=')
+			value = arg.substr(option.length() + 1);
+		else {
+			value = arg.substr(option.length());
+			
+			if (value.empty() && i + 1 < argc)
+				value = std::string(argv[++i]);
+		}
+		
+		return !value.empty();
+	}
+	
+	bool CommandLine::value(const std::string &option, int &i, int argc, char *argv[], unsigned &value)
+	{
+		std::string s;
+		if (!CommandLine::value(option, i, argc, argv, s) || s.find_first_not_of("0123456789") != std::string::npos || s.length() > 9)
+			return false;
+		
+		value = std::stoul(s);
+		
+		return true;
+	}
 
+	/// A number of bytes, optionally followed by K, M or G.
+	bool CommandLine::size(const std::string &option, int &i, int argc, char *argv[], std::size_t &value)
+	{
+		std::string s;
+		if (!CommandLine::value(option, i, argc, argv, s))
+			return false;
+		
+		std::size_t digits = s.find_first_not_of("0123456789");
+		if (digits == 0 || std::min(digits, s.length()) > 12)
+			return false;
+		
+		value = std::stoull(s.substr(0, digits));
+		
+		if (digits != std::string::npos) {
+			std::string unit = s.substr(digits);
+			if (unit == "K" || unit == "k")
+				value <<= 10;
+			else if (unit == "M" || unit == "m")
+				value <<= 20;
+			else if (unit == "G" || unit == "g")
+				value <<= 30;
+			else
+				return false;
+		}
+		
+		return value > 0;
+	}
+	
+	bool CommandLine::outputFormat(const std::string &format)
+	{
+		return format == NTRIPLES || format == NQUADS || format == NQUADS_DOC || format == TURTLE || format == N3P || format == N3P_RDIV || format == N3P_DICT || format == N3P_CLUSTERED || format == HDT || format == BINARY;
+	}
+	
 	CommandLine CommandLine::parse(int argc, char *argv[])
 	{
-		CommandLine opt;
+		CommandLine opt = CommandLine();
 		
 		bool error = false, stop = false;
 		for (int i = 1; i < argc && !error; i++) {
 			std::string arg = argv[i];
 			if (!stop) {
 				if (arg.find("-o") == 0) {
-					if (arg[2] == '=')
-						opt.output = arg.substr(3);
-					else {
-						opt.output = arg.substr(2);
-						
-						if (opt.output->empty() && i + 1 < argc)
-							opt.output = std::string(argv[++i]);
-					}
-					error = opt.output->empty(); 
+					std::string output;
+					error = !value("-o", i, argc, argv, output);
+					opt.output = output;
+				} else if (arg.find("-O") == 0) {
+					std::string directory;
+					error = !value("-O", i, argc, argv, directory);
+					opt.outputDirectory = directory;
+				} else if (arg.find("-@") == 0) {
+					std::string manifest;
+					error = !value("-@", i, argc, argv, manifest);
+					opt.manifests.push_back(manifest);
 				} else if (arg.find("-b") == 0) {
-					if (arg[2] == '=')
-						opt.base = arg.substr(3);
-					else {
-						opt.base = arg.substr(2);
-						
-						if (opt.base->empty() && i + 1 < argc)
-							opt.base = std::string(argv[++i]);
-					}
-					error = opt.base->empty(); 
+					std::string base;
+					error = !value("-b", i, argc, argv, base);
+					opt.base = base;
 				} else if (arg.find("-f") == 0) {
-					if (arg[2] == '=')
-						opt.format = arg.substr(3);
-					else {
-						opt.format = arg.substr(2);
-						
-						if (opt.format.empty() && i + 1 < argc)
-							opt.format = std::string(argv[++i]);
-					}
-					error = opt.format.empty() || (opt.format != NTRIPLES && opt.format != N3P && opt.format != N3P_RDIV);
+					error = !value("-f", i, argc, argv, opt.format) || !outputFormat(opt.format);
+				} else if (arg.find("-i") == 0) {
+					error = !value("-i", i, argc, argv, opt.inputFormat) || (opt.inputFormat != TURTLE && opt.inputFormat != TRIG && opt.inputFormat != NQUADS);
+				} else if (arg.find("-j") == 0) {
+					error = !value("-j", i, argc, argv, opt.jobs) || opt.jobs == 0;
+				} else if (arg.find("-shards") == 0) {
+					error = !value("-shards", i, argc, argv, opt.shards) || opt.shards == 0;
+				} else if (arg.find("-shard-key") == 0) {
+					error = !value("-shard-key", i, argc, argv, opt.shardKey) || (opt.shardKey != SUBJECT && opt.shardKey != PREDICATE);
+				} else if (arg == "--sort") {
+					opt.sort = true;
+				} else if (arg == "--unique") {
+					opt.sort = opt.unique = true;
+				} else if (arg == "--dedup") {
+					opt.dedup = true;
+				} else if (arg.find("--max-memory") == 0) {
+					error = !size("--max-memory", i, argc, argv, opt.maxMemory);
+				} else if (arg == "--follow") {
+					opt.follow = true;
+				} else if (arg.find("--checkpoint") == 0) {
+					std::string checkpoint;
+					error = !value("--checkpoint", i, argc, argv, checkpoint);
+					opt.checkpoint = checkpoint;
+				} else if (arg == "--resume") {
+					opt.resume = true;
+				} else if (arg == "--strict-iri") {
+					opt.strictIri = true;
+				} else if (arg == "--strict-literals") {
+					opt.strictLiterals = true;
+				} else if (arg == "--canonical") {
+					opt.canonical = true;
+				} else if (arg.find("--recover") == 0) {
+					std::string errors;
+					error = !value("--recover", i, argc, argv, errors);
+					opt.recover = errors;
+				} else if (arg.find("--serve") == 0) {
+					std::string path;
+					error = !value("--serve", i, argc, argv, path);
+					opt.serve = path;
+				} else if (arg.find("--connect") == 0) {
+					std::string path;
+					error = !value("--connect", i, argc, argv, path);
+					opt.connect = path;
 				} else if (arg == "-h") {
 					opt.help = true;
 				} else if (arg == "--") {
@@ -76,8 +180,14 @@ namespace turtle {
 		
 		if (opt.format.empty())
 			opt.format = NTRIPLES;
+		
+		if (opt.shards == 0)
+			opt.shards = 1;
+		
+		if (opt.shardKey.empty())
+			opt.shardKey = SUBJECT;
 			
-		if (opt.inputs.empty())
+		if (opt.inputs.empty() && opt.manifests.empty())
 			opt.inputs.push_back("-");
 		
 		opt.error = error;
@@ -17,6 +17,7 @@
 #ifndef N3_COMMAND_LINE_HH
 #define N3_COMMAND_LINE_HH
 
+#include <cstddef>
 #include <vector>
 #include <string>
 
@@ -28,16 +29,54 @@ namespace turtle {
 		
 		static const std::string N3P;
 		static const std::string N3P_RDIV;
+		static const std::string N3P_DICT;
+		static const std::string N3P_CLUSTERED;
 		static const std::string NTRIPLES;
+		static const std::string TURTLE;
+		static const std::string TRIG;
+		static const std::string NQUADS;
+		static const std::string NQUADS_DOC;
+		static const std::string HDT;
+		static const std::string BINARY;
+		
+		static const std::string SUBJECT;
+		static const std::string PREDICATE;
 		
 		bool error;
 		bool help;
 		std::vector<std::string> inputs;
 		Optional<std::string> output;
+		Optional<std::string> outputDirectory;
+		std::vector<std::string> manifests;
+		bool follow;
+		Optional<std::string> checkpoint;
+		bool resume;
+		Optional<std::string> recover;
+		bool strictIri;
+		bool strictLiterals;
+		bool canonical;
+		Optional<std::string> serve;
+		Optional<std::string> connect;
 		Optional<std::string> base;
 		std::string format;
+		std::string inputFormat;
+		unsigned jobs;
+		unsigned shards;
+		std::string shardKey;
+		bool sort;
+		bool unique;
+		bool dedup;
+		std::size_t maxMemory;
 		
 		static CommandLine parse(int argc, char *argv[]);
+		
+		/// true if format is one of the output formats
+		static bool outputFormat(const std::string &format);
+		
+	private:
+		static bool value(const std::string &option, int &i, int argc, char *argv[], std::string &value);
+		static bool value(const std::string &option, int &i, int argc, char *argv[], unsigned &value);
+		static bool size(const std::string &option, int &i, int argc, char *argv[], std::size_t &value);
 	};
 
 }
@@ -0,0 +1,260 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#include "Compression.hh"
+
+#include <algorithm>
+#include <thread>
+#include <memory>
+
+#include <zlib.h>
+
+#ifdef CTURTLE_ZSTD
+#	include <zstd.h>
+#endif
+
+namespace turtle {
+	
+	CompressingStreamBuf::CompressingStreamBuf(std::streambuf *target, Codec codec, unsigned threads, std::size_t blockSize) :
+		std::streambuf(), m_target(target), m_codec(codec), m_threads(), m_block(blockSize), m_pending(), m_queue(), m_error(), m_closed(false), m_stop(false), m_mutex(), m_work(), m_done(), m_workers()
+	{
+		if (!supported(codec))
+			throw CompressionException("cturtle was built without zstd support");
+		
+		unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+		m_threads = threads ? std::min(threads, cores) : cores;
+		
+		setp(m_block.data(), m_block.data() + m_block.size());
+	}
+	
+	CompressingStreamBuf::~CompressingStreamBuf()
+	{
+		try {
+			close();
+		} catch (...) {
+			// nop, destructors must not throw
+		}
+		
+		stop();
+	}
+	
+	bool CompressingStreamBuf::codec(const std::string &fileName, Codec *codec)
+	{
+		auto endsWith = [&fileName](const std::string &suffix) {
+			return fileName.length() > suffix.length() && fileName.compare(fileName.length() - suffix.length(), suffix.length(), suffix) == 0;
+		};
+		
+		if (endsWith(".gz")) {
+			*codec = GZIP;
+			return true;
+		}
+		
+		if (endsWith(".zst")) {
+			*codec = ZSTD;
+			return true;
+		}
+		
+		return false;
+	}
+	
+	bool CompressingStreamBuf::supported(Codec codec)
+	{
+#ifdef CTURTLE_ZSTD
+		return true;
+#else
+		return codec != ZSTD;
+#endif
+	}
+	
+	CompressingStreamBuf::int_type CompressingStreamBuf::overflow(int_type c)
+	{
+		if (m_closed)
+			return traits_type::eof();
+		
+		submit();
+		
+		if (m_error)
+			return traits_type::eof();
+		
+		if (!traits_type::eq_int_type(c, traits_type::eof())) {
+			*pptr() = traits_type::to_char_type(c);
+			pbump(1);
+		}
+		
+		return traits_type::not_eof(c);
+	}
+	
+	int CompressingStreamBuf::sync()
+	{
+		if (m_closed)
+			return m_error ? -1 : 0;
+		
+		submit();
+		drain(0);
+		
+		if (m_error)
+			std::rethrow_exception(m_error);
+		
+		return m_target->pubsync();
+	}
+	
+	void CompressingStreamBuf::close()
+	{
+		if (!m_closed) {
+			submit();
+			drain(0);
+			stop();
+			m_closed = true;
+			setp(nullptr, nullptr);
+			
+			if (!m_error && m_target->pubsync() != 0)
+				m_error = std::make_exception_ptr(CompressionException("error writing compressed output"));
+		}
+		
+		if (m_error)
+			std::rethrow_exception(m_error);
+	}
+	
+	void CompressingStreamBuf::submit()
+	{
+		std::size_t length = pptr() - pbase();
+		if (!length)
+			return;
+		
+		// keep at most two blocks per thread in flight, this bounds memory use
+		drain(2 * m_threads - 1);
+		
+		std::shared_ptr<Block> block = std::make_shared<Block>(Block { std::vector<char>(m_block.begin(), m_block.begin() + length), std::string(), std::exception_ptr(), false });
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_queue.push_back(block);
+		}
+		m_pending.push_back(block);
+		m_work.notify_one();
+		
+		if (m_workers.size() < m_threads && m_workers.size() < m_pending.size())
+			m_workers.emplace_back(&CompressingStreamBuf::work, this);
+		
+		setp(m_block.data(), m_block.data() + m_block.size());
+	}
+	
+	void CompressingStreamBuf::drain(std::size_t keep)
+	{
+		while (m_pending.size() > keep) {
+			std::shared_ptr<Block> block = m_pending.front();
+			m_pending.pop_front();
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_done.wait(lock, [&block]() { return block->done; });
+			}
+			
+			if (m_error)
+				continue; // the output is broken already, blocks after it are dropped
+			
+			if (block->error)
+				m_error = block->error;
+			else if (m_target->sputn(block->compressed.data(), block->compressed.length()) != static_cast<std::streamsize>(block->compressed.length()))
+				m_error = std::make_exception_ptr(CompressionException("error writing compressed output"));
+		}
+	}
+	
+	void CompressingStreamBuf::work()
+	{
+		for (;;) {
+			std::shared_ptr<Block> block;
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_work.wait(lock, [this]() { return m_stop || !m_queue.empty(); });
+				if (m_queue.empty())
+					return;
+				block = m_queue.front();
+				m_queue.pop_front();
+			}
+			
+			std::string compressed;
+			std::exception_ptr error;
+			try {
+				compressed = compress(m_codec, block->data.data(), block->data.size());
+			} catch (...) {
+				error = std::current_exception();
+			}
+			
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				block->compressed.swap(compressed);
+				block->error = error;
+				block->done = true;
+				std::vector<char>().swap(block->data);
+			}
+			m_done.notify_all();
+		}
+	}
+	
+	void CompressingStreamBuf::stop()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stop = true;
+		}
+		m_work.notify_all();
+		
+		for (std::thread &t : m_workers)
+			t.join();
+		m_workers.clear();
+	}
+	
+	std::string CompressingStreamBuf::compress(Codec codec, const char *data, std::size_t length)
+	{
+		std::string result;
+		
+#ifdef CTURTLE_ZSTD
+		if (codec == ZSTD) {
+			result.resize(ZSTD_compressBound(length));
+			std::size_t n = ZSTD_compress(&result[0], result.size(), data, length, 3);
+			if (ZSTD_isError(n))
+				throw CompressionException(ZSTD_getErrorName(n));
+			result.resize(n);
+			
+			return result;
+		}
+#endif
+		
+		z_stream zs = z_stream();
+		
+		// windowBits 15 + 16 writes a gzip header and trailer
+		if (deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+			throw CompressionException("could not initialize zlib");
+		
+		result.resize(deflateBound(&zs, length));
+		
+		zs.next_in   = reinterpret_cast<Bytef *>(const_cast<char *>(data));
+		zs.avail_in  = length;
+		zs.next_out  = reinterpret_cast<Bytef *>(&result[0]);
+		zs.avail_out = result.size();
+		
+		int r = deflate(&zs, Z_FINISH);
+		deflateEnd(&zs);
+		
+		if (r != Z_STREAM_END)
+			throw CompressionException("gzip compression failed");
+		
+		result.resize(zs.total_out);
+		
+		return result;
+	}
+	
+}
@@ -0,0 +1,109 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#ifndef N3_COMPRESSION_HH
+#define N3_COMPRESSION_HH
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <streambuf>
+#include <stdexcept>
+
+namespace turtle {
+	
+	class CompressionException : public std::runtime_error {
+	public:
+		explicit CompressionException(const std::string &message = std::string()) : std::runtime_error(message) {}
+	};
+	
+	///
+	/// Output stream buffer that cuts its output in blocks of blockSize bytes and
+	/// compresses them in parallel, like pigz. Every block becomes an independent
+	/// gzip member or zstd frame, concatenations of those are valid files.
+	/// Blocks are compressed on a pool of threads that is started as blocks
+	/// come in, and written to the target in order. The first error is kept
+	/// and thrown by sync() and close().
+	///
+	class CompressingStreamBuf : public std::streambuf {
+	public:
+		enum Codec { GZIP, ZSTD };
+		
+		static const std::size_t BLOCK_SIZE = 1024 * 1024;
+		
+		/// threads is capped at the number of cores, 0 uses all of them.
+		CompressingStreamBuf(std::streambuf *target, Codec codec, unsigned threads = 0, std::size_t blockSize = BLOCK_SIZE);
+		
+		CompressingStreamBuf(const CompressingStreamBuf &) = delete;
+		CompressingStreamBuf &operator=(const CompressingStreamBuf &) = delete;
+		
+		/// Closes, errors are lost. Call close() to see them.
+		~CompressingStreamBuf();
+		
+		/// Writes the remaining blocks and stops the threads. Rethrows the first
+		/// error compressing or writing a block, also when called again.
+		void close();
+		
+		/// Determines the codec from the extension of fileName (.gz or .zst), returns false if there is none.
+		static bool codec(const std::string &fileName, Codec *codec);
+		
+		/// false if cturtle was built without support for codec
+		static bool supported(Codec codec);
+		
+		static std::string compress(Codec codec, const char *data, std::size_t length);
+		
+	protected:
+		int_type overflow(int_type c) override;
+		int sync() override;
+		
+	private:
+		struct Block {
+			std::vector<char> data;
+			std::string compressed;
+			std::exception_ptr error;
+			bool done;
+		};
+		
+		std::streambuf *m_target;
+		Codec m_codec;
+		std::size_t m_threads;
+		std::vector<char> m_block;
+		std::deque<std::shared_ptr<Block>> m_pending; // in output order
+		std::deque<std::shared_ptr<Block>> m_queue;   // not picked up by a thread yet
+		std::exception_ptr m_error;
+		bool m_closed;
+		bool m_stop;
+		std::mutex m_mutex;
+		std::condition_variable m_work;
+		std::condition_variable m_done;
+		std::vector<std::thread> m_workers;
+		
+		void submit();
+		void drain(std::size_t keep);
+		void work();
+		void stop();
+	};
+
+}
+
+#endif /* N3_COMPRESSION_HH */
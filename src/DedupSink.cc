@@ -0,0 +1,54 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "DedupSink.hh"
+
+namespace turtle {
+	
+	bool DedupSink::insert(const Hash128 &h)
+	{
+		if (m_bloom)
+			return m_bloom->insert(h);
+		
+		if (m_maxMemory && m_set.full() && 2 * m_set.memory() > m_maxMemory) {
+			m_bloom = std::unique_ptr<BloomFilter>(new BloomFilter(m_maxMemory));
+			m_set.each([this](const Hash128 &s) { m_bloom->insert(s); });
+			m_set = FingerprintSet();
+			
+			return m_bloom->insert(h);
+		}
+		
+		return m_set.insert(h);
+	}
+	
+	bool DedupSink::unique(const Resource &subject, const URIResource &property, const N3Node &object, const Resource *graph)
+	{
+		m_record.clear();
+		subject.visit(m_encoder);
+		m_encoder.iri(property.uri());
+		object.visit(m_encoder);
+		if (graph)
+			graph->visit(m_encoder);
+		
+		if (insert(hash::murmur3(m_record.data(), m_record.size())))
+			return true;
+		
+		m_duplicates++;
+		
+		return false;
+	}
+	
+}
@@ -0,0 +1,207 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#ifndef N3_DEDUPSINK_HH
+#define N3_DEDUPSINK_HH
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <memory>
+
+#include "Parser.hh"
+#include "Model.hh"
+#include "Binary.hh"
+#include "BinaryWriter.hh"
+#include "Hash.hh"
+
+namespace turtle {
+	
+	///
+	/// Open addressing hash set of 128-bit fingerprints, with linear probing.
+	/// The all zero fingerprint marks an empty slot.
+	///
+	class FingerprintSet {
+		
+		std::vector<Hash128> m_slots;
+		std::size_t m_size;
+		
+		static bool empty(const Hash128 &h) { return h.low == 0 && h.high == 0; }
+		
+		static bool add(std::vector<Hash128> &slots, const Hash128 &h)
+		{
+			std::size_t mask = slots.size() - 1;
+			for (std::size_t i = h.low & mask;; i = (i + 1) & mask) {
+				if (empty(slots[i])) {
+					slots[i] = h;
+					return true;
+				}
+				if (slots[i] == h)
+					return false;
+			}
+		}
+		
+	public:
+		FingerprintSet() : m_slots(1024), m_size(0) {}
+		
+		/// true if the next insert may grow the table
+		bool full() const { return 4 * (m_size + 1) > 3 * m_slots.size(); }
+		
+		std::size_t size() const { return m_size; }
+		
+		std::size_t memory() const { return m_slots.size() * sizeof(Hash128); }
+		
+		/// Returns false if h was already present.
+		bool insert(Hash128 h)
+		{
+			if (empty(h))
+				h.high = 1;
+			
+			if (full()) {
+				std::vector<Hash128> slots(2 * m_slots.size());
+				for (const Hash128 &s : m_slots) {
+					if (!empty(s))
+						add(slots, s);
+				}
+				m_slots.swap(slots);
+			}
+			
+			bool added = add(m_slots, h);
+			if (added)
+				m_size++;
+			
+			return added;
+		}
+		
+		template<typename Function>
+		void each(Function f) const
+		{
+			for (const Hash128 &s : m_slots) {
+				if (!empty(s))
+					f(s);
+			}
+		}
+	};
+	
+	
+	///
+	/// Blocked Bloom filter: the bits of a fingerprint all fall in the same
+	/// 512-bit block, so that a lookup touches a single cache line.
+	///
+	class BloomFilter {
+		
+		static const unsigned BLOCK_WORDS = 8;
+		static const unsigned HASHES = 7;
+		
+		std::vector<std::uint64_t> m_words;
+		std::size_t m_blocks;
+		
+	public:
+		/// Uses at most bytes of memory, at least one block.
+		explicit BloomFilter(std::size_t bytes) : m_words(), m_blocks(1)
+		{
+			while (2 * m_blocks * BLOCK_WORDS * sizeof(std::uint64_t) <= bytes)
+				m_blocks *= 2;
+			
+			m_words.assign(m_blocks * BLOCK_WORDS, 0);
+		}
+		
+		std::size_t memory() const { return m_words.size() * sizeof(std::uint64_t); }
+		
+		/// Returns false if h was (probably) already present.
+		bool insert(const Hash128 &h)
+		{
+			std::uint64_t *block = &m_words[(h.low & (m_blocks - 1)) * BLOCK_WORDS];
+			std::uint64_t bits = h.high;
+			bool added = false;
+			
+			for (unsigned i = 0; i < HASHES; i++, bits >>= 9) {
+				unsigned bit = bits & 511;
+				std::uint64_t mask = std::uint64_t(1) << (bit & 63);
+				std::uint64_t &word = block[bit >> 6];
+				
+				if (!(word & mask)) {
+					word |= mask;
+					added = true;
+				}
+			}
+			
+			return added;
+		}
+	};
+	
+	
+	///
+	/// Drops duplicate triples in a single pass, by remembering a 128-bit
+	/// fingerprint of every triple. The fingerprint is the MurmurHash3 of the
+	/// self-contained binary encoding of the triple. When the fingerprints no
+	/// longer fit in maxMemory, they are moved to a Bloom filter of that size;
+	/// from then on a new triple is occasionally mistaken for a duplicate.
+	///
+	class DedupSink : public TripleSink {
+		
+		std::unique_ptr<TripleSink> m_sink;
+		std::size_t m_maxMemory;
+		std::string m_record;
+		StringOutputBuffer m_buffer;
+		BinaryTermEncoder m_encoder;
+		FingerprintSet m_set;
+		std::unique_ptr<BloomFilter> m_bloom;
+		std::size_t m_duplicates;
+		
+		bool insert(const Hash128 &h);
+		bool unique(const Resource &subject, const URIResource &property, const N3Node &object, const Resource *graph);
+		
+	public:
+		/// maxMemory 0 keeps all fingerprints, which is exact up to hash collisions.
+		DedupSink(std::unique_ptr<TripleSink> &&sink, std::size_t maxMemory = 0) :
+			TripleSink(), m_sink(std::move(sink)), m_maxMemory(maxMemory), m_record(), m_buffer(m_record), m_encoder(&m_buffer, 0),
+			m_set(), m_bloom(), m_duplicates(0)
+		{
+			// nop
+		}
+		
+		void start() override { m_sink->start(); }
+		void end() override { m_sink->end(); }
+		
+		void document(const std::string &source) override { m_sink->document(source); }
+		void prefix(const std::string &prefix, const std::string &ns) override { m_sink->prefix(prefix, ns); }
+		
+		void triple(const Resource &subject, const URIResource &property, const N3Node &object) override
+		{
+			if (unique(subject, property, object, nullptr))
+				m_sink->triple(subject, property, object);
+		}
+		
+		void quad(const Resource &subject, const URIResource &property, const N3Node &object, const Resource &graph) override
+		{
+			if (unique(subject, property, object, &graph))
+				m_sink->quad(subject, property, object, graph);
+		}
+		
+		unsigned count() const override { return m_sink->count(); }
+		
+		std::size_t duplicates() const { return m_duplicates; }
+		
+		/// true when the Bloom filter is in use, so duplicates() may include false positives
+		bool approximate() const { return static_cast<bool>(m_bloom); }
+	};
+
+}
+
+#endif /* N3_DEDUPSINK_HH */
@@ -0,0 +1,70 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef N3_DOCUMENTGRAPHSINK_HH
+#define N3_DOCUMENTGRAPHSINK_HH
+
+#include <memory>
+#include <string>
+
+#include "Parser.hh"
+#include "Model.hh"
+
+namespace turtle {
+	
+	///
+	/// Puts every triple in a graph named after the document it came from,
+	/// i.e. the uri of the last document() event. Graph names of the input
+	/// are replaced, so the output records provenance only.
+	///
+	class DocumentGraphSink : public TripleSink {
+		
+		std::unique_ptr<TripleSink> m_sink;
+		URIResource m_document;
+		
+	public:
+		explicit DocumentGraphSink(std::unique_ptr<TripleSink> &&sink) : TripleSink(), m_sink(std::move(sink)), m_document(std::string())
+		{
+			// nop
+		}
+		
+		void start() override { m_sink->start(); }
+		void end() override { m_sink->end(); }
+		
+		void document(const std::string &source) override
+		{
+			m_document = URIResource(source);
+			m_sink->document(source);
+		}
+		
+		void prefix(const std::string &prefix, const std::string &ns) override { m_sink->prefix(prefix, ns); }
+		
+		void triple(const Resource &subject, const URIResource &property, const N3Node &object) override
+		{
+			m_sink->quad(subject, property, object, m_document);
+		}
+		
+		void quad(const Resource &subject, const URIResource &property, const N3Node &object, const Resource &graph) override
+		{
+			m_sink->quad(subject, property, object, m_document);
+		}
+		
+		unsigned count() const override { return m_sink->count(); }
+	};
+
+}
+
+#endif /* N3_DOCUMENTGRAPHSINK_HH */
@@ -0,0 +1,67 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef N3_ERRORLOG_HH
+#define N3_ERRORLOG_HH
+
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+
+#include "Parser.hh"
+
+namespace turtle {
+	
+	///
+	/// Writes the errors of the statements skipped with --recover as lines
+	/// input<TAB>line<TAB>message. Inputs may be parsed concurrently.
+	///
+	class ErrorLog {
+		
+		std::mutex m_mutex;
+		std::ostream &m_out;
+		std::uint64_t m_count;
+		
+	public:
+		explicit ErrorLog(std::ostream &out) : m_mutex(), m_out(out), m_count(0)
+		{
+			// nop
+		}
+		
+		ErrorLog(const ErrorLog &) = delete;
+		ErrorLog &operator=(const ErrorLog &) = delete;
+		
+		void add(const std::string &input, const ParseException &e)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			
+			m_out << input << '\t' << e.line() << '\t' << e.what() << '\n';
+			++m_count;
+		}
+		
+		/// The number of skipped statements.
+		std::uint64_t count()
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			
+			return m_count;
+		}
+	};
+
+}
+
+#endif /* N3_ERRORLOG_HH */
@@ -0,0 +1,68 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef N3_FILEDESCRIPTORBUFFER_HH
+#define N3_FILEDESCRIPTORBUFFER_HH
+
+#include <cerrno>
+#include <cstddef>
+#include <streambuf>
+#include <vector>
+
+#ifdef _WIN32
+#	include <io.h>
+#else
+#	include <unistd.h>
+#endif
+
+namespace turtle {
+	
+	///
+	/// Input buffer reading from a file descriptor (file, pipe or socket), which is not closed.
+	/// A failing read ends the input like end of file, error() tells them apart.
+	///
+	class FileDescriptorInputBuffer : public std::streambuf {
+		int m_fd;
+		int m_error;
+		std::vector<char> m_buffer;
+	protected:
+		int_type underflow() override
+		{
+			int n;
+			do {
+				n = static_cast<int>(::read(m_fd, m_buffer.data(), static_cast<unsigned>(m_buffer.size())));
+			} while (n < 0 && errno == EINTR);
+			
+			if (n < 0)
+				m_error = errno;
+			
+			if (n <= 0)
+				return traits_type::eof();
+			
+			setg(m_buffer.data(), m_buffer.data(), m_buffer.data() + n);
+			
+			return traits_type::to_int_type(*gptr());
+		}
+	public:
+		explicit FileDescriptorInputBuffer(int fd, std::size_t size = 64 * 1024) : std::streambuf(), m_fd(fd), m_error(0), m_buffer(size) {}
+		
+		/// errno of the read that failed, 0 if the input ended normally
+		int error() const { return m_error; }
+	};
+
+}
+
+#endif /* N3_FILEDESCRIPTORBUFFER_HH */
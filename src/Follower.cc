@@ -0,0 +1,95 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <algorithm>
+#include <fstream>
+#include <istream>
+
+#include "Follower.hh"
+#include "StatementSplitter.hh"
+#include "Binary.hh"
+#include "OutputFile.hh"
+#include "Util.hh"
+
+namespace turtle {
+	
+	const std::size_t Follower::MAX_READ;
+	
+	Follower::Follower(const std::string &fileName, const Uri &base, TripleSink *sink, Parser::Syntax syntax) :
+		m_fileName(fileName), m_empty(), m_sink(sink), m_parser(&m_empty, base, sink, syntax), m_offset(0), m_line(1), m_startLine(1), m_count(0), m_buffer()
+	{
+		m_parser.parse(); // announces the document
+	}
+	
+	void Follower::restore(const Checkpoint &checkpoint)
+	{
+		m_parser.restore(checkpoint.state);
+		m_offset = checkpoint.offset;
+		m_line = m_startLine = checkpoint.line;
+		m_count = checkpoint.count - m_sink->count();
+	}
+	
+	Checkpoint Follower::checkpoint() const
+	{
+		return Checkpoint { m_offset, m_line, m_count + m_sink->count(), m_parser.state(), m_fileName, Optional<std::uint64_t>() };
+	}
+	
+	std::size_t Follower::poll(bool final)
+	{
+		std::uint64_t size = fileSize(m_fileName);
+		if (size < m_offset || !exists(m_fileName))
+			throw IOException(m_fileName + " was truncated or removed");
+		
+		if (size == m_offset)
+			return 0;
+		
+		std::ifstream in(m_fileName, std::ios_base::in | std::ios_base::binary);
+		in.seekg(static_cast<std::streamoff>(m_offset));
+		
+		std::size_t length = 0, boundary = 0;
+		while (boundary == 0 && m_offset + length < size) {
+			// a statement longer than MAX_READ is read as a whole
+			std::size_t more = static_cast<std::size_t>(std::min<std::uint64_t>(size - m_offset - length, std::max(length, MAX_READ)));
+			m_buffer.resize(length + more);
+			in.read(&m_buffer[length], static_cast<std::streamsize>(more));
+			if (static_cast<std::size_t>(in.gcount()) != more)
+				throw IOException("error reading " + m_fileName);
+			length += more;
+			
+			bool end = final && m_offset + length == size;
+			boundary = end ? length : StatementSplitter::last(m_buffer.data(), length);
+		}
+		
+		if (boundary == 0)
+			return 0;
+		
+		StringInputBuffer buffer(m_buffer.data(), boundary);
+		std::istream statements(&buffer);
+		
+		try {
+			m_parser.resume(&statements);
+		} catch (ParseException &e) {
+			// the lexer counts from where this follower started
+			throw ParseException(e.what(), e.line() == -1 ? -1 : static_cast<int>(m_startLine) + e.line() - 1);
+		}
+		
+		m_line += std::count(m_buffer.data(), m_buffer.data() + boundary, '\n');
+		m_offset += boundary;
+		
+		return boundary;
+	}
+	
+}
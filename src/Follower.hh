@@ -0,0 +1,74 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef N3_FOLLOWER_HH
+#define N3_FOLLOWER_HH
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <sstream>
+
+#include "Parser.hh"
+#include "Uri.hh"
+#include "Checkpoint.hh"
+
+namespace turtle {
+	
+	///
+	/// Translates a file that is being appended to, like a log. Every poll()
+	/// parses the complete statements added since the last one with the same
+	/// Parser, so prefixes, base and blank node labels carry over. A partial
+	/// statement at the end stays in the file until it is completed.
+	///
+	class Follower {
+		
+		std::string m_fileName;
+		std::istringstream m_empty;
+		TripleSink *m_sink;
+		Parser m_parser;
+		std::uint64_t m_offset;     // of the first byte not parsed yet
+		std::uint64_t m_line;       // at m_offset
+		std::uint64_t m_startLine;  // at the offset where this follower started
+		std::uint64_t m_count;      // triples before the offset where this follower started
+		std::string m_buffer;
+		
+	public:
+		static const std::size_t MAX_READ = 8 * 1024 * 1024;
+		
+		Follower(const std::string &fileName, const Uri &base, TripleSink *sink, Parser::Syntax syntax = Parser::TURTLE);
+		
+		/// Continues where checkpoint was taken.
+		void restore(const Checkpoint &checkpoint);
+		
+		Checkpoint checkpoint() const;
+		
+		/// For setting the validation options of the parser.
+		Parser &parser() { return m_parser; }
+		
+		/// Parses the complete statements appended since the last call, at most
+		/// MAX_READ bytes at a time. When final, the rest of the file is parsed
+		/// as well, because no more input will follow. Returns the number of bytes
+		/// parsed. Throws ParseException with the line number in the file, and
+		/// IOException when the file is gone or was truncated.
+		std::size_t poll(bool final = false);
+		
+		std::uint64_t offset() const { return m_offset; }
+	};
+
+}
+
+#endif /* N3_FOLLOWER_HH */
@@ -0,0 +1,130 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#ifndef N3_HASH_HH
+#define N3_HASH_HH
+
+#include <cstddef>
+#include <cstdint>
+
+namespace turtle {
+	
+	struct Hash128 {
+		std::uint64_t low;
+		std::uint64_t high;
+		
+		bool operator==(const Hash128 &other) const { return low == other.low && high == other.high; }
+		bool operator!=(const Hash128 &other) const { return !(*this == other); }
+	};
+	
+	namespace hash {
+		
+		inline std::uint64_t rotl(std::uint64_t x, int r)
+		{
+			return (x << r) | (x >> (64 - r));
+		}
+		
+		inline std::uint64_t fmix(std::uint64_t k)
+		{
+			k ^= k >> 33;
+			k *= 0xff51afd7ed558ccdULL;
+			k ^= k >> 33;
+			k *= 0xc4ceb9fe1a85ec53ULL;
+			k ^= k >> 33;
+			
+			return k;
+		}
+		
+		inline std::uint64_t load(const unsigned char *p)
+		{
+			std::uint64_t v = 0;
+			for (int i = 7; i >= 0; i--)
+				v = (v << 8) | p[i];
+			
+			return v;
+		}
+		
+		///
+		/// MurmurHash3_x64_128 by Austin Appleby (public domain), reading the
+		/// input as little endian regardless of the platform.
+		///
+		inline Hash128 murmur3(const void *data, std::size_t length, std::uint32_t seed = 0)
+		{
+			const unsigned char *bytes = static_cast<const unsigned char *>(data);
+			const std::size_t blocks = length / 16;
+			
+			const std::uint64_t c1 = 0x87c37b91114253d5ULL;
+			const std::uint64_t c2 = 0x4cf5ad432745937fULL;
+			
+			std::uint64_t h1 = seed;
+			std::uint64_t h2 = seed;
+			
+			for (std::size_t i = 0; i < blocks; i++) {
+				std::uint64_t k1 = load(bytes + i * 16);
+				std::uint64_t k2 = load(bytes + i * 16 + 8);
+				
+				k1 *= c1; k1 = rotl(k1, 31); k1 *= c2; h1 ^= k1;
+				h1 = rotl(h1, 27); h1 += h2; h1 = h1 * 5 + 0x52dce729;
+				
+				k2 *= c2; k2 = rotl(k2, 33); k2 *= c1; h2 ^= k2;
+				h2 = rotl(h2, 31); h2 += h1; h2 = h2 * 5 + 0x38495ab5;
+			}
+			
+			const unsigned char *tail = bytes + blocks * 16;
+			std::uint64_t k1 = 0;
+			std::uint64_t k2 = 0;
+			
+			switch (length & 15) {
+				case 15: k2 ^= std::uint64_t(tail[14]) << 48; // fall through
+				case 14: k2 ^= std::uint64_t(tail[13]) << 40; // fall through
+				case 13: k2 ^= std::uint64_t(tail[12]) << 32; // fall through
+				case 12: k2 ^= std::uint64_t(tail[11]) << 24; // fall through
+				case 11: k2 ^= std::uint64_t(tail[10]) << 16; // fall through
+				case 10: k2 ^= std::uint64_t(tail[ 9]) << 8;  // fall through
+				case  9: k2 ^= std::uint64_t(tail[ 8]);
+				         k2 *= c2; k2 = rotl(k2, 33); k2 *= c1; h2 ^= k2;
+				         // fall through
+				case  8: k1 ^= std::uint64_t(tail[ 7]) << 56; // fall through
+				case  7: k1 ^= std::uint64_t(tail[ 6]) << 48; // fall through
+				case  6: k1 ^= std::uint64_t(tail[ 5]) << 40; // fall through
+				case  5: k1 ^= std::uint64_t(tail[ 4]) << 32; // fall through
+				case  4: k1 ^= std::uint64_t(tail[ 3]) << 24; // fall through
+				case  3: k1 ^= std::uint64_t(tail[ 2]) << 16; // fall through
+				case  2: k1 ^= std::uint64_t(tail[ 1]) << 8;  // fall through
+				case  1: k1 ^= std::uint64_t(tail[ 0]);
+				         k1 *= c1; k1 = rotl(k1, 31); k1 *= c2; h1 ^= k1;
+			}
+			
+			h1 ^= length;
+			h2 ^= length;
+			
+			h1 += h2;
+			h2 += h1;
+			
+			h1 = fmix(h1);
+			h2 = fmix(h2);
+			
+			h1 += h2;
+			h2 += h1;
+			
+			return Hash128 { h1, h2 };
+		}
+	}
+
+}
+
+#endif /* N3_HASH_HH */
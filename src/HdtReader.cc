@@ -0,0 +1,198 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#include "HdtReader.hh"
+#include "HdtWriter.hh"
+
+namespace turtle {
+	
+	void HdtReader::readSection(std::vector<std::string> &section)
+	{
+		std::uint64_t size = binary::readVarInt(m_inbuf);
+		binary::readVarInt(m_inbuf); // block size, only needed for random access
+		
+		binary::PackedArray blocks;
+		blocks.read(m_inbuf);
+		
+		std::string data;
+		binary::readString(m_inbuf, data);
+		
+		// every entry takes at least one byte of data
+		if (size > data.size())
+			throw BinaryFormatException("invalid dictionary");
+		
+		section.clear();
+		section.reserve(size);
+		
+		std::size_t p = 0;
+		std::size_t block = 0;
+		
+		auto varInt = [&data, &p]() -> std::size_t {
+			std::size_t value = 0;
+			for (int shift = 0; p < data.size(); shift += 7) {
+				unsigned char c = data[p++];
+				value |= static_cast<std::size_t>(c & 0x7F) << shift;
+				if (!(c & 0x80))
+					return value;
+			}
+			throw BinaryFormatException("truncated dictionary");
+		};
+		
+		for (std::size_t i = 0; i < size; i++) {
+			if (block < blocks.size() && blocks[block] == p) {
+				++block;
+				std::size_t length = varInt();
+				if (p + length > data.size())
+					throw BinaryFormatException("truncated dictionary");
+				section.emplace_back(data, p, length);
+				p += length;
+			} else {
+				if (section.empty())
+					throw BinaryFormatException("invalid dictionary");
+				std::size_t shared = varInt();
+				std::size_t length = varInt();
+				if (shared > section.back().length() || p + length > data.size())
+					throw BinaryFormatException("invalid dictionary");
+				std::string s(section.back(), 0, shared);
+				s.append(data, p, length);
+				section.push_back(std::move(s));
+				p += length;
+			}
+		}
+	}
+	
+	void HdtReader::read(const std::string &source)
+	{
+		m_sink->document(source);
+		
+		binary::readMagic(m_inbuf, HdtWriter::MAGIC, HdtWriter::MAGIC_LENGTH);
+		
+		std::vector<std::string> shared, subjects, objects, predicates;
+		readSection(shared);
+		readSection(subjects);
+		readSection(objects);
+		readSection(predicates);
+		
+		binary::PackedArray sp, bp, so, bo;
+		sp.read(m_inbuf);
+		bp.read(m_inbuf);
+		so.read(m_inbuf);
+		bo.read(m_inbuf);
+		
+		if (sp.size() != bp.size() || so.size() != bo.size())
+			throw BinaryFormatException("invalid triples");
+		
+		// terms are only parsed once, id 0 is unused
+		std::vector<std::unique_ptr<N3Node>> subjectTerms(1), objectTerms(1);
+		std::vector<std::unique_ptr<URIResource>> predicateTerms(1);
+		
+		for (const std::string &t : shared)
+			subjectTerms.push_back(parseTerm(t));
+		for (const std::string &t : subjects)
+			subjectTerms.push_back(parseTerm(t));
+		for (const std::string &t : predicates)
+			predicateTerms.emplace_back(new URIResource(t));
+		
+		for (std::size_t i = 0; i < shared.size(); i++)
+			objectTerms.emplace_back(subjectTerms[i + 1]->clone());
+		for (const std::string &t : objects)
+			objectTerms.push_back(parseTerm(t));
+		
+		std::size_t s = 1;
+		std::size_t j = 0;
+		
+		for (std::size_t i = 0; i < sp.size(); i++) {
+			std::size_t p = sp[i];
+			if (s >= subjectTerms.size() || p == 0 || p >= predicateTerms.size())
+				throw BinaryFormatException("invalid triples");
+			
+			const Resource *subject = dynamic_cast<const Resource *>(subjectTerms[s].get());
+			if (!subject)
+				throw BinaryFormatException("literal used as subject");
+			
+			do {
+				if (j >= so.size() || so[j] == 0 || so[j] >= objectTerms.size())
+					throw BinaryFormatException("invalid triples");
+				
+				m_sink->triple(*subject, *predicateTerms[p], *objectTerms[so[j]]);
+			} while (!bo[j++]);
+			
+			if (bp[i])
+				++s;
+		}
+	}
+	
+	std::unique_ptr<N3Node> HdtReader::parseTerm(const std::string &term)
+	{
+		if (term.length() >= 2 && term[0] == '<')
+			return std::unique_ptr<N3Node>(new URIResource(term.substr(1, term.length() - 2)));
+		
+		if (term.length() >= 3 && term[0] == '_')
+			return std::unique_ptr<N3Node>(new BlankNode(term.substr(3)));
+		
+		if (term.empty() || term[0] != '"')
+			throw BinaryFormatException("invalid term " + term);
+		
+		// reverse of NTripleFormatter::output
+		std::string lexical;
+		std::size_t i = 1;
+		for (; i < term.length() && term[i] != '"'; i++) {
+			char c = term[i];
+			if (c == '\\' && i + 1 < term.length()) {
+				switch (term[++i]) {
+					case 'n' : lexical.push_back('\n'); break;
+					case 'r' : lexical.push_back('\r'); break;
+					default  : lexical.push_back(term[i]);
+				}
+			} else {
+				lexical.push_back(c);
+			}
+		}
+		
+		if (i == term.length())
+			throw BinaryFormatException("invalid term " + term);
+		
+		++i;
+		
+		if (i == term.length())
+			return std::unique_ptr<N3Node>(new StringLiteral(std::move(lexical)));
+		
+		if (term[i] == '@')
+			return std::unique_ptr<N3Node>(new StringLiteral(std::move(lexical), m_languages.intern(term.data() + i + 1, term.length() - i - 1)));
+		
+		if (term.compare(i, 3, "^^<") != 0)
+			throw BinaryFormatException("invalid term " + term);
+		
+		std::size_t length = term.length() - i - 4;
+		
+		switch (WellKnown::lookup(term.data() + i + 3, length)) {
+			case WellKnown::XSD_INTEGER:
+				return std::unique_ptr<N3Node>(new IntegerLiteral(lexical));
+			case WellKnown::XSD_DECIMAL:
+				return std::unique_ptr<N3Node>(new DecimalLiteral(lexical));
+			case WellKnown::XSD_BOOLEAN:
+				return std::unique_ptr<N3Node>(new BooleanLiteral(lexical));
+			case WellKnown::XSD_DOUBLE:
+				return std::unique_ptr<N3Node>(new DoubleLiteral(lexical));
+			default:
+				break;
+		}
+		
+		return std::unique_ptr<N3Node>(new OtherLiteral(std::move(lexical), m_datatypes.intern(term.data() + i + 3, length)));
+	}
+	
+}
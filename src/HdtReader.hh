@@ -0,0 +1,61 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#ifndef N3_HDTREADER_HH
+#define N3_HDTREADER_HH
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <memory>
+#include <istream>
+
+#include "Parser.hh"
+#include "Model.hh"
+#include "Binary.hh"
+
+namespace turtle {
+	
+	///
+	/// Reads files written by HdtWriter and streams their triples to a TripleSink.
+	///
+	class HdtReader {
+		
+		std::streambuf *m_inbuf;
+		TripleSink *m_sink;
+		InternCache m_datatypes;
+		InternCache m_languages;
+		
+		void readSection(std::vector<std::string> &section);
+		
+	public:
+		HdtReader(std::istream *in, TripleSink *sink) : m_inbuf(in->rdbuf()), m_sink(sink), m_datatypes(), m_languages() {}
+		
+		/// true if the next byte of in starts the HdtWriter::MAGIC header
+		static bool accepts(std::istream &in)
+		{
+			return in.peek() == 0x89;
+		}
+		
+		void read(const std::string &source);
+		
+		std::unique_ptr<N3Node> parseTerm(const std::string &term);
+	};
+
+}
+
+#endif /* N3_HDTREADER_HH */
@@ -0,0 +1,185 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#include "HdtWriter.hh"
+
+#include <algorithm>
+
+namespace turtle {
+	
+	const char HdtWriter::MAGIC[] = "\x89HDT\r\n\x1A\n";
+	
+	std::uint32_t HdtWriter::term(const N3Node &node, bool subject)
+	{
+		m_term.clear();
+		node.visit(m_formatter);
+		
+		auto r = m_terms.emplace(m_term, Term { static_cast<std::uint32_t>(m_terms.size()), false, false });
+		Term &t = r.first->second;
+		if (subject)
+			t.subject = true;
+		else
+			t.object = true;
+		
+		return t.id;
+	}
+	
+	void HdtWriter::rawTriple(const Resource &subject, const URIResource &property, const N3Node &object)
+	{
+		std::uint32_t s = term(subject, true);
+		std::uint32_t o = term(object, false);
+		
+		auto r = m_predicates.emplace(property.uri(), static_cast<std::uint32_t>(m_predicates.size()));
+		
+		m_triples.push_back(IdTriple { s, r.first->second, o });
+	}
+	
+	void HdtWriter::end()
+	{
+		auto less = [](const std::string *a, const std::string *b) { return *a < *b; };
+		
+		// sections: shared, subjects only, objects only, predicates
+		std::vector<const std::string *> shared, subjects, objects, predicates;
+		
+		for (auto &t : m_terms) {
+			if (t.second.subject && t.second.object)
+				shared.push_back(&t.first);
+			else if (t.second.subject)
+				subjects.push_back(&t.first);
+			else
+				objects.push_back(&t.first);
+		}
+		
+		predicates.reserve(m_predicates.size());
+		for (auto &p : m_predicates)
+			predicates.push_back(&p.first);
+		
+		std::sort(shared.begin(), shared.end(), less);
+		std::sort(subjects.begin(), subjects.end(), less);
+		std::sort(objects.begin(), objects.end(), less);
+		std::sort(predicates.begin(), predicates.end(), less);
+		
+		// map temporary ids to final ids, starting from 1 as in HDT
+		std::vector<std::uint32_t> subjectIds(m_terms.size()), objectIds(m_terms.size()), predicateIds(m_predicates.size());
+		
+		for (std::size_t i = 0; i < shared.size(); i++) {
+			std::uint32_t id = m_terms.find(*shared[i])->second.id;
+			subjectIds[id] = objectIds[id] = i + 1;
+		}
+		for (std::size_t i = 0; i < subjects.size(); i++)
+			subjectIds[m_terms.find(*subjects[i])->second.id] = shared.size() + i + 1;
+		for (std::size_t i = 0; i < objects.size(); i++)
+			objectIds[m_terms.find(*objects[i])->second.id] = shared.size() + i + 1;
+		for (std::size_t i = 0; i < predicates.size(); i++)
+			predicateIds[m_predicates.find(*predicates[i])->second] = i + 1;
+		
+		for (IdTriple &t : m_triples) {
+			t.s = subjectIds[t.s];
+			t.p = predicateIds[t.p];
+			t.o = objectIds[t.o];
+		}
+		
+		m_outbuf->sputn(MAGIC, MAGIC_LENGTH);
+		writeSection(shared);
+		writeSection(subjects);
+		writeSection(objects);
+		writeSection(predicates);
+		writeTriples(m_triples);
+		m_count = static_cast<unsigned>(m_triples.size()); // without the duplicates writeTriples removed
+		
+		m_outbuf->pubsync();
+	}
+	
+	///
+	/// Front coding: strings are grouped in blocks of BLOCK_SIZE, the first string of
+	/// a block is stored completely, the others as (shared prefix length, suffix).
+	/// Block offsets are stored so that a reader can locate a string by its id.
+	///
+	void HdtWriter::writeSection(std::vector<const std::string *> &section)
+	{
+		std::string data;
+		std::vector<std::uint64_t> offsets;
+		
+		for (std::size_t i = 0; i < section.size(); i++) {
+			const std::string &s = *section[i];
+			
+			if (i % BLOCK_SIZE == 0) {
+				offsets.push_back(data.size());
+				binary::writeVarInt(data, s.length());
+				data.append(s);
+			} else {
+				const std::string &previous = *section[i - 1];
+				std::size_t n = 0, max = std::min(s.length(), previous.length());
+				while (n < max && s[n] == previous[n])
+					++n;
+				
+				binary::writeVarInt(data, n);
+				binary::writeVarInt(data, s.length() - n);
+				data.append(s, n, std::string::npos);
+			}
+		}
+		
+		binary::PackedArray blocks(binary::bits(data.size()));
+		for (std::uint64_t offset : offsets)
+			blocks.push_back(offset);
+		
+		binary::writeVarInt(m_outbuf, section.size());
+		binary::writeVarInt(m_outbuf, BLOCK_SIZE);
+		blocks.write(m_outbuf);
+		binary::writeString(m_outbuf, data);
+	}
+	
+	///
+	/// Bitmap triples: the triples are sorted and grouped by subject, subjects are implicit.
+	/// Sp holds the predicates of each subject, bit Bp[i] is set for the last predicate
+	/// of a subject; So holds the objects of each (subject, predicate) pair, Bo[i] marks the last one.
+	///
+	void HdtWriter::writeTriples(std::vector<IdTriple> &triples)
+	{
+		std::sort(triples.begin(), triples.end());
+		triples.erase(std::unique(triples.begin(), triples.end()), triples.end());
+		
+		std::uint32_t maxP = 0, maxO = 0;
+		for (const IdTriple &t : triples) {
+			maxP = std::max(maxP, t.p);
+			maxO = std::max(maxO, t.o);
+		}
+		
+		binary::PackedArray sp(binary::bits(maxP)), bp(1), so(binary::bits(maxO)), bo(1);
+		
+		for (std::size_t i = 0; i < triples.size(); i++) {
+			const IdTriple &t = triples[i];
+			bool last = i + 1 == triples.size();
+			bool lastSubject = last || triples[i + 1].s != t.s;
+			bool lastPair = lastSubject || triples[i + 1].p != t.p;
+			
+			so.push_back(t.o);
+			bo.push_back(lastPair);
+			
+			if (lastPair) {
+				sp.push_back(t.p);
+				bp.push_back(lastSubject);
+			}
+		}
+		
+		sp.write(m_outbuf);
+		bp.write(m_outbuf);
+		so.write(m_outbuf);
+		bo.write(m_outbuf);
+	}
+	
+}
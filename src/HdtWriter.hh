@@ -0,0 +1,123 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#ifndef N3_HDTWRITER_HH
+#define N3_HDTWRITER_HH
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <ostream>
+
+#include "Parser.hh"
+#include "NTriplesWriter.hh"
+#include "ListExpander.hh"
+#include "Binary.hh"
+
+namespace turtle {
+	
+	///
+	/// Writes an HDT-like self-contained, indexed binary file: a dictionary of
+	/// front-coded sorted sections (shared subject/objects, subjects, objects,
+	/// predicates) followed by bitmap triples in SPO order. Terms are stored in
+	/// their N-Triples form. The whole graph is kept in memory until end().
+	///
+	/// This is not compatible with the HDT specification, use HdtReader to read it back.
+	///
+	class HdtWriter : public TripleSink {
+		
+		struct Term {
+			std::uint32_t id;
+			bool subject;
+			bool object;
+		};
+		
+		struct IdTriple {
+			std::uint32_t s;
+			std::uint32_t p;
+			std::uint32_t o;
+			
+			bool operator<(const IdTriple &other) const
+			{
+				return s < other.s || (s == other.s && (p < other.p || (p == other.p && o < other.o)));
+			}
+			
+			bool operator==(const IdTriple &other) const
+			{
+				return s == other.s && p == other.p && o == other.o;
+			}
+		};
+		
+		std::streambuf *m_outbuf;
+		std::string m_term;
+		StringOutputBuffer m_termbuf;
+		std::ostream m_termout;
+		NTripleFormatter m_formatter;
+		ListExpander m_lists;
+		
+		std::unordered_map<std::string, Term> m_terms;
+		std::unordered_map<std::string, std::uint32_t> m_predicates;
+		std::vector<IdTriple> m_triples;
+		unsigned m_count;
+		
+		std::uint32_t term(const N3Node &node, bool subject);
+		void rawTriple(const Resource &subject, const URIResource &property, const N3Node &object);
+		
+		void writeSection(std::vector<const std::string *> &section);
+		void writeTriples(std::vector<IdTriple> &triples);
+		
+	public:
+		static const char MAGIC[];
+		static const std::size_t MAGIC_LENGTH = 8;
+		static const std::size_t BLOCK_SIZE   = 16;
+		
+		explicit HdtWriter(std::ostream &out) : TripleSink(), m_outbuf(out.rdbuf()), m_term(), m_termbuf(m_term), m_termout(&m_termbuf), m_formatter(m_termout), m_lists(), m_terms(), m_predicates(), m_triples(), m_count(0)
+		{
+			// nop
+		}
+		
+		void start() override
+		{
+			// nop
+		}
+		
+		void end() override;
+		
+		void document(const std::string &source) override
+		{
+			// nop
+		}
+		
+		void prefix(const std::string &prefix, const std::string &ns) override
+		{
+			// nop
+		}
+		
+		void triple(const Resource &subject, const URIResource &property, const N3Node &object) override
+		{
+			m_lists.triple(subject, property, object, [this](const Resource &s, const URIResource &p, const N3Node &o) { rawTriple(s, p, o); });
+		}
+		
+		/// The number of distinct triples written, known once end() has been called.
+		unsigned count() const override { return m_count; }
+	};
+
+}
+
+#endif /* N3_HDTWRITER_HH */
@@ -0,0 +1,180 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef N3_INTERNED_HH
+#define N3_INTERNED_HH
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+namespace turtle {
+	
+	///
+	/// A datatype IRI, language tag or namespace, stored once for the terms
+	/// that have it.
+	///
+	class Interned {
+		
+		std::string m_value;
+		
+	public:
+		explicit Interned(const std::string &value) : m_value(value)
+		{
+			// nop
+		}
+		
+		Interned(const Interned &) = delete;
+		Interned &operator=(const Interned &) = delete;
+		
+		const std::string &value() const { return m_value; }
+	};
+	
+	///
+	/// Refers to an entry. Entries made by an InternCache are counted, so they
+	/// live as long as the terms that use them. Constants are not counted, so
+	/// that threads do not contend for their count.
+	///
+	class InternedRef {
+		
+		const Interned *m_entry;
+		std::shared_ptr<const Interned> m_shared; // empty for constants
+		
+	public:
+		InternedRef() : m_entry(nullptr), m_shared()
+		{
+			// nop
+		}
+		
+		/// entry must outlive the terms that refer to it
+		explicit InternedRef(const Interned *entry) : m_entry(entry), m_shared()
+		{
+			// nop
+		}
+		
+		explicit InternedRef(std::shared_ptr<const Interned> entry) : m_entry(entry.get()), m_shared(std::move(entry))
+		{
+			// nop
+		}
+		
+		/// An entry of its own for value, shared with nothing.
+		static InternedRef make(const std::string &value)
+		{
+			return InternedRef(std::make_shared<const Interned>(value));
+		}
+		
+		const Interned *get() const { return m_entry; }
+		
+		const Interned &operator*() const { return *m_entry; }
+		
+		const Interned *operator->() const { return m_entry; }
+	};
+	
+	///
+	/// The entries a single parser or reader has made, so that equal values
+	/// share one entry. Once it holds MAX_SIZE entries it starts over, which
+	/// only costs sharing, as the terms keep their entries alive.
+	///
+	class InternCache {
+		
+		std::unordered_map<std::string, InternedRef> m_entries;
+		std::string m_key;
+		
+	public:
+		static const std::size_t MAX_SIZE = 4096;
+		
+		InternCache() : m_entries(), m_key()
+		{
+			// nop
+		}
+		
+		const InternedRef &intern(const std::string &value)
+		{
+			auto i = m_entries.find(value);
+			if (i != m_entries.end())
+				return i->second;
+			
+			if (m_entries.size() >= MAX_SIZE)
+				m_entries.clear();
+			
+			return m_entries.emplace(value, InternedRef::make(value)).first->second;
+		}
+		
+		/// Interns length bytes of s without allocating once the value is known.
+		const InternedRef &intern(const char *s, std::size_t length)
+		{
+			m_key.assign(s, length);
+			
+			return intern(m_key);
+		}
+	};
+
+	
+	///
+	/// What a writer prints for entries, rendered the first time an entry is
+	/// seen. It keeps the entries it has rendered, so an address can not be
+	/// reused for another value while it is a key. Once it holds MAX_SIZE
+	/// renderings it starts over.
+	///
+	class Renderings {
+		
+		struct Rendering {
+			InternedRef entry;
+			std::string bytes;
+		};
+		
+		std::unordered_map<const Interned *, Rendering> m_renderings;
+		const Interned *m_last; // consecutive terms tend to have the same entry
+		const std::string *m_lastBytes;
+		
+	public:
+		static const std::size_t MAX_SIZE = 4096;
+		
+		Renderings() : m_renderings(), m_last(nullptr), m_lastBytes(nullptr)
+		{
+			// nop
+		}
+		
+		Renderings(const Renderings &) = delete;
+		Renderings &operator=(const Renderings &) = delete;
+		
+		/// render(value, bytes) fills in bytes the first time entry is seen.
+		template<typename Render>
+		const std::string &get(const InternedRef &entry, Render render)
+		{
+			if (entry.get() == m_last)
+				return *m_lastBytes;
+			
+			auto i = m_renderings.find(entry.get());
+			if (i == m_renderings.end()) {
+				if (m_renderings.size() >= MAX_SIZE)
+					m_renderings.clear();
+				
+				i = m_renderings.emplace(entry.get(), Rendering { entry, std::string() }).first;
+				render(entry->value(), i->second.bytes);
+			}
+			
+			m_last = entry.get();
+			m_lastBytes = &i->second.bytes;
+			
+			return *m_lastBytes;
+		}
+	};
+
+}
+
+#endif /* N3_INTERNED_HH */
@@ -0,0 +1,403 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) && defined(__GNUC__)
+#	include <emmintrin.h>
+#	define N3_IRI_SSE2
+#endif
+
+#include "IriValidator.hh"
+
+namespace turtle {
+	
+	namespace {
+		
+		inline bool alpha(char c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'); }
+		inline bool digit(char c) { return c >= '0' && c <= '9'; }
+		inline bool hex(char c)   { return digit(c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F'); }
+		
+		enum CharacterClass { PLAIN = 1, SCHEME = 2 };
+		
+		/// PLAIN: unreserved / sub-delims / ":" / "@" / "/" / "?", the ASCII characters that need no further checks.
+		/// SCHEME: ALPHA / DIGIT / "+" / "-" / "."
+		struct CharacterClasses {
+			unsigned char table[256];
+			
+			CharacterClasses() : table()
+			{
+				for (int c = 0; c < 128; c++) {
+					if (alpha(c) || digit(c) || c == '!' || c == '$' || (c >= '&' && c <= ';') || c == '=' || (c >= '?' && c <= '@') || c == '_' || c == '~')
+						table[c] |= PLAIN;
+					if (alpha(c) || digit(c) || c == '+' || c == '-' || c == '.')
+						table[c] |= SCHEME;
+				}
+			}
+		};
+		
+		const CharacterClasses CLASSES;
+		
+		inline bool is(char c, CharacterClass type) { return CLASSES.table[static_cast<unsigned char>(c)] & type; }
+		
+		inline bool ucschar(std::uint32_t c)
+		{
+			if (c < 0x10000)
+				return (c >= 0xA0 && c <= 0xD7FF) || (c >= 0xF900 && c <= 0xFDCF) || (c >= 0xFDF0 && c <= 0xFFEF);
+			
+			// planes 1 to 14, without the last two code points of each plane and the start of plane 14
+			return c < 0xF0000 && (c & 0xFFFE) != 0xFFFE && (c < 0xE0000 || c >= 0xE1000);
+		}
+		
+		inline bool iprivate(std::uint32_t c)
+		{
+			return (c >= 0xE000 && c <= 0xF8FF) || (c >= 0xF0000 && (c & 0xFFFE) != 0xFFFE && c <= 0x10FFFD);
+		}
+		
+		/// Decodes the UTF-8 sequence at s[i], returns its length or 0 if it is malformed.
+		std::size_t decode(const char *s, std::size_t i, std::size_t end, std::uint32_t &c)
+		{
+			unsigned char b = static_cast<unsigned char>(s[i]);
+			std::size_t n;
+			std::uint32_t min;
+			
+			if (b >= 0xC2 && b <= 0xDF) {
+				n = 2; c = b & 0x1F; min = 0x80;
+			} else if (b >= 0xE0 && b <= 0xEF) {
+				n = 3; c = b & 0x0F; min = 0x800;
+			} else if (b >= 0xF0 && b <= 0xF4) {
+				n = 4; c = b & 0x07; min = 0x10000;
+			} else {
+				return 0;
+			}
+			
+			if (end - i < n)
+				return 0;
+			
+			for (std::size_t k = 1; k < n; k++) {
+				unsigned char t = static_cast<unsigned char>(s[i + k]);
+				if ((t & 0xC0) != 0x80)
+					return 0;
+				c = (c << 6) | (t & 0x3F);
+			}
+			
+			if (c < min || c > 0x10FFFF || (c >= 0xD800 && c <= 0xDFFF))
+				return 0;
+			
+			return n;
+		}
+		
+		bool decOctet(const char *s, std::size_t begin, std::size_t end)
+		{
+			std::size_t n = end - begin;
+			if (n == 0 || n > 3 || (n > 1 && s[begin] == '0'))
+				return false;
+			
+			unsigned value = 0;
+			for (std::size_t i = begin; i < end; i++) {
+				if (!digit(s[i]))
+					return false;
+				value = 10 * value + (s[i] - '0');
+			}
+			
+			return value <= 255;
+		}
+		
+		bool ipv4(const char *s, std::size_t begin, std::size_t end)
+		{
+			for (int octet = 0; octet < 4; octet++) {
+				std::size_t dot = begin;
+				while (dot < end && s[dot] != '.')
+					dot++;
+				
+				if (!decOctet(s, begin, dot) || (octet < 3) != (dot < end))
+					return false;
+				
+				begin = dot + 1;
+			}
+			
+			return true;
+		}
+		
+#ifdef N3_IRI_SSE2
+		inline __m128i between(__m128i x, char low, char high)
+		{
+			return _mm_and_si128(_mm_cmpgt_epi8(x, _mm_set1_epi8(low - 1)), _mm_cmplt_epi8(x, _mm_set1_epi8(high + 1)));
+		}
+		
+		inline __m128i equal(__m128i x, char c)
+		{
+			return _mm_cmpeq_epi8(x, _mm_set1_epi8(c));
+		}
+#endif
+		
+		/// Where the authority starting at begin ends, how many '@' it has and its first ':' after the last '@'.
+		struct Delimiters {
+			std::size_t end;
+			std::size_t colon;
+			unsigned ats;
+		};
+		
+		Delimiters delimiters(const char *s, std::size_t begin, std::size_t length)
+		{
+			Delimiters d = { begin, length, 0 };
+			
+#ifdef N3_IRI_SSE2
+			// most authorities fit in a single vector
+			if (length - begin >= 16) {
+				__m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + begin));
+				unsigned stop = _mm_movemask_epi8(_mm_or_si128(_mm_or_si128(equal(x, '/'), equal(x, '?')), equal(x, '#')));
+				if (stop) {
+					unsigned before = (1u << __builtin_ctz(stop)) - 1;
+					unsigned ats = _mm_movemask_epi8(equal(x, '@')) & before;
+					unsigned colons = _mm_movemask_epi8(equal(x, ':')) & before;
+					if (ats) {
+						colons &= ~((1u << (31 - __builtin_clz(ats))) * 2 - 1);
+						d.ats = __builtin_popcount(ats);
+					}
+					d.end = begin + __builtin_ctz(stop);
+					if (colons)
+						d.colon = begin + __builtin_ctz(colons);
+					return d;
+				}
+			}
+#endif
+			
+			for (; d.end < length; d.end++) {
+				char c = s[d.end];
+				if (c == '/' || c == '?' || c == '#')
+					break;
+				if (c == '@') {
+					d.ats++;
+					d.colon = length;
+				} else if (c == ':' && d.colon == length) {
+					d.colon = d.end;
+				}
+			}
+			
+			return d;
+		}
+		
+	}
+	
+	/// The index of the first character in [from, length) that is not plain, length if there is none.
+	std::size_t IriValidator::plain(const char *s, std::size_t from, std::size_t length)
+	{
+		std::size_t i = from;
+		
+#ifdef N3_IRI_SSE2
+		for (; i + 16 <= length; i += 16) {
+			__m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + i));
+			
+			// bytes of 0x80 and up are negative, so they are in none of the ranges
+			__m128i good = _mm_or_si128(
+				_mm_or_si128(
+					_mm_or_si128(between(x, 'a', 'z'), between(x, '?', 'Z')),
+					_mm_or_si128(between(x, '&', ';'), equal(x, '_'))),
+				_mm_or_si128(
+					_mm_or_si128(equal(x, '!'), equal(x, '$')),
+					_mm_or_si128(equal(x, '='), equal(x, '~'))));
+			
+			unsigned bad = ~static_cast<unsigned>(_mm_movemask_epi8(good)) & 0xFFFF;
+			if (bad)
+				return i + __builtin_ctz(bad);
+		}
+#endif
+		
+		while (i < length && is(s[i], PLAIN))
+			i++;
+		
+		return i;
+	}
+	
+	/// Checks ipath, iquery (query) or ifragment characters in [begin, end).
+	const char *IriValidator::segment(const char *s, std::size_t begin, std::size_t end, bool query)
+	{
+		for (std::size_t i = plain(s, begin, end); i < end; i = plain(s, i, end)) {
+			char c = s[i];
+			
+			if (c == '%') {
+				if (end - i < 3 || !hex(s[i + 1]) || !hex(s[i + 2]))
+					return "invalid percent encoding";
+				i += 3;
+			} else if (static_cast<unsigned char>(c) >= 0x80) {
+				std::uint32_t u;
+				std::size_t n = decode(s, i, end, u);
+				if (n == 0)
+					return "invalid UTF-8";
+				if (!ucschar(u) && !(query && iprivate(u)))
+					return "character not allowed in an IRI";
+				i += n;
+			} else if (c == '#') {
+				return "'#' in fragment";
+			} else {
+				return "character not allowed in an IRI";
+			}
+		}
+		
+		return nullptr;
+	}
+	
+	/// Checks [ iuserinfo "@" ] ihost [ ":" port ] in [begin, end).
+	const char *IriValidator::authority(const char *s, std::size_t begin, std::size_t end)
+	{
+		const char *at = static_cast<const char *>(std::memchr(s + begin, '@', end - begin));
+		if (at) {
+			std::size_t host = at - s;
+			if (segment(s, begin, host, false))
+				return "invalid user info";
+			begin = host + 1;
+		}
+		
+		std::size_t port;
+		if (begin < end && s[begin] == '[') {
+			const char *close = static_cast<const char *>(std::memchr(s + begin, ']', end - begin));
+			if (!close || !ipLiteral(s, begin + 1, close - s))
+				return "invalid IP literal";
+			port = close - s + 1;
+			if (port < end && s[port] != ':')
+				return "invalid IP literal";
+		} else {
+			const char *colon = static_cast<const char *>(std::memchr(s + begin, ':', end - begin));
+			port = colon ? colon - s : end;
+			if (std::memchr(s + begin, '@', port - begin) || segment(s, begin, port, false))
+				return "invalid host";
+		}
+		
+		for (std::size_t i = port + 1; i < end; i++) {
+			if (!digit(s[i]))
+				return "invalid port";
+		}
+		
+		return nullptr;
+	}
+	
+	/// Checks IPv6address / IPvFuture in [begin, end), without the brackets.
+	bool IriValidator::ipLiteral(const char *s, std::size_t begin, std::size_t end)
+	{
+		if (begin < end && (s[begin] == 'v' || s[begin] == 'V')) {
+			std::size_t i = begin + 1;
+			while (i < end && hex(s[i]))
+				i++;
+			if (i == begin + 1 || i == end || s[i] != '.' || ++i == end)
+				return false;
+			for (; i < end; i++) {
+				if (!is(s[i], PLAIN) || s[i] == '/' || s[i] == '?' || s[i] == '@')
+					return false;
+			}
+			return true;
+		}
+		
+		unsigned groups = 0;
+		bool compressed = false;
+		std::size_t i = begin;
+		
+		if (end - i >= 2 && s[i] == ':' && s[i + 1] == ':') {
+			compressed = true;
+			i += 2;
+		}
+		
+		while (i < end) {
+			std::size_t j = i;
+			while (j < end && hex(s[j]))
+				j++;
+			
+			if (j < end && s[j] == '.') { // ends in an IPv4 address
+				if (!ipv4(s, i, end))
+					return false;
+				groups += 2;
+				break;
+			}
+			
+			if (j == i || j - i > 4)
+				return false;
+			groups++;
+			
+			if (j == end)
+				break;
+			if (s[j] != ':' || j + 1 == end)
+				return false;
+			
+			i = j + 1;
+			if (s[i] == ':') {
+				if (compressed)
+					return false;
+				compressed = true;
+				i++;
+			}
+		}
+		
+		return compressed ? groups <= 7 : groups == 8;
+	}
+	
+	const char *IriValidator::check(const char *s, std::size_t length)
+	{
+		// scheme ":" ihier-part [ "?" iquery ] [ "#" ifragment ]
+		std::size_t i = 0;
+		if (i == length || !alpha(s[i]))
+			return "missing scheme";
+		while (++i < length && is(s[i], SCHEME))
+			;
+		if (i == length || s[i] != ':')
+			return "missing scheme";
+		i++;
+		
+		// Most IRIs are plain ASCII, apart from a '#'. Then only the authority needs a closer look.
+		std::size_t special = plain(s, i, length);
+		bool simple = special == length || (s[special] == '#' && plain(s, special + 1, length) == length);
+		
+		if (length - i >= 2 && s[i] == '/' && s[i + 1] == '/') {
+			std::size_t begin = i + 2;
+			Delimiters d = delimiters(s, begin, length);
+			std::size_t end = d.end;
+			
+			if (simple) {
+				// no IP literal, so the host ends at the first ':' after the user info
+				if (d.ats > 1)
+					return "invalid host";
+				for (std::size_t k = d.colon + 1; k < end; k++) {
+					if (!digit(s[k]))
+						return "invalid port";
+				}
+				return nullptr;
+			}
+			
+			const char *error = authority(s, begin, end);
+			if (error)
+				return error;
+			
+			i = end;
+		}
+		
+		if (simple)
+			return nullptr;
+		
+		const char *hash = static_cast<const char *>(std::memchr(s + i, '#', length - i));
+		std::size_t fragment = hash ? hash - s : length;
+		const char *question = static_cast<const char *>(std::memchr(s + i, '?', fragment - i));
+		std::size_t query = question ? question - s : fragment;
+		
+		const char *error = segment(s, i, query, false);
+		if (!error && query < fragment)
+			error = segment(s, query + 1, fragment, true);
+		if (!error && fragment < length)
+			error = segment(s, fragment + 1, length, false);
+		
+		return error;
+	}
+	
+}
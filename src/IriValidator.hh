@@ -0,0 +1,47 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef N3_IRIVALIDATOR_HH
+#define N3_IRIVALIDATOR_HH
+
+#include <cstddef>
+#include <string>
+
+namespace turtle {
+	
+	///
+	/// Checks absolute IRIs against the grammar of RFC 3987. Runs of plain
+	/// ASCII characters are checked 16 bytes at a time where SSE2 is
+	/// available, only percent encodings and non-ASCII characters are looked
+	/// at one by one.
+	///
+	class IriValidator {
+		
+		static std::size_t plain(const char *s, std::size_t from, std::size_t length);
+		static const char *segment(const char *s, std::size_t begin, std::size_t end, bool query);
+		static const char *authority(const char *s, std::size_t begin, std::size_t end);
+		static bool ipLiteral(const char *s, std::size_t begin, std::size_t end);
+		
+	public:
+		/// null if iri is valid, otherwise what is wrong with it.
+		static const char *check(const char *iri, std::size_t length);
+		
+		static const char *check(const std::string &iri) { return check(iri.data(), iri.length()); }
+	};
+
+}
+
+#endif /* N3_IRIVALIDATOR_HH */
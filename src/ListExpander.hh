@@ -0,0 +1,110 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#ifndef N3_LISTEXPANDER_HH
+#define N3_LISTEXPANDER_HH
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+#include "Model.hh"
+#include "BlankNodeIdGenerator.hh"
+
+namespace turtle {
+	
+	///
+	/// Replaces RDF collections by blank nodes, emitting the rdf:first/rdf:rest
+	/// triples that describe them. Used by writers for formats without list syntax.
+	///
+	class ListExpander {
+		
+		BlankNodeIdGenerator m_idgen;
+		
+		template<typename Output>
+		std::unique_ptr<BlankNode> triples(const RDFList &list, Output &output)
+		{
+			std::string id = m_idgen.generate();
+			
+			std::unique_ptr<BlankNode> head(new BlankNode(id));
+				
+			for (std::size_t i = 0; i < list.size(); i++) {
+				const N3Node *node = list[i];
+				
+				std::unique_ptr<BlankNode> nestedList;
+				if (const RDFList *rl = dynamic_cast<const RDFList *>(node)) {
+					if (rl->empty()) {
+						node = &RDF::nil;
+					} else {
+						nestedList = triples(*rl, output);
+						node = nestedList.get();
+					}
+				}
+					
+				output(*head, RDF::first, *node);
+				
+				if (i == list.size() - 1) {
+					output(*head, RDF::rest, RDF::nil);
+				} else {
+					std::unique_ptr<BlankNode> rest(new BlankNode(m_idgen.generate()));
+					output(*head, RDF::rest, *rest);
+					head = std::move(rest);
+				}
+			}
+				
+			return std::unique_ptr<BlankNode>(new BlankNode(id));
+		}
+		
+	public:
+		ListExpander() : m_idgen() {}
+		
+		///
+		/// Calls output(subject, property, object) for every triple needed to
+		/// represent the given triple without collections.
+		///
+		template<typename Output>
+		void triple(const Resource &subject, const URIResource &property, const N3Node &object, Output &&output)
+		{
+			std::unique_ptr<BlankNode> sp; // prevent sp.get() getting deleted
+			const Resource *s = &subject;
+			if (const RDFList *list = dynamic_cast<const RDFList *>(s)) {
+				if (list->empty()) {
+					s = &RDF::nil;
+				} else {
+					sp = triples(*list, output); 
+					s = sp.get();
+				}
+			}
+			
+			std::unique_ptr<BlankNode> op; // prevent op.get() getting deleted
+			const N3Node *o = &object;
+			if (const RDFList *list = dynamic_cast<const RDFList *>(o)) {
+				if (list->empty()) {
+					o = &RDF::nil;
+				} else {
+					op = triples(*list, output);
+					o = op.get();
+				}
+			}
+			
+			output(*s, property, *o);
+		}
+	};
+
+}
+
+#endif /* N3_LISTEXPANDER_HH */
@@ -0,0 +1,425 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <cstdint>
+#include <cstring>
+
+#include "LiteralValidator.hh"
+#include "WellKnown.hh"
+
+namespace turtle {
+	
+	namespace {
+		
+		/// Eight bytes as a little endian word, the compiler turns this into a single load.
+		inline std::uint64_t load(const char *s)
+		{
+			std::uint64_t x = 0;
+			for (int i = 0; i < 8; i++)
+				x |= static_cast<std::uint64_t>(static_cast<unsigned char>(s[i])) << (8 * i);
+			return x;
+		}
+		
+		/// The high bit of every byte of x that is not an ASCII digit.
+		inline std::uint64_t nonDigits(std::uint64_t x)
+		{
+			// a digit has high nibble 3 and a low nibble that does not carry when 6 is added
+			std::uint64_t bad = ((x & 0xF0F0F0F0F0F0F0F0ull) ^ 0x3030303030303030ull) | (((x & 0x0F0F0F0F0F0F0F0Full) + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull);
+			return (((bad & 0x7F7F7F7F7F7F7F7Full) + 0x7F7F7F7F7F7F7F7Full) | bad) & 0x8080808080808080ull;
+		}
+		
+		/// The index of the lowest byte with its high bit set, mask is not 0.
+		inline std::size_t firstByte(std::uint64_t mask)
+		{
+#ifdef __GNUC__
+			return __builtin_ctzll(mask) / 8;
+#else
+			std::size_t n = 0;
+			for (; !(mask & 0x80); mask >>= 8)
+				n++;
+			return n;
+#endif
+		}
+		
+		inline bool digit(char c) { return c >= '0' && c <= '9'; }
+		
+		/// Reads exactly n digits at s[i].
+		inline bool fixed(const char *s, std::size_t &i, std::size_t length, std::size_t n, unsigned &value)
+		{
+			if (length - i < n)
+				return false;
+			
+			value = 0;
+			for (std::size_t end = i + n; i < end; i++) {
+				if (!digit(s[i]))
+					return false;
+				value = 10 * value + (s[i] - '0');
+			}
+			
+			return true;
+		}
+		
+		/// The parts of [sign] digits [ "." digits ] [ ("e" | "E") [sign] digits ].
+		struct Number {
+			bool negative;
+			std::size_t intBegin, intEnd;
+			std::size_t fracBegin, fracEnd;
+			bool expNegative;
+			std::size_t expBegin, expEnd;
+			
+			/// Digit k of the digits before and after the point taken together.
+			char at(const char *s, std::size_t k) const
+			{
+				std::size_t n = intEnd - intBegin;
+				return k < n ? s[intBegin + k] : s[fracBegin + k - n];
+			}
+		};
+		
+		bool number(const char *s, std::size_t length, bool fraction, bool exponent, Number &n)
+		{
+			std::size_t i = 0;
+			
+			n.negative = false;
+			if (i < length && (s[i] == '+' || s[i] == '-'))
+				n.negative = s[i++] == '-';
+			
+			n.intBegin = i;
+			n.intEnd = i = LiteralValidator::digits(s, i, length);
+			
+			n.fracBegin = n.fracEnd = i;
+			if (fraction && i < length && s[i] == '.') {
+				n.fracBegin = ++i;
+				n.fracEnd = i = LiteralValidator::digits(s, i, length);
+			}
+			
+			if (n.intBegin == n.intEnd && n.fracBegin == n.fracEnd)
+				return false;
+			
+			n.expNegative = false;
+			n.expBegin = n.expEnd = i;
+			if (exponent && i < length && (s[i] == 'e' || s[i] == 'E')) {
+				if (++i < length && (s[i] == '+' || s[i] == '-'))
+					n.expNegative = s[i++] == '-';
+				n.expBegin = i;
+				n.expEnd = i = LiteralValidator::digits(s, i, length);
+				if (n.expBegin == n.expEnd)
+					return false;
+			}
+			
+			return i == length;
+		}
+		
+		/// Without sign and leading zeros, "-0" and "+0" become "0".
+		void canonicalInteger(const char *s, const Number &n, std::string &result)
+		{
+			std::size_t first = n.intBegin;
+			while (first < n.intEnd && s[first] == '0')
+				first++;
+			
+			result.clear();
+			if (first == n.intEnd) {
+				result.push_back('0');
+			} else {
+				if (n.negative)
+					result.push_back('-');
+				result.append(s + first, n.intEnd - first);
+			}
+		}
+		
+		/// At least one digit on both sides of the point, no other leading or trailing zeros.
+		void canonicalDecimal(const char *s, const Number &n, std::string &result)
+		{
+			std::size_t first = n.intBegin;
+			while (first < n.intEnd && s[first] == '0')
+				first++;
+			std::size_t last = n.fracEnd;
+			while (last > n.fracBegin && s[last - 1] == '0')
+				last--;
+			
+			result.clear();
+			if (n.negative && (first < n.intEnd || n.fracBegin < last))
+				result.push_back('-');
+			if (first == n.intEnd)
+				result.push_back('0');
+			else
+				result.append(s + first, n.intEnd - first);
+			result.push_back('.');
+			if (last == n.fracBegin)
+				result.push_back('0');
+			else
+				result.append(s + n.fracBegin, last - n.fracBegin);
+		}
+		
+		/// One non-zero digit before the point, at least one after it and an exponent, e.g. 1.25E2.
+		/// The digits are kept as written, they are not rounded to double precision.
+		void canonicalDouble(const char *s, std::size_t length, const Number &n, std::string &result)
+		{
+			std::size_t count = (n.intEnd - n.intBegin) + (n.fracEnd - n.fracBegin);
+			std::size_t first = 0;
+			while (first < count && n.at(s, first) == '0')
+				first++;
+			
+			result.clear();
+			if (n.negative)
+				result.push_back('-');
+			
+			if (first == count) {
+				result.append("0.0E0");
+				return;
+			}
+			
+			std::size_t expFirst = n.expBegin;
+			while (expFirst < n.expEnd && s[expFirst] == '0')
+				expFirst++;
+			if (n.expEnd - expFirst > 9) { // far outside the range of a double, leave it alone
+				result.assign(s, length);
+				return;
+			}
+			
+			long exponent = 0;
+			for (std::size_t i = expFirst; i < n.expEnd; i++)
+				exponent = 10 * exponent + (s[i] - '0');
+			if (n.expNegative)
+				exponent = -exponent;
+			exponent += static_cast<long>(n.intEnd - n.intBegin) - static_cast<long>(first) - 1;
+			
+			std::size_t last = count;
+			while (n.at(s, last - 1) == '0')
+				last--;
+			
+			result.push_back(n.at(s, first));
+			result.push_back('.');
+			if (last == first + 1)
+				result.push_back('0');
+			for (std::size_t k = first + 1; k < last; k++)
+				result.push_back(n.at(s, k));
+			result.push_back('E');
+			result.append(std::to_string(exponent));
+		}
+		
+		const char *checkDouble(const char *s, std::size_t length, std::string *canonical)
+		{
+			static const std::string SPECIAL[] = { "INF", "+INF", "-INF", "NaN" };
+			static const char *CANONICAL[] = { "INF", "INF", "-INF", "NaN" };
+			
+			if (length <= 4 && length > 0 && !digit(s[length - 1])) {
+				for (int k = 0; k < 4; k++) {
+					if (SPECIAL[k].compare(0, std::string::npos, s, length) == 0) {
+						if (canonical)
+							canonical->assign(CANONICAL[k]);
+						return nullptr;
+					}
+				}
+			}
+			
+			Number n;
+			if (!number(s, length, true, true, n))
+				return "not a floating point number";
+			
+			if (canonical)
+				canonicalDouble(s, length, n, *canonical);
+			
+			return nullptr;
+		}
+		
+		/// Reads -?yyyy+ and returns the year modulo 400, for leap years.
+		bool year(const char *s, std::size_t &i, std::size_t length, unsigned &mod400)
+		{
+			if (i < length && s[i] == '-')
+				i++;
+			
+			std::size_t begin = i;
+			i = LiteralValidator::digits(s, i, length);
+			if (i - begin < 4 || (i - begin > 4 && s[begin] == '0'))
+				return false;
+			
+			mod400 = 0;
+			for (std::size_t k = begin; k < i; k++)
+				mod400 = (10 * mod400 + (s[k] - '0')) % 400;
+			
+			return true;
+		}
+		
+		unsigned daysInMonth(unsigned month, unsigned mod400)
+		{
+			static const unsigned DAYS[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+			
+			if (month == 2 && (mod400 == 0 || (mod400 % 4 == 0 && mod400 % 100 != 0)))
+				return 29;
+			
+			return DAYS[month - 1];
+		}
+		
+		/// dateTime, dateTimeStamp, date, time, gYear and gYearMonth, with an optional time zone.
+		const char *checkDateTime(LiteralValidator::Type type, const char *s, std::size_t length)
+		{
+			bool hasDate = type != LiteralValidator::TIME;
+			bool hasMonth = hasDate && type != LiteralValidator::G_YEAR;
+			bool hasDay = hasMonth && type != LiteralValidator::G_YEAR_MONTH;
+			bool hasTime = type == LiteralValidator::DATE_TIME || type == LiteralValidator::DATE_TIME_STAMP || type == LiteralValidator::TIME;
+			
+			std::size_t i = 0;
+			unsigned mod400 = 0;
+			unsigned value;
+			
+			if (hasDate && !year(s, i, length, mod400))
+				return "invalid year";
+			
+			unsigned month = 0;
+			if (hasMonth) {
+				if (i == length || s[i++] != '-' || !fixed(s, i, length, 2, month))
+					return "invalid month";
+				if (month < 1 || month > 12)
+					return "month out of range";
+			}
+			
+			if (hasDay) {
+				if (i == length || s[i++] != '-' || !fixed(s, i, length, 2, value))
+					return "invalid day";
+				if (value < 1 || value > daysInMonth(month, mod400))
+					return "day out of range";
+			}
+			
+			if (hasTime) {
+				if (hasDate && (i == length || s[i++] != 'T'))
+					return "missing time";
+				
+				unsigned hour, minute, second;
+				if (!fixed(s, i, length, 2, hour) || i == length || s[i++] != ':' || !fixed(s, i, length, 2, minute) || i == length || s[i++] != ':' || !fixed(s, i, length, 2, second))
+					return "invalid time";
+				
+				bool fraction = false; // a non-zero fraction of a second
+				if (i < length && s[i] == '.') {
+					std::size_t begin = ++i;
+					i = LiteralValidator::digits(s, i, length);
+					if (i == begin)
+						return "invalid time";
+					for (std::size_t k = begin; k < i; k++)
+						fraction |= s[k] != '0';
+				}
+				
+				if (minute > 59)
+					return "minute out of range";
+				if (second > 59)
+					return "second out of range";
+				if (hour > 24 || (hour == 24 && (minute || second || fraction)))
+					return "hour out of range";
+			}
+			
+			if (i == length)
+				return type == LiteralValidator::DATE_TIME_STAMP ? "missing time zone" : nullptr;
+			
+			if (s[i] == 'Z')
+				return i + 1 == length ? nullptr : "invalid time zone";
+			
+			unsigned hour, minute;
+			if ((s[i] != '+' && s[i] != '-') || !fixed(s, ++i, length, 2, hour) || i == length || s[i++] != ':' || !fixed(s, i, length, 2, minute) || i != length)
+				return "invalid time zone";
+			if (minute > 59 || hour > 14 || (hour == 14 && minute))
+				return "time zone out of range";
+			
+			return nullptr;
+		}
+		
+	}
+	
+	LiteralValidator::Type LiteralValidator::type(const std::string &datatype)
+	{
+		switch (WellKnown::lookup(datatype)) {
+			case WellKnown::XSD_INTEGER:         return INTEGER;
+			case WellKnown::XSD_DECIMAL:         return DECIMAL;
+			case WellKnown::XSD_DOUBLE:          return DOUBLE;
+			case WellKnown::XSD_FLOAT:           return FLOAT;
+			case WellKnown::XSD_BOOLEAN:         return BOOLEAN;
+			case WellKnown::XSD_DATE_TIME:       return DATE_TIME;
+			case WellKnown::XSD_DATE_TIME_STAMP: return DATE_TIME_STAMP;
+			case WellKnown::XSD_DATE:            return DATE;
+			case WellKnown::XSD_TIME:            return TIME;
+			case WellKnown::XSD_G_YEAR:          return G_YEAR;
+			case WellKnown::XSD_G_YEAR_MONTH:    return G_YEAR_MONTH;
+			default:                             return OTHER;
+		}
+	}
+	
+	std::size_t LiteralValidator::digits(const char *s, std::size_t from, std::size_t end)
+	{
+		std::size_t i = from;
+		
+		for (; end - i >= 8; i += 8) {
+			std::uint64_t mask = nonDigits(load(s + i));
+			if (mask)
+				return i + firstByte(mask);
+		}
+		
+		if (i == end)
+			return i;
+		
+		// the zero padding stops the scan at end
+		char tail[8] = {};
+		std::memcpy(tail, s + i, end - i);
+		
+		return i + firstByte(nonDigits(load(tail)));
+	}
+	
+	const char *LiteralValidator::check(Type type, const char *s, std::size_t length, std::string *canonical)
+	{
+		Number n;
+		
+		switch (type) {
+			case INTEGER:
+				if (!number(s, length, false, false, n))
+					return "not an integer";
+				if (canonical)
+					canonicalInteger(s, n, *canonical);
+				return nullptr;
+			case DECIMAL:
+				if (!number(s, length, true, false, n))
+					return "not a decimal";
+				if (canonical)
+					canonicalDecimal(s, n, *canonical);
+				return nullptr;
+			case DOUBLE:
+			case FLOAT:
+				return checkDouble(s, length, canonical);
+			case BOOLEAN:
+				if (length == 1 && (s[0] == '0' || s[0] == '1')) {
+					if (canonical)
+						canonical->assign(s[0] == '1' ? "true" : "false");
+					return nullptr;
+				}
+				if ((length == 4 && std::memcmp(s, "true", 4) == 0) || (length == 5 && std::memcmp(s, "false", 5) == 0)) {
+					if (canonical)
+						canonical->assign(s, length);
+					return nullptr;
+				}
+				return "not a boolean";
+			case OTHER:
+				break;
+			default: {
+				const char *error = checkDateTime(type, s, length);
+				if (error)
+					return error;
+				break;
+			}
+		}
+		
+		if (canonical)
+			canonical->assign(s, length);
+		
+		return nullptr;
+	}
+	
+}
@@ -0,0 +1,54 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef N3_LITERALVALIDATOR_HH
+#define N3_LITERALVALIDATOR_HH
+
+#include <cstddef>
+#include <string>
+
+namespace turtle {
+	
+	///
+	/// Checks the lexical forms of the common XML Schema datatypes in a single
+	/// pass, producing the canonical form of numbers and booleans on the way.
+	/// Runs of digits are scanned eight bytes at a time, without a branch per
+	/// digit.
+	///
+	class LiteralValidator {
+	public:
+		enum Type { OTHER, INTEGER, DECIMAL, DOUBLE, FLOAT, BOOLEAN, DATE_TIME, DATE_TIME_STAMP, DATE, TIME, G_YEAR, G_YEAR_MONTH };
+		
+		/// The type of a datatype IRI, OTHER for datatypes that are not checked.
+		static Type type(const std::string &datatype);
+		
+		/// null if lexical is valid for type, otherwise what is wrong with it.
+		/// If canonical is not null, it receives the canonical form of a valid
+		/// number or boolean, and a copy of lexical for the other types.
+		static const char *check(Type type, const char *lexical, std::size_t length, std::string *canonical = nullptr);
+		
+		static const char *check(Type type, const std::string &lexical, std::string *canonical = nullptr)
+		{
+			return check(type, lexical.data(), lexical.length(), canonical);
+		}
+		
+		/// The index of the first character in [from, end) that is not a digit, end if there is none.
+		static std::size_t digits(const char *s, std::size_t from, std::size_t end);
+	};
+
+}
+
+#endif /* N3_LITERALVALIDATOR_HH */
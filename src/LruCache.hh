@@ -0,0 +1,181 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef N3_LRUCACHE_HH
+#define N3_LRUCACHE_HH
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Hash.hh"
+
+namespace turtle {
+	
+	///
+	/// String to string map of at most capacity entries, dropping the least
+	/// recently used one when full. Entries live in a fixed pool, indexed by
+	/// an open addressing hash table with linear probing, so once the pool is
+	/// filled, a miss only copies into the strings of the entry it replaces.
+	/// Counts the hits and misses of find().
+	///
+	class LruCache {
+		
+		static const std::uint32_t NONE = 0xFFFFFFFF;
+		
+		struct Entry {
+			std::string key;
+			std::string value;
+			std::uint64_t hash;
+			std::uint32_t previous; // more recently used
+			std::uint32_t next;     // less recently used
+		};
+		
+		std::size_t m_capacity;
+		std::vector<Entry> m_entries;
+		std::size_t m_size;
+		std::vector<std::uint32_t> m_slots; // entry index + 1, 0 for an empty slot
+		std::vector<std::uint64_t> m_seen;  // hashes of recent misses, by their low bits
+		std::uint64_t m_missed;             // hash of the last miss
+		std::uint32_t m_first;              // most recently used
+		std::uint32_t m_last;               // least recently used
+		std::uint64_t m_hits;
+		std::uint64_t m_misses;
+		
+		static std::uint64_t hash(const std::string &key) { return hash::murmur3(key.data(), key.length()).low; }
+		
+		void unlink(std::uint32_t i)
+		{
+			Entry &e = m_entries[i];
+			(e.previous == NONE ? m_first : m_entries[e.previous].next) = e.next;
+			(e.next == NONE ? m_last : m_entries[e.next].previous) = e.previous;
+		}
+		
+		void pushFront(std::uint32_t i)
+		{
+			Entry &e = m_entries[i];
+			e.previous = NONE;
+			e.next = m_first;
+			(m_first == NONE ? m_last : m_entries[m_first].previous) = i;
+			m_first = i;
+		}
+		
+		/// Removes entry i from the table, moving back the entries after it that would no longer be found.
+		void erase(std::uint32_t i)
+		{
+			std::size_t mask = m_slots.size() - 1;
+			std::size_t hole = m_entries[i].hash & mask;
+			while (m_slots[hole] != i + 1)
+				hole = (hole + 1) & mask;
+			
+			for (std::size_t j = (hole + 1) & mask; m_slots[j]; j = (j + 1) & mask) {
+				std::size_t home = m_entries[m_slots[j] - 1].hash & mask;
+				bool stays = hole <= j ? hole < home && home <= j : hole < home || home <= j;
+				if (!stays) {
+					m_slots[hole] = m_slots[j];
+					hole = j;
+				}
+			}
+			m_slots[hole] = 0;
+		}
+		
+	public:
+		explicit LruCache(std::size_t capacity) : m_capacity(capacity), m_entries(), m_size(0), m_slots(), m_seen(), m_missed(0), m_first(NONE), m_last(NONE), m_hits(0), m_misses(0)
+		{
+			std::size_t slots = 1;
+			while (slots < 2 * capacity)
+				slots *= 2;
+			
+			m_entries.reserve(capacity);
+			m_slots.assign(slots, 0);
+			m_seen.assign(slots, 0);
+		}
+		
+		/// The value of key, null if it is not cached. A hit makes key the most recently used.
+		const std::string *find(const std::string &key)
+		{
+			std::uint64_t h = hash(key);
+			std::size_t mask = m_slots.size() - 1;
+			
+			for (std::size_t j = h & mask; m_slots[j]; j = (j + 1) & mask) {
+				std::uint32_t i = m_slots[j] - 1;
+				Entry &e = m_entries[i];
+				if (e.hash == h && e.key == key) {
+					++m_hits;
+					if (i != m_first) {
+						unlink(i);
+						pushFront(i);
+					}
+					return &e.value;
+				}
+			}
+			
+			++m_misses;
+			m_missed = h;
+			
+			return nullptr;
+		}
+		
+		/// Adds key, for which find() just returned null, if it missed before.
+		void insert(const std::string &key, const std::string &value)
+		{
+			std::uint64_t &seen = m_seen[m_missed & (m_seen.size() - 1)];
+			if (seen != m_missed || m_capacity == 0) {
+				seen = m_missed;
+				return;
+			}
+			
+			std::uint32_t i;
+			if (m_size == m_capacity) {
+				i = m_last;
+				erase(i);
+				unlink(i);
+			} else {
+				i = static_cast<std::uint32_t>(m_size++);
+				if (i == m_entries.size())
+					m_entries.emplace_back();
+			}
+			
+			Entry &e = m_entries[i];
+			e.key.assign(key);
+			e.value.assign(value);
+			e.hash = m_missed;
+			pushFront(i);
+			
+			std::size_t mask = m_slots.size() - 1;
+			std::size_t j = e.hash & mask;
+			while (m_slots[j])
+				j = (j + 1) & mask;
+			m_slots[j] = i + 1;
+		}
+		
+		/// Drops all entries, keeping their memory. The counts are kept.
+		void clear()
+		{
+			m_size = 0;
+			m_first = m_last = NONE;
+			m_slots.assign(m_slots.size(), 0);
+		}
+		
+		std::size_t size() const { return m_size; }
+		std::uint64_t hits() const { return m_hits; }
+		std::uint64_t misses() const { return m_misses; }
+	};
+
+}
+
+#endif /* N3_LRUCACHE_HH */
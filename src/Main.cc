@@ -18,18 +18,668 @@
 #include <ostream>
 #include <fstream>
 #include <memory>
+#include <vector>
 #include <chrono>
 #include <iomanip>
+#include <map>
+#include <thread>
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <csignal>
+#include <atomic>
+#include <cstdio>
 
 #include "CommandLine.hh"
 #include "Parser.hh"
 #include "Uri.hh"
 #include "NTriplesWriter.hh"
+#include "TurtleWriter.hh"
 #include "N3PWriter.hh"
+#include "N3PDictWriter.hh"
+#include "N3PClusteredWriter.hh"
+#include "HdtWriter.hh"
+#include "HdtReader.hh"
+#include "BinaryWriter.hh"
+#include "BinaryReader.hh"
+#include "OutputFile.hh"
+#include "Compression.hh"
+#include "ShardingSink.hh"
+#include "SortingSink.hh"
+#include "DedupSink.hh"
+#include "DocumentGraphSink.hh"
+#include "ParallelReader.hh"
+#include "BatchTranslator.hh"
+#include "Server.hh"
+#include "Follower.hh"
+#include "Checkpoint.hh"
+#include "ErrorLog.hh"
 #include "Util.hh"
 #include "Version.hh"
 
 
+static turtle::TripleSink *createWriter(const turtle::CommandLine &opt, std::ostream &out)
+{
+	const std::string &format = opt.format;
+	
+	if (format == turtle::CommandLine::N3P)
+		return new turtle::N3PWriter(out);
+	else if (format == turtle::CommandLine::N3P_RDIV)
+		return new turtle::N3PWriter(out, true);
+	else if (format == turtle::CommandLine::N3P_DICT)
+		return new turtle::N3PDictWriter(out);
+	else if (format == turtle::CommandLine::N3P_CLUSTERED)
+		return new turtle::N3PClusteredWriter(out, false, opt.maxMemory ? opt.maxMemory : turtle::N3PClusteredWriter::DEFAULT_MAX_MEMORY);
+	else if (format == turtle::CommandLine::NQUADS || format == turtle::CommandLine::NQUADS_DOC)
+		return new turtle::NQuadsWriter(out);
+	else if (format == turtle::CommandLine::TURTLE)
+		return new turtle::TurtleWriter(out);
+	else if (format == turtle::CommandLine::HDT)
+		return new turtle::HdtWriter(out);
+	else if (format == turtle::CommandLine::BINARY)
+		return new turtle::BinaryWriter(out);
+	else
+		return new turtle::NTriplesWriter(out);
+}
+
+static turtle::Parser::Syntax syntax(const turtle::CommandLine &opt, const std::string &input)
+{
+	if (opt.inputFormat == turtle::CommandLine::TRIG)
+		return turtle::Parser::TRIG;
+	else if (opt.inputFormat == turtle::CommandLine::NQUADS)
+		return turtle::Parser::NQUADS;
+	else if (opt.inputFormat == turtle::CommandLine::TURTLE)
+		return turtle::Parser::TURTLE;
+	else
+		return turtle::Parser::syntax(input);
+}
+
+/// Applies --strict-iri, --strict-literals and --canonical.
+static void validation(const turtle::CommandLine &opt, turtle::Parser &parser)
+{
+	if (opt.strictIri)
+		parser.validateIris();
+	if (opt.strictLiterals)
+		parser.validateLiterals();
+	if (opt.canonical)
+		parser.canonicalLiterals();
+}
+
+/// Lookups in the parsers' caches of resolved relative IRIs, reported with the totals.
+static std::atomic<std::uint64_t> resolveCacheHits(0);
+static std::atomic<std::uint64_t> resolveCacheMisses(0);
+
+/// Translates a single input, "-" being stdin. With errors, statements with syntax errors are skipped and logged.
+static void read(const turtle::CommandLine &opt, const std::string &input, turtle::TripleSink *sink, turtle::ErrorLog *errors = nullptr)
+{
+	std::string uri;
+	
+	std::unique_ptr<std::ifstream> in;
+	if (input != "-") {
+		uri = turtle::toUri(input);
+		in = std::unique_ptr<std::ifstream>(new std::ifstream(input, std::ios_base::in | std::ios_base::binary));
+		if (!*in)
+			throw turtle::IOException("error opening \"" + input + "\"");
+	} else {
+		uri = "file:///dev/stdin";
+	}
+	
+	turtle::Uri baseUri(opt.base ? *opt.base : uri);
+	
+	std::istream *stream = in ? in.get() : &std::cin;
+	
+	if (turtle::HdtReader::accepts(*stream)) {
+		turtle::HdtReader reader(stream, sink);
+		reader.read(uri);
+	} else if (turtle::BinaryReader::accepts(*stream)) {
+		turtle::BinaryReader reader(stream, sink);
+		reader.read();
+	} else {
+		turtle::Parser parser(stream, baseUri, sink, syntax(opt, input));
+		validation(opt, parser);
+		if (errors)
+			parser.recover([errors, &input](const turtle::ParseException &e) { errors->add(input, e); });
+		parser.parse();
+		
+		resolveCacheHits += parser.resolveCacheHits();
+		resolveCacheMisses += parser.resolveCacheMisses();
+	}
+}
+
+/// The log of --recover, writing to file or to stderr for "-". Null without --recover.
+static std::unique_ptr<turtle::ErrorLog> errorLog(const turtle::CommandLine &opt, std::unique_ptr<turtle::OutputFile> &file)
+{
+	if (!opt.recover)
+		return std::unique_ptr<turtle::ErrorLog>();
+	
+	if (*opt.recover == "-")
+		return std::unique_ptr<turtle::ErrorLog>(new turtle::ErrorLog(std::cerr));
+	
+	file = std::unique_ptr<turtle::OutputFile>(new turtle::OutputFile(*opt.recover));
+	
+	return std::unique_ptr<turtle::ErrorLog>(new turtle::ErrorLog(file->stream()));
+}
+
+static void reportSkipped(const turtle::CommandLine &opt, turtle::ErrorLog *errors)
+{
+	std::uint64_t skipped = errors->count();
+	
+	std::cerr << "skipped " << skipped << " statements with errors";
+	if (skipped && *opt.recover != "-")
+		std::cerr << ", see " << *opt.recover;
+	std::cerr << std::endl;
+}
+
+/// Puts the sinks for --sort, --unique, --dedup and nq-doc in front of sink.
+static std::unique_ptr<turtle::TripleSink> chain(const turtle::CommandLine &opt, std::unique_ptr<turtle::TripleSink> &&sink, turtle::SortingSink **sorting = nullptr, turtle::DedupSink **dedup = nullptr)
+{
+	if (opt.sort) {
+		turtle::SortingSink *sorter = new turtle::SortingSink(std::move(sink), opt.unique, opt.maxMemory ? opt.maxMemory : turtle::SortingSink::DEFAULT_MAX_MEMORY);
+		sink = std::unique_ptr<turtle::TripleSink>(sorter);
+		if (sorting)
+			*sorting = sorter;
+	}
+	
+	if (opt.dedup) {
+		turtle::DedupSink *d = new turtle::DedupSink(std::move(sink), opt.maxMemory);
+		sink = std::unique_ptr<turtle::TripleSink>(d);
+		if (dedup)
+			*dedup = d;
+	}
+	
+	if (opt.format == turtle::CommandLine::NQUADS_DOC)
+		sink = std::unique_ptr<turtle::TripleSink>(new turtle::DocumentGraphSink(std::move(sink)));
+	
+	return std::move(sink);
+}
+
+static std::string extension(const std::string &format)
+{
+	if (format == turtle::CommandLine::NQUADS_DOC)
+		return turtle::CommandLine::NQUADS;
+	else if (format == turtle::CommandLine::N3P_RDIV || format == turtle::CommandLine::N3P_DICT || format == turtle::CommandLine::N3P_CLUSTERED)
+		return turtle::CommandLine::N3P;
+	else if (format == turtle::CommandLine::BINARY)
+		return "bin";
+	else
+		return format;
+}
+
+struct Input {
+	std::string path;
+	std::string name; // relative to the directory given on the command line, used by -O
+};
+
+/// Adds path to inputs, or when it is a directory, the files with a known extension below it.
+static void expand(const std::string &path, std::vector<Input> &inputs)
+{
+	if (path != "-" && turtle::isDirectory(path)) {
+		std::vector<std::string> files;
+		turtle::listFiles(path, files);
+		
+		std::string::size_type prefix = path.back() == '/' ? path.length() : path.length() + 1;
+		for (const std::string &file : files) {
+			std::string::size_type dot = file.find_last_of("./");
+			std::string ext = dot != std::string::npos && file[dot] == '.' ? file.substr(dot + 1) : std::string();
+			if (ext == "ttl" || ext == "trig" || ext == "nt" || ext == "nq" || ext == "hdt" || ext == "bin")
+				inputs.push_back(Input { file, file.substr(prefix) });
+		}
+	} else {
+		std::string::size_type slash = path.find_last_of('/');
+		inputs.push_back(Input { path, slash == std::string::npos ? path : path.substr(slash + 1) });
+	}
+}
+
+/// The options for one of threads jobs running at once: they share --max-memory, or the default budget of --sort and n3p-clustered.
+static turtle::CommandLine perJob(const turtle::CommandLine &opt, unsigned threads)
+{
+	turtle::CommandLine o = opt;
+	
+	std::size_t memory = opt.maxMemory;
+	if (!memory && !opt.dedup) { // --dedup has no limit by default
+		if (opt.sort)
+			memory = turtle::SortingSink::DEFAULT_MAX_MEMORY;
+		else if (opt.format == turtle::CommandLine::N3P_CLUSTERED)
+			memory = turtle::N3PClusteredWriter::DEFAULT_MAX_MEMORY;
+	}
+	
+	if (memory)
+		o.maxMemory = std::max<std::size_t>(memory / std::max(threads, 1u), 1);
+	
+	return o;
+}
+
+/// Translates every input to a file of its own in opt.outputDirectory, see BatchTranslator.
+static int translateAll(const turtle::CommandLine &opt, const std::vector<Input> &inputs)
+{
+	const std::string &directory = *opt.outputDirectory;
+	
+	std::vector<turtle::BatchTranslator::Job> jobs;
+	std::map<std::string, std::string> outputs;
+	for (const Input &input : inputs) {
+		if (input.path == "-") {
+			std::cerr << "-O can not read stdin" << std::endl;
+			
+			return -1;
+		}
+		
+		std::string::size_type dot = input.name.find_last_of("./");
+		std::string name = dot != std::string::npos && input.name[dot] == '.' ? input.name.substr(0, dot) : input.name;
+		std::string output = directory + (directory.back() == '/' ? "" : "/") + name + "." + extension(opt.format);
+		
+		auto i = outputs.insert(std::make_pair(output, input.path));
+		if (!i.second) {
+			std::cerr << "\"" << i.first->second << "\" and \"" << input.path << "\" would both be written to \"" << output << "\"" << std::endl;
+			
+			return -1;
+		}
+		
+		jobs.push_back(turtle::BatchTranslator::Job { input.path, output });
+	}
+	
+	if (!turtle::makeDirectories(directory)) {
+		std::cerr << "could not create directory \"" << directory << "\"" << std::endl;
+		
+		return -1;
+	}
+	
+	std::unique_ptr<turtle::OutputFile> errorFile;
+	std::unique_ptr<turtle::ErrorLog> errors;
+	try {
+		errors = errorLog(opt, errorFile);
+	} catch (turtle::IOException &e) {
+		std::cerr << e.what() << std::endl;
+		
+		return -1;
+	}
+	
+	unsigned threads = opt.jobs ? opt.jobs : std::max(1u, std::thread::hardware_concurrency());
+	turtle::CommandLine job = perJob(opt, threads);
+	
+	turtle::ErrorLog *log = errors.get();
+	turtle::BatchTranslator translator(
+		[&job](std::ostream &out) { return chain(job, std::unique_ptr<turtle::TripleSink>(createWriter(job, out))); },
+		[&opt, log](const std::string &input, turtle::TripleSink *sink) { read(opt, input, sink, log); }
+	);
+	
+	typedef std::chrono::high_resolution_clock Clock;
+	
+	Clock::time_point start = Clock::now();
+	
+	std::vector<turtle::BatchTranslator::Result> results = translator.run(jobs, threads);
+	
+	Clock::duration d = Clock::now() - start;
+	double ms = static_cast<double>(1000 * d.count() * Clock::duration::period::num) / static_cast<double>(Clock::duration::period::den);
+	
+	std::string summary = directory + (directory.back() == '/' ? "" : "/") + "summary.tsv";
+	std::ofstream out(summary);
+	turtle::BatchTranslator::summary(out, results);
+	out.close();
+	if (!out)
+		std::cerr << "error writing \"" << summary << "\"" << std::endl;
+	
+	std::uint64_t count = 0;
+	unsigned failed = 0;
+	for (const turtle::BatchTranslator::Result &r : results) {
+		count += r.count;
+		if (!r.error.empty()) {
+			std::cerr << r.input << ": " << r.error << std::endl;
+			failed++;
+		}
+	}
+	
+	std::streamsize p = std::cerr.precision();
+	std::cerr << "Done: translated " << count << " triples from " << (results.size() - failed) << " files in " << std::fixed << std::setprecision(1) << ms << " ms" << std::setprecision(p) << std::endl;
+	if (failed)
+		std::cerr << failed << " files failed, see " << summary << std::endl;
+	if (errors)
+		reportSkipped(opt, errors.get());
+	
+	return failed || !out ? -1 : 0;
+}
+
+/// Translates the requests on the socket opt.serve until the process is killed.
+static int serve(const turtle::CommandLine &opt)
+{
+	unsigned threads = opt.jobs ? opt.jobs : std::max(1u, std::thread::hardware_concurrency());
+	
+	auto handler = [&opt, threads](const turtle::Server::Request &request, std::ostream &out) {
+		turtle::CommandLine o = opt;
+		
+		if (!request.format.empty()) {
+			if (!turtle::CommandLine::outputFormat(request.format))
+				throw std::runtime_error("unknown format " + request.format);
+			o.format = request.format;
+		}
+		
+		if (!request.base.empty())
+			o.base = request.base;
+		
+		o = perJob(o, threads);
+		
+		std::unique_ptr<turtle::TripleSink> sink = chain(o, std::unique_ptr<turtle::TripleSink>(createWriter(o, out)));
+		sink->start();
+		read(o, request.input, sink.get());
+		sink->end();
+	};
+	
+	try {
+		turtle::Server server(*opt.serve, threads, handler);
+		std::cerr << "listening on " << *opt.serve << std::endl;
+		server.run();
+	} catch (turtle::IOException &e) {
+		std::cerr << e.what() << std::endl;
+		
+		return -1;
+	}
+	
+	return 0;
+}
+
+/// Has the server on socket opt.connect translate the inputs, reports the time every request takes.
+static int connect(const turtle::CommandLine &opt)
+{
+	typedef std::chrono::high_resolution_clock Clock;
+	
+	try {
+		std::unique_ptr<turtle::OutputFile> file;
+		if (opt.output && *opt.output != "-")
+			file = std::unique_ptr<turtle::OutputFile>(new turtle::OutputFile(*opt.output));
+		
+		std::ostream &out = file ? file->stream() : std::cout;
+		
+		for (const std::string &input : opt.inputs) {
+			if (input == "-") {
+				std::cerr << "--connect can not send stdin" << std::endl;
+				
+				return -1;
+			}
+			
+			Clock::time_point start = Clock::now();
+			
+			turtle::Server::Request request { turtle::absolutePath(input), opt.format, opt.base ? *opt.base : std::string() };
+			std::string status = turtle::Server::request(*opt.connect, request, out);
+			
+			Clock::duration d = Clock::now() - start;
+			double ms = static_cast<double>(1000 * d.count() * Clock::duration::period::num) / static_cast<double>(Clock::duration::period::den);
+			
+			if (!status.empty()) {
+				std::cerr << input << ": " << status << std::endl;
+				
+				return -1;
+			}
+			
+			std::streamsize p = std::cerr.precision();
+			std::cerr << "translated " << input << " in " << std::fixed << std::setprecision(2) << ms << " ms" << std::setprecision(p) << std::endl;
+		}
+		
+		out.flush();
+		if (file)
+			file->close();
+	} catch (std::runtime_error &e) {
+		std::cerr << e.what() << std::endl;
+		
+		return -1;
+	}
+	
+	return 0;
+}
+
+/// Whether the output is written to a compressed file, which can not be cut off at a checkpoint.
+static bool compressedOutput(const turtle::CommandLine &opt)
+{
+	turtle::CompressingStreamBuf::Codec codec;
+	
+	return opt.output && *opt.output != "-" && turtle::CompressingStreamBuf::codec(*opt.output, &codec);
+}
+
+/// Opens the output of a checkpointed run. When resuming, output written after the checkpoint is cut off first.
+static std::unique_ptr<turtle::OutputFile> openOutput(const turtle::CommandLine &opt, const turtle::Checkpoint *resumed)
+{
+	if (!opt.output || *opt.output == "-")
+		return std::unique_ptr<turtle::OutputFile>();
+	
+	if (resumed && !resumed->output)
+		throw turtle::IOException("the checkpoint does not record the size of \"" + *opt.output + "\", it can not be resumed");
+	
+	if (resumed && !turtle::truncate(*opt.output, *resumed->output))
+		throw turtle::IOException("error truncating \"" + *opt.output + "\"");
+	
+	return std::unique_ptr<turtle::OutputFile>(new turtle::OutputFile(*opt.output, resumed != nullptr));
+}
+
+/// Size of the (flushed) output, for the checkpoint. Unknown for standard output and compressed files.
+static turtle::Optional<std::uint64_t> outputSize(const turtle::CommandLine &opt, const turtle::OutputFile *file)
+{
+	if (!file || file->compressed())
+		return turtle::Optional<std::uint64_t>();
+	
+	return turtle::fileSize(*opt.output);
+}
+
+static void reportParseError(const turtle::ParseException &e)
+{
+	if (e.line() == -1)
+		std::cerr << "parse error: " << e.what() << std::endl;
+	else
+		std::cerr << "parse error at line " << e.line() << ": " << e.what() << std::endl;
+}
+
+static volatile std::sig_atomic_t stopFollowing = 0;
+
+static void stopFollowingHandler(int)
+{
+	stopFollowing = 1;
+}
+
+/// Translates what is appended to the input until interrupted, keeping a checkpoint to continue from after a restart.
+static int follow(const turtle::CommandLine &opt)
+{
+	if (opt.inputs.size() != 1 || opt.inputs[0] == "-" || !opt.manifests.empty()) {
+		std::cerr << "--follow needs a single input file" << std::endl;
+		
+		return -1;
+	}
+	
+	if (opt.sort || opt.shards > 1 || opt.outputDirectory) {
+		std::cerr << "--follow can not be combined with --sort, -shards or -O" << std::endl;
+		
+		return -1;
+	}
+	
+	// a restart appends to the output, formats with a prologue or declarations would repeat them mid-file
+	if (opt.format != turtle::CommandLine::NTRIPLES && opt.format != turtle::CommandLine::NQUADS && opt.format != turtle::CommandLine::NQUADS_DOC) {
+		std::cerr << "--follow needs output format nt, nq or nq-doc" << std::endl;
+		
+		return -1;
+	}
+	
+	if (compressedOutput(opt)) {
+		std::cerr << "--follow can not write compressed output, it could not be cut off at the checkpoint after a restart" << std::endl;
+		
+		return -1;
+	}
+	
+	const std::string &input = opt.inputs[0];
+	if (!turtle::exists(input)) {
+		std::cerr << "\"" << input << "\" not found" << std::endl;
+		
+		return -1;
+	}
+	
+	std::string checkpointFile = opt.checkpoint ? *opt.checkpoint : input + ".checkpoint";
+	
+	try {
+		turtle::Checkpoint checkpoint;
+		bool resumed = turtle::Checkpoint::load(checkpointFile, checkpoint);
+		
+		std::unique_ptr<turtle::OutputFile> file = openOutput(opt, resumed ? &checkpoint : nullptr);
+		
+		std::ostream &out = file ? file->stream() : std::cout;
+		
+		std::unique_ptr<turtle::TripleSink> sink = chain(opt, std::unique_ptr<turtle::TripleSink>(createWriter(opt, out)));
+		sink->start();
+		
+		turtle::Follower follower(input, turtle::Uri(opt.base ? *opt.base : turtle::toUri(input)), sink.get(), syntax(opt, input));
+		validation(opt, follower.parser());
+		if (resumed) {
+			follower.restore(checkpoint);
+			std::cerr << "following " << input << " from byte " << checkpoint.offset << " (line " << checkpoint.line << ")" << std::endl;
+		} else {
+			std::cerr << "following " << input << std::endl;
+		}
+		
+		std::signal(SIGINT, stopFollowingHandler);
+		std::signal(SIGTERM, stopFollowingHandler);
+		
+		while (!stopFollowing) {
+			if (follower.poll()) {
+				out.flush();
+				checkpoint = follower.checkpoint();
+				checkpoint.output = outputSize(opt, file.get());
+				checkpoint.save(checkpointFile);
+			} else {
+				std::this_thread::sleep_for(std::chrono::milliseconds(200));
+			}
+		}
+		
+		sink->end();
+		out.flush();
+		if (file)
+			file->close();
+		
+		std::cerr << "stopped at byte " << follower.offset() << ", translated " << follower.checkpoint().count << " triples" << std::endl;
+	} catch (turtle::ParseException &e) {
+		reportParseError(e);
+		
+		return -1;
+	} catch (std::runtime_error &e) {
+		std::cerr << e.what() << std::endl;
+		
+		return -1;
+	}
+	
+	return 0;
+}
+
+/// Translates the inputs one after the other, saving a checkpoint after every piece of at most Follower::MAX_READ bytes.
+/// After a parse error the input can be fixed and the run continued with --resume.
+static int translateCheckpointed(const turtle::CommandLine &opt)
+{
+	if (opt.inputs.empty() || !opt.manifests.empty() || std::find(opt.inputs.begin(), opt.inputs.end(), "-") != opt.inputs.end()) {
+		std::cerr << "--checkpoint and --resume need input files" << std::endl;
+		
+		return -1;
+	}
+	
+	if (opt.sort || opt.dedup || opt.shards > 1 || opt.outputDirectory || opt.jobs > 1) {
+		std::cerr << "--checkpoint and --resume can not be combined with --sort, --dedup, -shards, -O or -j" << std::endl;
+		
+		return -1;
+	}
+	
+	// only line based output can be continued by appending
+	if (opt.format != turtle::CommandLine::NTRIPLES && opt.format != turtle::CommandLine::NQUADS && opt.format != turtle::CommandLine::NQUADS_DOC) {
+		std::cerr << "--checkpoint and --resume need output format nt, nq or nq-doc" << std::endl;
+		
+		return -1;
+	}
+	
+	// output written after the checkpoint is cut off when resuming
+	if (!opt.output || *opt.output == "-" || compressedOutput(opt)) {
+		std::cerr << "--checkpoint and --resume need an uncompressed output file (-o)" << std::endl;
+		
+		return -1;
+	}
+	
+	for (const std::string &input : opt.inputs) {
+		std::ifstream in(input, std::ios_base::in | std::ios_base::binary);
+		if (!in) {
+			std::cerr << "\"" << input << "\" not found" << std::endl;
+			
+			return -1;
+		}
+		if (turtle::HdtReader::accepts(in) || turtle::BinaryReader::accepts(in)) {
+			std::cerr << "\"" << input << "\" is not a text file, it can not be checkpointed" << std::endl;
+			
+			return -1;
+		}
+	}
+	
+	std::string checkpointFile = opt.checkpoint ? *opt.checkpoint : opt.inputs[0] + ".checkpoint";
+	
+	try {
+		turtle::Checkpoint checkpoint;
+		std::size_t first = 0;
+		
+		if (opt.resume) {
+			if (!turtle::Checkpoint::load(checkpointFile, checkpoint)) {
+				std::cerr << "no checkpoint to resume from in \"" << checkpointFile << "\"" << std::endl;
+				
+				return -1;
+			}
+			
+			first = static_cast<std::size_t>(std::find(opt.inputs.begin(), opt.inputs.end(), checkpoint.input) - opt.inputs.begin());
+			if (first == opt.inputs.size()) {
+				std::cerr << "the checkpoint is for \"" << checkpoint.input << "\", which is not an input" << std::endl;
+				
+				return -1;
+			}
+		}
+		
+		std::unique_ptr<turtle::OutputFile> file = openOutput(opt, opt.resume ? &checkpoint : nullptr);
+		
+		std::ostream &out = file ? file->stream() : std::cout;
+		
+		std::unique_ptr<turtle::TripleSink> sink = chain(opt, std::unique_ptr<turtle::TripleSink>(createWriter(opt, out)));
+		sink->start();
+		
+		std::uint64_t before = opt.resume ? checkpoint.count : 0; // triples translated by earlier runs
+		
+		for (std::size_t i = first; i < opt.inputs.size(); i++) {
+			const std::string &input = opt.inputs[i];
+			
+			turtle::Follower follower(input, turtle::Uri(opt.base ? *opt.base : turtle::toUri(input)), sink.get(), syntax(opt, input));
+			validation(opt, follower.parser());
+			if (opt.resume && i == first) {
+				follower.restore(checkpoint);
+				std::cerr << "resuming " << input << " from byte " << checkpoint.offset << " (line " << checkpoint.line << ")" << std::endl;
+			}
+			
+			bool save = !opt.resume || i != first; // a fresh input starts with a checkpoint, so a parse error in its first piece can be resumed
+			while (save || follower.poll(true)) {
+				out.flush();
+				checkpoint = follower.checkpoint();
+				checkpoint.count = before + sink->count();
+				checkpoint.output = outputSize(opt, file.get());
+				checkpoint.save(checkpointFile);
+				save = false;
+			}
+		}
+		
+		sink->end();
+		out.flush();
+		if (file)
+			file->close();
+		
+		std::remove(checkpointFile.c_str());
+		
+		if (opt.resume)
+			std::cerr << "translated " << before + sink->count() << " triples" << std::endl;
+	} catch (turtle::ParseException &e) {
+		reportParseError(e);
+		std::cerr << "fix the input and continue with --resume" << (opt.checkpoint ? " --checkpoint=" + checkpointFile : std::string()) << std::endl;
+		
+		return -1;
+	} catch (std::runtime_error &e) {
+		std::cerr << e.what() << std::endl;
+		
+		return -1;
+	}
+	
+	return 0;
+}
+
 int main(int argc, char *argv[])
 {
 	turtle::useBinaryStreams();
@@ -49,31 +699,96 @@ int main(int argc, char *argv[])
 	
 	if (opt.error || opt.help) {
 		std::cerr << "cturtle version " << CTURTLE_VERSION_STR << std::endl;
-		std::cerr << "\nUsage: cturtle [-b=base-uri] [-o=output-file] [-f=(nt|n3p|n3p-rdiv)] [input-files]" << std::endl;
+		std::cerr << "\nUsage: cturtle [-b=base-uri] [-i=(ttl|trig|nq)] [-o=output-file|-O=output-directory] [-f=(nt|nq|nq-doc|ttl|n3p|n3p-rdiv|n3p-dict|n3p-clustered|hdt|binary)] [-j=n] [-shards=n] [-shard-key=(subject|predicate)] [--sort|--unique] [--dedup] [--max-memory=size] [-@=manifest] [--strict-iri] [--strict-literals] [--canonical] [--recover=errors-file] [--follow] [--checkpoint=file] [--resume] [--serve=socket|--connect=socket] [input-files]" << std::endl;
 		
 		return opt.error ? -1 : 0;
 	}
 	
-	std::unique_ptr<std::ostream> out;
-	if (opt.output && *opt.output != "-") {
-		out = std::unique_ptr<std::ostream>(new std::ofstream(*opt.output));
+	if (opt.shards > 1 && (!opt.output || *opt.output == "-")) {
+		std::cerr << "-shards requires an output file" << std::endl;
+		
+		return -1;
+	}
+	
+	if (opt.follow)
+		return follow(opt);
+	
+	if (opt.checkpoint || opt.resume)
+		return translateCheckpointed(opt);
+	
+	if (opt.serve)
+		return serve(opt);
+	
+	if (opt.connect)
+		return connect(opt);
+	
+	if (opt.outputDirectory && (opt.output || opt.shards > 1)) {
+		std::cerr << "-O can not be combined with -o or -shards" << std::endl;
 		
-		if (!*out) {
-			std::cerr << "error opening \"" << *opt.output << "\"" << std::endl;
+		return -1;
+	}
+	
+	std::vector<Input> inputs;
+	try {
+		for (const std::string &manifest : opt.manifests) {
+			std::ifstream in(manifest);
+			if (!in) {
+				std::cerr << "error opening \"" << manifest << "\"" << std::endl;
+				
+				return -1;
+			}
 			
-			return -1;
+			std::string line;
+			while (std::getline(in, line)) {
+				if (!line.empty() && line.back() == '\r')
+					line.pop_back();
+				if (!line.empty() && line[0] != '#')
+					expand(line, inputs);
+			}
 		}
+		
+		for (const std::string &input : opt.inputs)
+			expand(input, inputs);
+	} catch (std::runtime_error &e) {
+		std::cerr << e.what() << std::endl;
+		
+		return -1;
 	}
 	
-	turtle::TripleSink *s;
-	if (opt.format == turtle::CommandLine::N3P)
-		s = new turtle::N3PWriter(out ? *out : std::cout);
-	else if (opt.format == turtle::CommandLine::N3P_RDIV)
-		s = new turtle::N3PWriter(out ? *out : std::cout, true);
-	else
-		s = new turtle::NTriplesWriter(out ? *out : std::cout);
+	if (opt.outputDirectory)
+		return translateAll(opt, inputs);
+	
+	std::vector<std::unique_ptr<turtle::OutputFile>> files;
+	std::unique_ptr<turtle::TripleSink> sink;
+	turtle::SortingSink *sorting = nullptr;
+	turtle::DedupSink *dedup = nullptr;
+	std::unique_ptr<turtle::OutputFile> errorFile;
+	std::unique_ptr<turtle::ErrorLog> errors;
+	try {
+		errors = errorLog(opt, errorFile);
 		
-	std::unique_ptr<turtle::TripleSink> sink(s);
+		if (opt.shards > 1) {
+			std::vector<std::unique_ptr<turtle::TripleSink>> sinks;
+			for (unsigned i = 0; i < opt.shards; i++) {
+				files.emplace_back(new turtle::OutputFile(turtle::OutputFile::numbered(*opt.output, i)));
+				sinks.emplace_back(createWriter(opt, files.back()->stream()));
+			}
+			
+			turtle::ShardingSink::Key key = opt.shardKey == turtle::CommandLine::PREDICATE ? turtle::ShardingSink::PREDICATE : turtle::ShardingSink::SUBJECT;
+			sink = std::unique_ptr<turtle::TripleSink>(new turtle::ShardingSink(std::move(sinks), key));
+		} else if (opt.output && *opt.output != "-") {
+			files.emplace_back(new turtle::OutputFile(*opt.output));
+			sink = std::unique_ptr<turtle::TripleSink>(createWriter(opt, files.back()->stream()));
+		} else {
+			sink = std::unique_ptr<turtle::TripleSink>(createWriter(opt, std::cout));
+		}
+		
+		sink = chain(opt, std::move(sink), &sorting, &dedup);
+	} catch (turtle::IOException &e) {
+		std::cerr << e.what() << std::endl;
+		
+		return -1;
+	}
 	
 	typedef std::chrono::high_resolution_clock Clock;
 	
@@ -81,11 +796,20 @@ int main(int argc, char *argv[])
 	
 	sink->start();
 	
-	for (std::string input : opt.inputs) {
+	std::vector<std::string> paths;
+	for (const Input &input : inputs)
+		paths.push_back(input.path);
+	
+	std::unique_ptr<turtle::ParallelReader> pool;
+	if (opt.jobs > 1 && paths.size() > 1)
+		pool = std::unique_ptr<turtle::ParallelReader>(new turtle::ParallelReader(paths, opt.jobs, [&opt, &errors](const std::string &input, turtle::TripleSink *s) { read(opt, input, s, errors.get()); }));
+	
+	for (std::size_t i = 0; i < paths.size(); i++) {
+		
+		const std::string &input = paths[i];
 		
 		std::string uri;
 		
-		std::unique_ptr<std::ifstream> in;
 		if (input != "-") {
 			if (!turtle::exists(input)) {
 				std::cerr << "\"" << input << "\" not found" << std::endl;
@@ -95,47 +819,76 @@ int main(int argc, char *argv[])
 			}
 			
 			uri = turtle::toUri(input);
-			in = std::unique_ptr<std::ifstream>(new std::ifstream(input, std::ios_base::in | std::ios_base::binary));
-			if (!*in) {
-				std::cerr << "error opening \"" << input << "\"" << std::endl;
-				sink->end();
-				
-				return -1;
-			}
 		} else {
 			uri = "file:///dev/stdin";
 		}
 		
 		std::cerr << "translating " << uri << std::endl;
 		
-		turtle::Uri baseUri(opt.base ? *opt.base : uri);
-		
-		turtle::Parser parser(in ? in.get() : &std::cin, baseUri, sink.get());
 		try {
-			parser.parse();
+			if (pool)
+				pool->replay(i, sink.get());
+			else
+				read(opt, input, sink.get(), errors.get());
 		} catch (turtle::ParseException &e) {
 			if (e.line() == -1)
 				std::cerr << "parse error: " << e.what() << std::endl;
 			else
 				std::cerr << "parse error at line " << e.line() << ": " << e.what() << std::endl;
 			
+			return -1;
+		} catch (turtle::BinaryFormatException &e) {
+			std::cerr << "error reading " << uri << ": " << e.what() << std::endl;
+			
+			return -1;
+		} catch (std::runtime_error &e) { // IOException, AtomCollisionException from the writer
+			std::cerr << e.what() << std::endl;
+			
 			return -1;
 		}
 	}
 	
-	sink->end();
+	pool.reset();
 	
-	Clock::duration d = Clock::now() - start;
+	try {
+		sink->end();
+		for (auto &file : files)
+			file->close();
+	} catch (std::runtime_error &e) { // IOException, CompressionException from a writer flushing
+		std::cerr << e.what() << std::endl;
+		
+		return -1;
+	}
 	
-	double ms = static_cast<double>(1000 * d.count() * Clock::duration::period::num) / static_cast<double>(Clock::duration::period::den);
+	if (dedup)
+		std::cerr << "removed " << dedup->duplicates() << (dedup->approximate() ? " (approximately)" : "") << " duplicate triples" << std::endl;
+	
+	if (sorting && opt.unique)
+		std::cerr << "removed " << sorting->duplicates() << " duplicate triples" << std::endl;
+	
+	if (errors)
+		reportSkipped(opt, errors.get());
 	
 	unsigned count = sink->count();
 	
+	sink.reset();
+	files.clear();
+	
+	Clock::duration d = Clock::now() - start;
+	
+	double ms = static_cast<double>(1000 * d.count() * Clock::duration::period::num) / static_cast<double>(Clock::duration::period::den);
+	
 	if (count && ms > 0.0) {
 		std::streamsize p = std::cerr.precision();
 		std::cerr << "Done: translated " << count << " triples in " << std::fixed << std::setprecision(1) << ms << std::setprecision(0) << " ms (" << (1000.0 * count / ms) << " triples/s)" << std::setprecision(p) <<  std::endl;
 	} else
 		std::cerr << "Done: translated " << count << " triples" << std::endl;
+	
+	std::uint64_t lookups = resolveCacheHits + resolveCacheMisses;
+	if (lookups) {
+		std::streamsize p = std::cerr.precision();
+		std::cerr << "resolved " << lookups << " relative IRIs, " << std::fixed << std::setprecision(1) << (100.0 * resolveCacheHits / lookups) << "% from cache" << std::setprecision(p) << std::endl;
+	}
 		
 	return 0;
 
@@ -23,6 +23,24 @@ namespace turtle {
 	const std::string BooleanLiteral::TYPE = "http://www.w3.org/2001/XMLSchema#boolean";
 	const std::string DoubleLiteral::TYPE  = "http://www.w3.org/2001/XMLSchema#double";
 	const std::string DecimalLiteral::TYPE = "http://www.w3.org/2001/XMLSchema#decimal";
+	
+	namespace {
+		// constants, never freed, so terms refer to them without counting
+		const Interned INTEGER_DATATYPE(IntegerLiteral::TYPE);
+		const Interned STRING_DATATYPE(StringLiteral::TYPE);
+		const Interned BOOLEAN_DATATYPE(BooleanLiteral::TYPE);
+		const Interned DOUBLE_DATATYPE(DoubleLiteral::TYPE);
+		const Interned DECIMAL_DATATYPE(DecimalLiteral::TYPE);
+		const Interned NO_LANGUAGE_TAG { std::string() };
+	}
+	
+	const Interned *const IntegerLiteral::DATATYPE = &INTEGER_DATATYPE;
+	const Interned *const StringLiteral::DATATYPE  = &STRING_DATATYPE;
+	const Interned *const BooleanLiteral::DATATYPE = &BOOLEAN_DATATYPE;
+	const Interned *const DoubleLiteral::DATATYPE  = &DOUBLE_DATATYPE;
+	const Interned *const DecimalLiteral::DATATYPE = &DECIMAL_DATATYPE;
+	
+	const Interned *const StringLiteral::NO_LANGUAGE = &NO_LANGUAGE_TAG;
 
 	const std::string RDF::NS    = std::string("http://www.w3.org/1999/02/22-rdf-syntax-ns#");
 	const URIResource RDF::type  = URIResource("http://www.w3.org/1999/02/22-rdf-syntax-ns#type");
@@ -23,6 +23,8 @@
 #include <vector>
 #include <utility>
 
+#include "Interned.hh"
+#include "WellKnown.hh"
 
 namespace turtle {
 
@@ -67,24 +69,51 @@ namespace turtle {
 	};
 
 
+	///
+	/// An IRI, either whole or, for a prefixed name, as a namespace entry of
+	/// the parser followed by a local name. A split IRI is only joined when uri() is
+	/// called, so writers that print namespaceEntry() and localName() never
+	/// copy the namespace.
+	///
 	class URIResource : public Resource {
-		std::string m_uri;
+		InternedRef m_namespace; // null if the IRI is whole
+		std::string m_local;
+		mutable std::string m_uri;   // joined on demand if split
+		WellKnown::Iri m_wellKnown;
 	public:
-		explicit URIResource(const std::string &uri) : Resource(), m_uri(uri) {}
-		explicit URIResource(std::string &&uri)      : Resource(), m_uri(std::move(uri)) {}
+		explicit URIResource(const std::string &uri) : Resource(), m_namespace(), m_local(), m_uri(uri), m_wellKnown(WellKnown::lookup(m_uri)) {}
+		explicit URIResource(std::string &&uri)      : Resource(), m_namespace(), m_local(), m_uri(std::move(uri)), m_wellKnown(WellKnown::lookup(m_uri)) {}
 		
-		const std::string &uri() const { return m_uri; }
+		URIResource(const InternedRef &ns, const std::string &local) : Resource(), m_namespace(ns), m_local(local), m_uri(), m_wellKnown(WellKnown::lookup(ns->value(), m_local)) {}
+		URIResource(const InternedRef &ns, std::string &&local)      : Resource(), m_namespace(ns), m_local(std::move(local)), m_uri(), m_wellKnown(WellKnown::lookup(ns->value(), m_local)) {}
+		
+		const std::string &uri() const
+		{
+			if (m_namespace.get() && m_uri.empty())
+				m_uri.append(m_namespace->value()).append(m_local);
+			
+			return m_uri;
+		}
+		
+		/// The namespace of a prefixed name, null if the IRI is whole.
+		const InternedRef &namespaceEntry() const { return m_namespace; }
+		
+		/// The part of the IRI after namespaceEntry(), the whole IRI if there is no namespace.
+		const std::string &localName() const { return m_namespace.get() ? m_local : m_uri; }
+		
+		/// Which well-known IRI this is, so sinks can switch on it instead of comparing strings.
+		WellKnown::Iri wellKnown() const { return m_wellKnown; }
 		
 		std::ostream &print(std::ostream &out) const override
 		{
-			out << '<' << m_uri << '>';
+			out << '<' << uri() << '>';
 			
 			return out;
 		}
 		
 		URIResource *clone() const override
 		{
-			return new URIResource(m_uri);
+			return m_namespace.get() ? new URIResource(m_namespace, m_local) : new URIResource(m_uri);
 		}
 		
 		void visit(N3NodeVisitor &visitor) const override
@@ -237,16 +266,18 @@ namespace turtle {
 	class Literal : public N3Node {
 	protected:
 		std::string m_lexical;
-		const std::string *m_datatype;
+		InternedRef m_datatype;
 		
-		Literal(const std::string &lexical, const std::string *datatype)     : N3Node(), m_lexical(lexical), m_datatype(datatype) {}
-		Literal(std::string &&lexical, const std::string *datatype) noexcept : N3Node(), m_lexical(std::move(lexical)), m_datatype(datatype) {}
+		Literal(const std::string &lexical, const InternedRef &datatype)     : N3Node(), m_lexical(lexical), m_datatype(datatype) {}
+		Literal(std::string &&lexical, const InternedRef &datatype) noexcept : N3Node(), m_lexical(std::move(lexical)), m_datatype(datatype) {}
 		
 	public:
 		
 		const std::string &lexical() const { return m_lexical; }
 		
-		const std::string &datatype() const { return *m_datatype; }
+		const std::string &datatype() const { return m_datatype->value(); }
+		
+		const InternedRef &datatypeEntry() const { return m_datatype; }
 		
 		void visit(N3NodeVisitor &visitor) const override
 		{
@@ -257,9 +288,10 @@ namespace turtle {
 	
 	class BooleanLiteral : public Literal {
 	public:
-		explicit BooleanLiteral(const std::string &value) : Literal(value, &TYPE) {}
+		explicit BooleanLiteral(const std::string &value) : Literal(value, InternedRef(DATATYPE)) {}
 		
 		static const std::string TYPE;
+		static const Interned *const DATATYPE;
 		
 		static const BooleanLiteral VALUE_TRUE;
 		static const BooleanLiteral VALUE_FALSE;
@@ -289,8 +321,9 @@ namespace turtle {
 	class IntegerLiteral : public Literal {
 	public:
 		static const std::string TYPE;
+		static const Interned *const DATATYPE;
 		
-		explicit IntegerLiteral(const std::string &value) : Literal(value, &TYPE) {}
+		explicit IntegerLiteral(const std::string &value) : Literal(value, InternedRef(DATATYPE)) {}
 		
 		std::ostream &print(std::ostream &out) const override
 		{
@@ -313,8 +346,9 @@ namespace turtle {
 	class DoubleLiteral : public Literal {
 	public:
 		static const std::string TYPE;
+		static const Interned *const DATATYPE;
 		
-		explicit DoubleLiteral(const std::string &value) : Literal(value, &TYPE) {}
+		explicit DoubleLiteral(const std::string &value) : Literal(value, InternedRef(DATATYPE)) {}
 		
 		std::ostream &print(std::ostream &out) const override
 		{
@@ -337,8 +371,9 @@ namespace turtle {
 	class DecimalLiteral : public Literal {
 	public:
 		static const std::string TYPE;
+		static const Interned *const DATATYPE;
 		
-		explicit DecimalLiteral(const std::string &value) : Literal(value, &TYPE) {}
+		explicit DecimalLiteral(const std::string &value) : Literal(value, InternedRef(DATATYPE)) {}
 		
 		std::ostream &print(std::ostream &out) const override
 		{
@@ -360,15 +395,27 @@ namespace turtle {
 
 	class StringLiteral : public Literal {
 		
-		std::string m_language;
+		InternedRef m_language; // the empty tag when there is none
+		
+		static InternedRef entry(const std::string &tag) { return tag.empty() ? InternedRef(NO_LANGUAGE) : InternedRef::make(tag); }
 
 	public:
 		static const std::string TYPE;
+		static const Interned *const DATATYPE;
+		
+		/// The entry of the empty language tag.
+		static const Interned *const NO_LANGUAGE;
 		
-		explicit StringLiteral(const std::string &value, const std::string &language = std::string()) : Literal(value, &TYPE), m_language(language) {}
-		explicit StringLiteral(std::string &&value, std::string &&language = std::string()) : Literal(std::move(value), &TYPE), m_language(std::move(language)) {}
+		explicit StringLiteral(const std::string &value, const std::string &language = std::string()) : Literal(value, InternedRef(DATATYPE)), m_language(entry(language)) {}
+		explicit StringLiteral(std::string &&value, std::string &&language = std::string()) : Literal(std::move(value), InternedRef(DATATYPE)), m_language(entry(language)) {}
 		
-		const std::string &language() const { return m_language; }
+		/// language is shared, e.g. an entry of the parser's InternCache.
+		StringLiteral(const std::string &value, const InternedRef &language) : Literal(value, InternedRef(DATATYPE)), m_language(language) {}
+		StringLiteral(std::string &&value, const InternedRef &language) noexcept : Literal(std::move(value), InternedRef(DATATYPE)), m_language(language) {}
+		
+		const std::string &language() const { return m_language->value(); }
+		
+		const InternedRef &languageEntry() const { return m_language; }
 		
 		std::ostream &print(std::ostream &out) const override
 		{
@@ -391,45 +438,15 @@ namespace turtle {
 		}
 	};
 	
-	class OtherLiteral : public Literal { /* keeps a copy of the type uri */
-		
-		std::string m_datatype_copy;
-		
+	class OtherLiteral : public Literal {
 	public:
 		
-		explicit OtherLiteral(const std::string &value, const std::string &datatype) : Literal(value, nullptr), m_datatype_copy(datatype)
-		{
-			m_datatype = &m_datatype_copy;
-		}
+		OtherLiteral(const std::string &value, const std::string &datatype) : Literal(value, InternedRef::make(datatype)) {}
+		OtherLiteral(std::string &&value, const std::string &datatype) : Literal(std::move(value), InternedRef::make(datatype)) {}
 		
-		explicit OtherLiteral(std::string &&value, std::string &&datatype) noexcept : Literal(std::move(value), nullptr), m_datatype_copy(std::move(datatype))
-		{
-			m_datatype = &m_datatype_copy;
-		}
-		
-		OtherLiteral(const OtherLiteral &other) : Literal(other.m_lexical, nullptr), m_datatype_copy(other.m_datatype_copy)
-		{
-			m_datatype = &m_datatype_copy;
-		}
-		
-		OtherLiteral(OtherLiteral &&other) noexcept : Literal(std::move(other.m_lexical), nullptr), m_datatype_copy(std::move(other.m_datatype_copy))
-		{
-			m_datatype = &m_datatype_copy;
-		}
-		
-		OtherLiteral& operator=(OtherLiteral other)
-		{
-			swap(other);
-			
-			return *this;
-		}
-		
-		OtherLiteral& operator=(OtherLiteral &&other) noexcept
-		{
-			swap(other);
-			
-			return *this;
-		}
+		/// datatype is shared, e.g. an entry of the parser's InternCache.
+		OtherLiteral(const std::string &value, const InternedRef &datatype) : Literal(value, datatype) {}
+		OtherLiteral(std::string &&value, const InternedRef &datatype) noexcept : Literal(std::move(value), datatype) {}
 		
 		std::ostream &print(std::ostream &out) const override
 		{
@@ -440,23 +457,10 @@ namespace turtle {
 		
 		OtherLiteral *clone() const override
 		{
-			return new OtherLiteral(m_lexical, m_datatype_copy);
-		}
-
-		void swap(OtherLiteral &other) noexcept
-		{
-			m_lexical.swap(other.m_lexical);
-			m_datatype_copy.swap(other.m_datatype_copy);
-
-//			m_datatype = &m_datatype_copy;
+			return new OtherLiteral(m_lexical, m_datatype);
 		}
 	};
 	
-	inline void swap(OtherLiteral &x, OtherLiteral &y) noexcept
-	{
-		x.swap(y);
-	}
-	
 	
 	struct RDF {
 		static const std::string NS;
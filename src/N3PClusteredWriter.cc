@@ -0,0 +1,134 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "N3PClusteredWriter.hh"
+
+
+namespace turtle {
+	
+	N3PClusteredWriter::Cluster &N3PClusteredWriter::cluster(const std::string &uri, bool graph)
+	{
+		std::unordered_map<std::string, std::size_t> &index = graph ? m_graphIndex : m_index;
+		
+		auto i = index.find(uri);
+		if (i != index.end())
+			return m_clusters[i->second];
+		
+		index.emplace(uri, m_clusters.size());
+		m_clusters.emplace_back(uri, graph);
+		
+		return m_clusters.back();
+	}
+	
+	void N3PClusteredWriter::spill()
+	{
+		if (!m_spill)
+			m_spill = std::unique_ptr<TemporaryFile>(new TemporaryFile());
+		
+		for (Cluster &c : m_clusters) {
+			if (c.clauses.empty())
+				continue;
+			
+			c.segments.push_back(Segment { m_spill->size(), c.clauses.size() });
+			m_spill->sputn(c.clauses.data(), c.clauses.size());
+			std::string().swap(c.clauses); // release the memory
+		}
+		
+		m_buffered = 0;
+		m_spills++;
+	}
+	
+	void N3PClusteredWriter::document(const std::string &source)
+	{
+		m_clause.clear();
+		m_clauseOut << "scope('<";
+		m_formatter.outputUri(source);
+		m_clauseOut << ">').";
+		clauseEnd();
+		
+		m_scopes += m_clause;
+	}
+	
+	void N3PClusteredWriter::prefix(const std::string &prefix, const std::string &ns)
+	{
+		m_clause.clear();
+		m_clauseOut << "pfx('";
+		m_formatter.output(prefix);
+		m_clauseOut << ":','<";
+		m_formatter.outputUri(ns);
+		m_clauseOut << ">').";
+		clauseEnd();
+		
+		m_prefixes += m_clause;
+	}
+	
+	void N3PClusteredWriter::clause(const Resource &subject, const URIResource &property, const N3Node &object, const Resource *graph)
+	{
+		m_clause.clear();
+		
+		property.visit(m_formatter);
+		m_clauseBuffer.sputc('(');
+		subject.visit(m_formatter);
+		m_clauseBuffer.sputc(',');
+		object.visit(m_formatter);
+		if (graph) {
+			m_clauseBuffer.sputc(',');
+			graph->visit(m_formatter);
+		}
+		m_clauseBuffer.sputc(')');
+		m_clauseBuffer.sputc('.');
+		clauseEnd();
+		
+		cluster(property.uri(), graph != nullptr).clauses += m_clause;
+		m_buffered += m_clause.size();
+		m_count++;
+		
+		if (m_buffered > m_maxMemory)
+			spill();
+	}
+	
+	void N3PClusteredWriter::end()
+	{
+		m_outbuf->sputn(m_scopes.data(), m_scopes.size());
+		m_outbuf->sputn(m_prefixes.data(), m_prefixes.size());
+		
+		for (const Cluster &c : m_clusters) {
+			if (!c.graph) {
+				outputProperty(c.uri);
+			} else {
+				if (m_index.find(c.uri) == m_index.end())
+					outputProperty(c.uri); // pred/1
+				outputGraphProperty(c.uri);
+			}
+		}
+		
+		for (const Cluster &c : m_clusters) {
+			for (const Segment &s : c.segments)
+				m_spill->copy(s.offset, s.length, m_outbuf);
+			
+			m_outbuf->sputn(c.clauses.data(), c.clauses.size());
+		}
+		
+		writeEpilogue();
+		
+		m_clusters.clear();
+		m_index.clear();
+		m_graphIndex.clear();
+		m_spill.reset();
+		m_buffered = 0;
+	}
+	
+}
@@ -0,0 +1,115 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef N3_N3PCLUSTEREDWRITER_HH
+#define N3_N3PCLUSTEREDWRITER_HH
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <memory>
+#include <ostream>
+
+#include "N3PWriter.hh"
+#include "Binary.hh"
+#include "TemporaryFile.hh"
+
+namespace turtle {
+	
+	///
+	/// N3P variant that writes all clauses of a predicate together, so that
+	/// SWI-Prolog can load it without style_check(-discontiguous). Clauses are
+	/// collected per predicate; when they exceed maxMemory, the collected
+	/// clauses are appended to a temporary file, and copied back per predicate
+	/// at the end.
+	///
+	class N3PClusteredWriter : public N3PWriter {
+		
+		struct Segment {
+			std::uint64_t offset;
+			std::uint64_t length;
+		};
+		
+		struct Cluster {
+			std::string uri;
+			bool graph; // clauses with the graph as third argument
+			std::string clauses;
+			std::vector<Segment> segments;
+			
+			Cluster(const std::string &u, bool g) : uri(u), graph(g), clauses(), segments() {}
+		};
+		
+		std::string m_clause;
+		StringOutputBuffer m_clauseBuffer;
+		std::ostream m_clauseOut;
+		N3PFormatter m_formatter;
+		
+		std::string m_scopes;
+		std::string m_prefixes;
+		std::vector<Cluster> m_clusters;
+		std::unordered_map<std::string, std::size_t> m_index;
+		std::unordered_map<std::string, std::size_t> m_graphIndex;
+		std::size_t m_buffered;
+		std::size_t m_maxMemory;
+		std::unique_ptr<TemporaryFile> m_spill;
+		std::size_t m_spills;
+		
+		void clauseEnd()
+		{
+#ifdef CTURTLE_CRLF
+			m_clauseBuffer.sputc('\r');
+#endif
+			m_clauseBuffer.sputc('\n');
+		}
+		
+		Cluster &cluster(const std::string &uri, bool graph);
+		void spill();
+		void clause(const Resource &subject, const URIResource &property, const N3Node &object, const Resource *graph);
+		
+	public:
+		static const std::size_t DEFAULT_MAX_MEMORY = 256 * 1024 * 1024;
+		
+		explicit N3PClusteredWriter(std::ostream &out, bool rdivDecimal = false, std::size_t maxMemory = DEFAULT_MAX_MEMORY) :
+			N3PWriter(out, rdivDecimal), m_clause(), m_clauseBuffer(m_clause), m_clauseOut(&m_clauseBuffer), m_formatter(m_clauseOut, rdivDecimal),
+			m_scopes(), m_prefixes(), m_clusters(), m_index(), m_graphIndex(), m_buffered(0), m_maxMemory(maxMemory), m_spill(), m_spills(0)
+		{
+			// nop
+		}
+		
+		void document(const std::string &source) override;
+		void prefix(const std::string &prefix, const std::string &ns) override;
+		
+		void start() override { writePrologue(false); }
+		void end() override;
+		void triple(const Resource &subject, const URIResource &property, const N3Node &object) override
+		{
+			clause(subject, property, object, nullptr);
+		}
+		
+		void quad(const Resource &subject, const URIResource &property, const N3Node &object, const Resource &graph) override
+		{
+			clause(subject, property, object, &graph);
+		}
+		
+		/// The number of times the collected clauses were moved to the temporary file.
+		std::size_t spills() const { return m_spills; }
+	};
+
+}
+
+#endif /* N3_N3PCLUSTEREDWRITER_HH */
@@ -0,0 +1,154 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#include "N3PDictWriter.hh"
+
+#include <cstdint>
+#include <string>
+
+namespace turtle {
+	
+	void N3PDictWriter::start()
+	{
+		writePrologue(true, false);
+		m_out << ":- multifile(dict/2)."; endl();
+	}
+	
+	std::uint64_t N3PDictWriter::atom(const std::string &uri)
+	{
+		std::uint64_t h = N3PDictFormatter::hash(uri);
+		auto r = m_atoms.emplace(h, uri);
+		
+		if (r.second) {
+			m_outbuf->sputn("dict(", 5);
+			m_dictFormatter.outputAtom(h);
+			m_outbuf->sputn(",'<", 3);
+			m_dictFormatter.outputUri(uri);
+			m_outbuf->sputn(">').", 4);
+			endl();
+		} else if (r.first->second != uri) {
+			throw AtomCollisionException("n3p-dict: <" + r.first->second + "> and <" + uri + "> map to the same atom");
+		}
+		
+		return h;
+	}
+	
+	void N3PDictWriter::outputClause(const Resource &subject, const URIResource &property, const N3Node &object, const Resource *graph)
+	{
+		std::uint64_t p = atom(property.uri());
+		subject.visit(m_collector);
+		object.visit(m_collector);
+		if (graph)
+			graph->visit(m_collector);
+		
+		if (m_properties.insert(p).second)
+			outputProperty(p, 2);
+		
+		if (graph && m_graphProperties.insert(p).second)
+			outputProperty(p, 3);
+		
+		m_dictFormatter.outputAtom(p);
+		m_outbuf->sputc('(');
+		subject.visit(m_dictFormatter);
+		m_outbuf->sputc(',');
+		object.visit(m_dictFormatter);
+		if (graph) {
+			m_outbuf->sputc(',');
+			graph->visit(m_dictFormatter);
+		}
+		m_outbuf->sputc(')');
+		m_outbuf->sputc('.');
+		endl();
+		
+		m_count++;
+	}
+	
+	/// Declares the atom of a predicate as a dynamic and multifile procedure.
+	void N3PDictWriter::outputProperty(std::uint64_t hash, unsigned arity)
+	{
+		m_outbuf->sputn(":- dynamic(", 11);
+		m_dictFormatter.outputAtom(hash);
+		m_out << '/' << arity << ").";
+		endl();
+		m_outbuf->sputn(":- multifile(", 13);
+		m_dictFormatter.outputAtom(hash);
+		m_out << '/' << arity << ").";
+		endl();
+	}
+	
+	
+	
+	std::uint64_t N3PDictFormatter::hash(const std::string &uri)
+	{
+		std::uint64_t h = 14695981039346656037ULL;
+		for (char c : uri) {
+			h ^= static_cast<unsigned char>(c);
+			h *= 1099511628211ULL;
+		}
+		
+		return h;
+	}
+	
+	void N3PDictFormatter::outputAtom(std::uint64_t hash)
+	{
+		char buf[14]; // 'i' and at most 13 base 36 digits
+		char *p = buf + sizeof(buf);
+		
+		do {
+			*--p = "0123456789abcdefghijklmnopqrstuvwxyz"[hash % 36];
+			hash /= 36;
+		} while (hash);
+		*--p = 'i';
+		
+		m_outbuf->sputn(p, buf + sizeof(buf) - p);
+	}
+	
+	void N3PDictFormatter::visit(const URIResource &resource)
+	{
+		outputAtom(resource.uri());
+	}
+	
+	void N3PDictFormatter::visit(const Literal &literal)
+	{
+		m_outbuf->sputn("literal('", 9);
+		output(literal.lexical());
+		m_outbuf->sputn("',type(", 7);
+		outputAtom(literal.datatype());
+		m_outbuf->sputn("))", 2);
+	}
+	
+	void N3PDictFormatter::visit(const StringLiteral &literal)
+	{
+		m_outbuf->sputn("literal('", 9);
+		output(literal.lexical());
+		m_outbuf->sputc('\'');
+		const std::string &lang = literal.language();
+		if (!lang.empty()) {
+			m_outbuf->sputn(",lang('", 7);
+			m_outbuf->sputn(lang.c_str(), lang.length());
+			m_outbuf->sputc('\'');
+			m_outbuf->sputc(')');
+		} else {
+			m_outbuf->sputn(",type(", 6);
+			outputAtom(StringLiteral::TYPE);
+			m_outbuf->sputc(')');
+		}
+		
+		m_outbuf->sputc(')');
+	}
+	
+}
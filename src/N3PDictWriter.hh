@@ -0,0 +1,131 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef N3_N3PDICTWRITER_HH
+#define N3_N3PDICTWRITER_HH
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <ostream>
+
+#include "N3PWriter.hh"
+
+namespace turtle {
+	
+	///
+	/// Thrown when two IRIs of one output hash to the same atom.
+	///
+	class AtomCollisionException : public std::runtime_error {
+	public:
+		explicit AtomCollisionException(const std::string &message = std::string()) : std::runtime_error(message) {}
+	};
+	
+	
+	///
+	/// Writes IRIs as short atoms, "i" followed by a 64-bit hash of the IRI in base 36.
+	///
+	class N3PDictFormatter : public N3PFormatter {
+	public:
+		N3PDictFormatter(std::ostream &out, bool rdivDecimal) : N3PFormatter(out, rdivDecimal)
+		{
+			// nop
+		}
+		
+		/// FNV-1a, the same IRI gives the same atom in every output and on every platform
+		static std::uint64_t hash(const std::string &uri);
+		
+		using N3PFormatter::visit;
+		
+		void visit(const URIResource &resource) override;
+		void visit(const Literal &literal) override;
+		void visit(const StringLiteral &literal) override;
+		
+		void outputAtom(std::uint64_t hash);
+		void outputAtom(const std::string &uri)
+		{
+			outputAtom(hash(uri));
+		}
+	};
+	
+	
+	///
+	/// N3P variant where every IRI (including literal datatypes) is emitted once as
+	/// dict(iH,'<iri>'). and referred to as iH afterwards, triples become
+	/// iP(iS,iO). H is derived from the IRI alone, so files written separately
+	/// agree on the atoms and can be loaded together. Blank nodes and literal
+	/// values are written as in N3P. As the predicates are not IRIs, the prologue
+	/// leaves out the declarations for the predicates Eye has rules for.
+	///
+	class N3PDictWriter : public N3PWriter {
+		
+		struct AtomCollector : public N3NodeVisitor {
+			N3PDictWriter &m_writer;
+			
+			explicit AtomCollector(N3PDictWriter &writer) : N3NodeVisitor(), m_writer(writer) {}
+			
+			void visit(const URIResource &resource) override { m_writer.atom(resource.uri()); }
+			void visit(const BlankNode &blankNode) override  {}
+			void visit(const Literal &literal) override      { m_writer.atom(literal.datatype()); }
+			void visit(const BooleanLiteral &literal) override {}
+			void visit(const IntegerLiteral &literal) override {}
+			void visit(const DoubleLiteral &literal) override  {}
+			void visit(const DecimalLiteral &literal) override {}
+			void visit(const StringLiteral &literal) override
+			{
+				if (literal.language().empty())
+					m_writer.atom(StringLiteral::TYPE);
+			}
+			void visit(const RDFList &list) override
+			{
+				for (const N3Node *n : list)
+					n->visit(*this);
+			}
+		};
+		
+		std::unordered_map<std::uint64_t, std::string> m_atoms; // hash -> IRI
+		std::unordered_set<std::uint64_t> m_properties;
+		std::unordered_set<std::uint64_t> m_graphProperties;
+		N3PDictFormatter m_dictFormatter;
+		AtomCollector m_collector;
+		
+		std::uint64_t atom(const std::string &uri);
+		void outputProperty(std::uint64_t hash, unsigned arity);
+		void outputClause(const Resource &subject, const URIResource &property, const N3Node &object, const Resource *graph);
+		
+	public:
+		explicit N3PDictWriter(std::ostream &out, bool rdivDecimal = false) : N3PWriter(out, rdivDecimal), m_atoms(), m_properties(), m_graphProperties(), m_dictFormatter(out, rdivDecimal), m_collector(*this)
+		{
+			// nop
+		}
+		
+		void start() override;
+		void triple(const Resource &subject, const URIResource &property, const N3Node &object) override
+		{
+			outputClause(subject, property, object, nullptr);
+		}
+		
+		void quad(const Resource &subject, const URIResource &property, const N3Node &object, const Resource &graph) override
+		{
+			outputClause(subject, property, object, &graph);
+		}
+	};
+
+}
+
+#endif /* N3_N3PDICTWRITER_HH */
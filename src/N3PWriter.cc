@@ -14,15 +14,19 @@
 // limitations under the License.
 //
 
+#include <sstream>
+
 #include "N3PWriter.hh"
 
 
 namespace turtle {
 
 
-	void N3PWriter::writePrologue()
+	void N3PWriter::writePrologue(bool discontiguous, bool builtins)
 	{
-		m_out << ":- style_check(-discontiguous)."; endl();
+		if (discontiguous) {
+			m_out << ":- style_check(-discontiguous)."; endl();
+		}
 		m_out << ":- style_check(-singleton)."; endl();
 		m_out << ":- multifile(exopred/3)."; endl();
 		m_out << ":- multifile(implies/3)."; endl();
@@ -31,21 +35,23 @@ namespace turtle {
 		m_out << ":- multifile(prfstep/8)."; endl();
 		m_out << ":- multifile(scope/1)."; endl();
 		m_out << ":- multifile(scount/1)."; endl();
-		m_out << ":- multifile('<http://eulersharp.sourceforge.net/2003/03swap/fl-rules#mu>'/2)."; endl();
-		m_out << ":- multifile('<http://eulersharp.sourceforge.net/2003/03swap/fl-rules#pi>'/2)."; endl();
-		m_out << ":- multifile('<http://eulersharp.sourceforge.net/2003/03swap/fl-rules#sigma>'/2)."; endl();
-		m_out << ":- multifile('<http://eulersharp.sourceforge.net/2003/03swap/log-rules#biconditional>'/2)."; endl();
-		m_out << ":- multifile('<http://eulersharp.sourceforge.net/2003/03swap/log-rules#conditional>'/2)."; endl();
-		m_out << ":- multifile('<http://eulersharp.sourceforge.net/2003/03swap/log-rules#reflexive>'/2)."; endl();
-		m_out << ":- multifile('<http://eulersharp.sourceforge.net/2003/03swap/log-rules#relabel>'/2)."; endl();
-		m_out << ":- multifile('<http://eulersharp.sourceforge.net/2003/03swap/log-rules#tactic>'/2)."; endl();
-		m_out << ":- multifile('<http://eulersharp.sourceforge.net/2003/03swap/log-rules#transaction>'/2)."; endl();
-		m_out << ":- multifile('<http://www.w3.org/1999/02/22-rdf-syntax-ns#first>'/2)."; endl();
-		m_out << ":- multifile('<http://www.w3.org/1999/02/22-rdf-syntax-ns#rest>'/2)."; endl();
-		m_out << ":- multifile('<http://www.w3.org/1999/02/22-rdf-syntax-ns#type>'/2)."; endl();
-		m_out << ":- multifile('<http://www.w3.org/2000/10/swap/log#implies>'/2)."; endl();
-		m_out << ":- multifile('<http://www.w3.org/2000/10/swap/log#outputString>'/2)."; endl();
-		m_out << ":- multifile('<http://www.w3.org/2002/07/owl#sameAs>'/2)."; endl();
+		if (builtins) {
+			m_out << ":- multifile('<http://eulersharp.sourceforge.net/2003/03swap/fl-rules#mu>'/2)."; endl();
+			m_out << ":- multifile('<http://eulersharp.sourceforge.net/2003/03swap/fl-rules#pi>'/2)."; endl();
+			m_out << ":- multifile('<http://eulersharp.sourceforge.net/2003/03swap/fl-rules#sigma>'/2)."; endl();
+			m_out << ":- multifile('<http://eulersharp.sourceforge.net/2003/03swap/log-rules#biconditional>'/2)."; endl();
+			m_out << ":- multifile('<http://eulersharp.sourceforge.net/2003/03swap/log-rules#conditional>'/2)."; endl();
+			m_out << ":- multifile('<http://eulersharp.sourceforge.net/2003/03swap/log-rules#reflexive>'/2)."; endl();
+			m_out << ":- multifile('<http://eulersharp.sourceforge.net/2003/03swap/log-rules#relabel>'/2)."; endl();
+			m_out << ":- multifile('<http://eulersharp.sourceforge.net/2003/03swap/log-rules#tactic>'/2)."; endl();
+			m_out << ":- multifile('<http://eulersharp.sourceforge.net/2003/03swap/log-rules#transaction>'/2)."; endl();
+			m_out << ":- multifile('<http://www.w3.org/1999/02/22-rdf-syntax-ns#first>'/2)."; endl();
+			m_out << ":- multifile('<http://www.w3.org/1999/02/22-rdf-syntax-ns#rest>'/2)."; endl();
+			m_out << ":- multifile('<http://www.w3.org/1999/02/22-rdf-syntax-ns#type>'/2)."; endl();
+			m_out << ":- multifile('<http://www.w3.org/2000/10/swap/log#implies>'/2)."; endl();
+			m_out << ":- multifile('<http://www.w3.org/2000/10/swap/log#outputString>'/2)."; endl();
+			m_out << ":- multifile('<http://www.w3.org/2002/07/owl#sameAs>'/2)."; endl();
+		}
 		m_out << "flag('no-skolem', '" << N3PFormatter::SKOLEM_PREFIX << "')."; endl();
 	}
 
@@ -67,6 +73,31 @@ namespace turtle {
 		outputTriple(subject, property, object);
 	}
 	
+	void N3PWriter::quad(const Resource &subject, const URIResource &property, const N3Node &object, const Resource &graph)
+	{
+		const std::string &uri = property.uri();
+		
+		if (m_properties.insert(uri).second)
+			outputProperty(uri);
+		
+		if (m_graphProperties.insert(uri).second)
+			outputGraphProperty(uri);
+		
+		outputTriple(subject, property, object, &graph);
+	}
+	
+	void N3PWriter::outputGraphProperty(const std::string &uri)
+	{
+		m_outbuf->sputn(":- dynamic('<", 13);
+		m_formatter.outputUri(uri);
+		m_outbuf->sputn(">'/3).", 6);
+		endl();
+		m_outbuf->sputn(":- multifile('<", 15);
+		m_formatter.outputUri(uri);
+		m_outbuf->sputn(">'/3).", 6);
+		endl();
+	}
+	
 	void N3PWriter::outputProperty(const std::string &uri)
 	{
 #ifdef CTURTLE_N3P_CESU8
@@ -113,7 +144,7 @@ namespace turtle {
 #endif /* CTURTLE_N3P_CESU8 */
 	}
 
-	inline void N3PWriter::outputTriple(const N3Node &subject, const URIResource &property, const N3Node &object)
+	inline void N3PWriter::outputTriple(const N3Node &subject, const URIResource &property, const N3Node &object, const N3Node *graph)
 	{
 		property.visit(m_formatter);
 		m_outbuf->sputc('(');
@@ -123,6 +154,11 @@ namespace turtle {
 		
 		object.visit(m_formatter);
 		
+		if (graph) {
+			m_outbuf->sputc(',');
+			graph->visit(m_formatter);
+		}
+		
 		m_outbuf->sputc(')');
 		m_outbuf->sputc('.');
 		endl();
@@ -143,9 +179,23 @@ namespace turtle {
 	
 	void N3PFormatter::visit(const URIResource &resource)
 	{
-		m_outbuf->sputc('\'');
-		m_outbuf->sputc('<');
-		outputUri(resource.uri());
+		const InternedRef &ns = resource.namespaceEntry();
+		if (ns.get()) {
+			const std::string &prefix = m_namespaces.get(ns, [this](const std::string &ns, std::string &bytes) {
+				std::stringbuf buffer;
+				std::streambuf *out = m_outbuf;
+				m_outbuf = &buffer;
+				m_outbuf->sputn("'<", 2);
+				outputUri(ns);
+				m_outbuf = out;
+				bytes = buffer.str();
+			});
+			m_outbuf->sputn(prefix.data(), prefix.length());
+		} else {
+			m_outbuf->sputc('\'');
+			m_outbuf->sputc('<');
+		}
+		outputUri(resource.localName());
 		m_outbuf->sputc('>');
 		m_outbuf->sputc('\'');
 	}
@@ -166,9 +216,19 @@ namespace turtle {
 	{
 		m_outbuf->sputn("literal('", 9);
 		output(literal.lexical());
-		m_outbuf->sputn("',type('<", 9);
-		outputUri(literal.datatype());
-		m_outbuf->sputn(">'))", 4);
+		
+		const std::string &suffix = m_datatypes.get(literal.datatypeEntry(), [this](const std::string &datatype, std::string &bytes) {
+			// escaped by outputUri, like any other IRI
+			std::stringbuf buffer;
+			std::streambuf *out = m_outbuf;
+			m_outbuf = &buffer;
+			m_outbuf->sputn("',type('<", 9);
+			outputUri(datatype);
+			m_outbuf->sputn(">'))", 4);
+			m_outbuf = out;
+			bytes = buffer.str();
+		});
+		m_outbuf->sputn(suffix.data(), suffix.length());
 	}
 	
 	void N3PFormatter::visit(const BooleanLiteral &literal)
@@ -270,22 +330,14 @@ namespace turtle {
 	{
 		m_outbuf->sputn("literal('", 9);
 		output(literal.lexical());
-		m_outbuf->sputc('\'');
-		const std::string &lang = literal.language();
-		if (!lang.empty()) {
-			m_outbuf->sputn(",lang('", 7);
-			m_outbuf->sputn(lang.c_str(), lang.length());
-			m_outbuf->sputc('\'');
-			m_outbuf->sputc(')');
-		} else {
-			m_outbuf->sputn(",type('<", 8);
-			m_outbuf->sputn(StringLiteral::TYPE.c_str(), StringLiteral::TYPE.length());
-			m_outbuf->sputc('>');
-			m_outbuf->sputc('\'');
-			m_outbuf->sputc(')');
-		}
 		
-		m_outbuf->sputc(')');
+		const std::string &suffix = m_languages.get(literal.languageEntry(), [](const std::string &language, std::string &bytes) {
+			if (language.empty())
+				bytes.append("',type('<").append(StringLiteral::TYPE).append(">'))");
+			else
+				bytes.append("',lang('").append(language).append("'))");
+		});
+		m_outbuf->sputn(suffix.data(), suffix.length());
 	}
 	
 	void N3PFormatter::visit(const RDFList &list)
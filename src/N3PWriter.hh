@@ -36,15 +36,19 @@
 namespace turtle {
 	
 	class N3PFormatter : public N3NodeVisitor {
+	protected:
 		std::streambuf *m_outbuf;
 		
 		bool m_rdivDecimal; // output decimals as rdivs
+		Renderings m_datatypes; // ',type('<datatype>'))
+		Renderings m_languages; // ',lang('language')) or ',type('<xsd:string>'))
+		Renderings m_namespaces; // '<namespace
 		
 	public:
 		static const std::string SKOLEM_PREFIX;
 		static const char HEX_CHAR[];
 		
-		N3PFormatter(std::ostream &out, bool rdivDecimal) : N3NodeVisitor(), m_outbuf(out.rdbuf()), m_rdivDecimal(rdivDecimal)
+		N3PFormatter(std::ostream &out, bool rdivDecimal) : N3NodeVisitor(), m_outbuf(out.rdbuf()), m_rdivDecimal(rdivDecimal), m_datatypes(), m_languages(), m_namespaces()
 		{
 			// nop
 		}
@@ -167,16 +171,25 @@ namespace turtle {
 
 	class N3PWriter : public TripleSink {
 		
-		std::ostream &m_out;
-		std::streambuf *m_outbuf;
 		N3PFormatter m_formatter;
 		std::unordered_set<std::string> m_properties;
+		std::unordered_set<std::string> m_graphProperties;
+		
+		/// graph is null for the default graph
+		inline void outputTriple(const N3Node &subject, const URIResource &property, const N3Node &object, const N3Node *graph = nullptr);
+		
+	protected:
+		std::ostream &m_out;
+		std::streambuf *m_outbuf;
 		unsigned m_count;
 		
-		void writePrologue();
-		void writeEpilogue();
-		inline void outputTriple(const N3Node &subject, const URIResource &property, const N3Node &object);
 		void outputProperty(const std::string &uri);
+		void outputGraphProperty(const std::string &uri);
+		
+		/// discontiguous false omits the style_check(-discontiguous) directive, for output that keeps the clauses of every predicate together,
+		/// builtins false omits the multifile directives for predicates Eye has rules for, for output that does not use IRIs as functors
+		void writePrologue(bool discontiguous = true, bool builtins = true);
+		void writeEpilogue();
 		
 		void endl()
 		{
@@ -187,7 +200,7 @@ namespace turtle {
 		}
 		
 	public:
-		explicit N3PWriter(std::ostream &out, bool rdivDecimal = false) : TripleSink(), m_out(out), m_outbuf(out.rdbuf()), m_formatter(out, rdivDecimal), m_properties(), m_count(0)
+		explicit N3PWriter(std::ostream &out, bool rdivDecimal = false) : TripleSink(), m_formatter(out, rdivDecimal), m_properties(), m_graphProperties(), m_out(out), m_outbuf(out.rdbuf()), m_count(0)
 		{
 			// nop
 		}
@@ -214,6 +227,9 @@ namespace turtle {
 		void end()   override { writeEpilogue(); }
 		void triple(const Resource &subject, const URIResource &property, const N3Node &object) override;
 		
+		/// Writes the graph as third argument, property(subject, object, graph).
+		void quad(const Resource &subject, const URIResource &property, const N3Node &object, const Resource &graph) override;
+		
 		unsigned count() const override { return m_count; }
 		
 	};
@@ -16,72 +16,14 @@
 
 #include "NTriplesWriter.hh"
 
-#include <cstddef>
-#include <utility> // std::move
-
 namespace turtle {
 	
-	std::unique_ptr<BlankNode> NTriplesWriter::triples(const RDFList &list)
-	{
-		std::string id = m_idgen.generate();
-		
-		std::unique_ptr<BlankNode> head(new BlankNode(id));
-			
-		for (std::size_t i = 0; i < list.size(); i++) {
-			const N3Node *node = list[i];
-			
-			std::unique_ptr<BlankNode> nestedList;
-			if (const RDFList *rl = dynamic_cast<const RDFList *>(node)) {
-				if (rl->empty()) {
-					node = &RDF::nil;
-				} else {
-					nestedList = triples(*rl);
-					node = nestedList.get();
-				}
-			}
-				
-			rawTriple(*head, RDF::first, *node);
-			
-			if (i == list.size() - 1) {
-				rawTriple(*head, RDF::rest, RDF::nil);
-			} else {
-				std::unique_ptr<BlankNode> rest(new BlankNode(m_idgen.generate()));
-				rawTriple(*head, RDF::rest, *rest);
-				head = std::move(rest);
-			}
-		}
-			
-		return std::unique_ptr<BlankNode>(new BlankNode(id));
-	}
-
 	void NTriplesWriter::triple(const Resource &subject, const URIResource &property, const N3Node &object)
 	{
-		std::unique_ptr<BlankNode> sp; // prevent sp.get() getting deleted
-		const Resource *s = &subject;
-		if (const RDFList *list = dynamic_cast<const RDFList *>(s)) {
-			if (list->empty()) {
-				s = &RDF::nil;
-			} else {
-				sp = triples(*list); 
-				s = sp.get();
-			}
-		}
-		
-		std::unique_ptr<BlankNode> op; // prevent op.get() getting deleted
-		const N3Node *o = &object;
-		if (const RDFList *list = dynamic_cast<const RDFList *>(o)) {
-			if (list->empty()) {
-				o = &RDF::nil;
-			} else {
-				op = triples(*list);
-				o = op.get();
-			}
-		}
-		
-		rawTriple(*s, property, *o);
+		m_lists.triple(subject, property, object, [this](const Resource &s, const URIResource &p, const N3Node &o) { rawTriple(s, p, o); });
 	}
 
-	inline void NTriplesWriter::rawTriple(const Resource &subject, const URIResource &property, const N3Node &object)
+	inline void NTriplesWriter::rawTriple(const Resource &subject, const URIResource &property, const N3Node &object, const Resource *graph)
 	{
 		m_count++;
 		subject.visit(m_formatter);
@@ -90,6 +32,10 @@ namespace turtle {
 		m_outbuf->sputc(' ');
 		object.visit(m_formatter);
 		m_outbuf->sputc(' ');
+		if (graph) {
+			graph->visit(m_formatter);
+			m_outbuf->sputc(' ');
+		}
 		m_outbuf->sputc('.');
 		
 #ifdef CTURTLE_CRLF
@@ -97,5 +43,10 @@ namespace turtle {
 #endif
 		m_outbuf->sputc('\n');
 	}
+	
+	void NQuadsWriter::quad(const Resource &subject, const URIResource &property, const N3Node &object, const Resource &graph)
+	{
+		m_lists.triple(subject, property, object, [this, &graph](const Resource &s, const URIResource &p, const N3Node &o) { rawTriple(s, p, o, &graph); });
+	}
 
 }
@@ -24,6 +24,7 @@
 
 #include "Parser.hh"
 #include "Model.hh"
+#include "ListExpander.hh"
 
 #ifdef _WIN32
 #	define CTURTLE_CRLF
@@ -34,16 +35,19 @@ namespace turtle {
 	class NTripleFormatter : public N3NodeVisitor {
 		
 		std::streambuf *m_outbuf;
+		Renderings m_datatypes; // "^^<datatype>
+		Renderings m_languages; // "@language
+		Renderings m_namespaces; // <namespace
 		
 		void output(const Literal &literal)
 		{
 			m_outbuf->sputc('"');
 			output(literal.lexical());
-			m_outbuf->sputn("\"^^<", 4);
 			
-			const std::string datatype = literal.datatype();
-			m_outbuf->sputn(datatype.c_str(), datatype.length());
-			m_outbuf->sputc('>');
+			const std::string &suffix = m_datatypes.get(literal.datatypeEntry(), [](const std::string &datatype, std::string &bytes) {
+				bytes.append("\"^^<").append(datatype).push_back('>');
+			});
+			m_outbuf->sputn(suffix.data(), suffix.length());
 		}
 		
 		void output(const std::string &s)
@@ -61,17 +65,24 @@ namespace turtle {
 		
 	public:
 		
-		explicit NTripleFormatter(std::ostream &out) : N3NodeVisitor(), m_outbuf(out.rdbuf())
+		explicit NTripleFormatter(std::ostream &out) : N3NodeVisitor(), m_outbuf(out.rdbuf()), m_datatypes(), m_languages(), m_namespaces()
 		{
 			// nop
 		}
 		
 		void visit(const URIResource &resource) override
 		{
-			const std::string &uri = resource.uri();
+			const InternedRef &ns = resource.namespaceEntry();
+			if (ns.get()) {
+				const std::string &prefix = m_namespaces.get(ns, [](const std::string &ns, std::string &bytes) {
+					bytes.append("<").append(ns);
+				});
+				m_outbuf->sputn(prefix.data(), prefix.length());
+			} else
+				m_outbuf->sputc('<');
 			
-			m_outbuf->sputc('<');
-			m_outbuf->sputn(uri.c_str(), uri.length());
+			const std::string &local = resource.localName();
+			m_outbuf->sputn(local.c_str(), local.length());
 			m_outbuf->sputc('>');
 		}
 		
@@ -94,13 +105,13 @@ namespace turtle {
 		{
 			m_outbuf->sputc('"');
 			output(literal.lexical());
-			m_outbuf->sputc('"');
 			
-			const std::string &lang = literal.language();
-			if (!lang.empty()) {
-				m_outbuf->sputc('@');
-				m_outbuf->sputn(lang.c_str(), lang.length());
-			}
+			const std::string &suffix = m_languages.get(literal.languageEntry(), [](const std::string &language, std::string &bytes) {
+				bytes.push_back('"');
+				if (!language.empty())
+					bytes.append("@").append(language);
+			});
+			m_outbuf->sputn(suffix.data(), suffix.length());
 		}
 
 		void visit(const RDFList &list) override
@@ -111,18 +122,17 @@ namespace turtle {
 
 
 	class NTriplesWriter : public TripleSink {
-		
+	protected:
 		std::streambuf *m_outbuf;
 		NTripleFormatter m_formatter;
-		BlankNodeIdGenerator m_idgen;
+		ListExpander m_lists;
 		unsigned m_count;
 		
-		inline void rawTriple(const Resource &subject, const URIResource &property, const N3Node &object);
-		
-		std::unique_ptr<BlankNode> triples(const RDFList &list);
+		/// graph is null for the default graph
+		inline void rawTriple(const Resource &subject, const URIResource &property, const N3Node &object, const Resource *graph = nullptr);
 		
 	public:
-		explicit NTriplesWriter(std::ostream &out) : TripleSink(), m_outbuf(out.rdbuf()), m_formatter(out), m_idgen(), m_count(0)
+		explicit NTriplesWriter(std::ostream &out) : TripleSink(), m_outbuf(out.rdbuf()), m_formatter(out), m_lists(), m_count(0)
 		{
 			// nop
 		}
@@ -152,6 +162,20 @@ namespace turtle {
 		unsigned count() const override { return m_count; }
 		
 	};
+	
+	
+	///
+	/// N-Triples with the graph name as a fourth term for triples in a named graph.
+	///
+	class NQuadsWriter : public NTriplesWriter {
+	public:
+		explicit NQuadsWriter(std::ostream &out) : NTriplesWriter(out)
+		{
+			// nop
+		}
+		
+		void quad(const Resource &subject, const URIResource &property, const N3Node &object, const Resource &graph) override;
+	};
 
 }
 
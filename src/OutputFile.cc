@@ -0,0 +1,74 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#include "OutputFile.hh"
+
+namespace turtle {
+	
+	OutputFile::OutputFile(const std::string &fileName, bool append) : m_name(fileName), m_file(), m_compressor(), m_out()
+	{
+		CompressingStreamBuf::Codec codec;
+		bool compressed = CompressingStreamBuf::codec(fileName, &codec);
+		
+		if (compressed && !CompressingStreamBuf::supported(codec))
+			throw IOException("cturtle was built without support for compressing \"" + fileName + "\"");
+		
+		m_file = std::unique_ptr<std::ofstream>(new std::ofstream(fileName, std::ios_base::out | std::ios_base::binary | (append ? std::ios_base::app : std::ios_base::trunc)));
+		
+		if (!*m_file)
+			throw IOException("error opening \"" + fileName + "\"");
+		
+		if (compressed) {
+			m_compressor = std::unique_ptr<CompressingStreamBuf>(new CompressingStreamBuf(m_file->rdbuf(), codec));
+			m_out = std::unique_ptr<std::ostream>(new std::ostream(m_compressor.get()));
+		} else {
+			m_out = std::unique_ptr<std::ostream>(new std::ostream(m_file->rdbuf()));
+		}
+	}
+	
+	void OutputFile::close()
+	{
+		m_out->flush();
+		
+		if (m_compressor) {
+			try {
+				m_compressor->close();
+			} catch (std::exception &e) {
+				throw IOException("error writing \"" + m_name + "\": " + e.what());
+			}
+		}
+		
+		m_file->close();
+		
+		if (!*m_out || !*m_file)
+			throw IOException("error writing \"" + m_name + "\"");
+	}
+	
+	std::string OutputFile::numbered(const std::string &fileName, unsigned index)
+	{
+		std::size_t slash = fileName.find_last_of("/\\");
+		std::size_t dot = fileName.find('.', slash == std::string::npos ? 1 : slash + 2); // skip leading dots of hidden files
+		
+		std::string n = "." + std::to_string(index);
+		
+		if (dot == std::string::npos)
+			return fileName + n;
+		
+		return fileName.substr(0, dot) + n + fileName.substr(dot);
+	}
+	
+}
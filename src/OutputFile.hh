@@ -0,0 +1,66 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#ifndef N3_OUTPUTFILE_HH
+#define N3_OUTPUTFILE_HH
+
+#include <string>
+#include <memory>
+#include <ostream>
+#include <fstream>
+#include <stdexcept>
+
+#include "Compression.hh"
+
+namespace turtle {
+	
+	class IOException : public std::runtime_error {
+	public:
+		explicit IOException(const std::string &message = std::string()) : std::runtime_error(message) {}
+	};
+	
+	///
+	/// Output file that is compressed when its name ends in .gz or .zst.
+	///
+	class OutputFile {
+		std::string m_name;
+		std::unique_ptr<std::ofstream> m_file;
+		std::unique_ptr<CompressingStreamBuf> m_compressor;
+		std::unique_ptr<std::ostream> m_out;
+	public:
+		/// With append, output is added to the end of an existing file.
+		explicit OutputFile(const std::string &fileName, bool append = false);
+		
+		OutputFile(const OutputFile &) = delete;
+		OutputFile &operator=(const OutputFile &) = delete;
+		
+		std::ostream &stream() { return *m_out; }
+		
+		/// Flushes and closes the file. Throws IOException if anything could not be
+		/// written. Without it, write errors of compressed files go unnoticed.
+		void close();
+		
+		/// true if the bytes written do not map one to one to the file
+		bool compressed() const { return m_compressor != nullptr; }
+		
+		/// Inserts "." index before the extension(s) of fileName: out.n3p.gz becomes out.3.n3p.gz.
+		static std::string numbered(const std::string &fileName, unsigned index);
+	};
+
+}
+
+#endif /* N3_OUTPUTFILE_HH */
@@ -0,0 +1,109 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <algorithm>
+#include <ostream>
+#include <istream>
+
+#include "ParallelReader.hh"
+#include "Binary.hh"
+#include "BinaryWriter.hh"
+#include "BinaryReader.hh"
+#include "Util.hh"
+
+namespace turtle {
+	
+	ParallelReader::ParallelReader(const std::vector<std::string> &inputs, unsigned threads, Reader reader) :
+		m_reader(reader), m_jobs(), m_window(0), m_next(0), m_replayed(0), m_stop(false), m_mutex(), m_done(), m_ready(), m_threads()
+	{
+		for (const std::string &input : inputs)
+			m_jobs.push_back(Job { input, std::string(), std::exception_ptr(), false });
+		
+		threads = std::max(1u, std::min(threads, static_cast<unsigned>(inputs.size())));
+		m_window = READ_AHEAD * threads;
+		for (unsigned i = 0; i < threads; i++)
+			m_threads.emplace_back(&ParallelReader::work, this);
+	}
+	
+	ParallelReader::~ParallelReader()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stop = true;
+		}
+		m_ready.notify_all();
+		
+		for (std::thread &t : m_threads)
+			t.join();
+	}
+	
+	void ParallelReader::work()
+	{
+		for (;;) {
+			Job *job;
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_ready.wait(lock, [this]() { return m_stop || m_next == m_jobs.size() || m_next < m_replayed + m_window; });
+				if (m_stop || m_next == m_jobs.size())
+					return;
+				job = &m_jobs[m_next++];
+			}
+			
+			std::string data;
+			std::exception_ptr error;
+			try {
+				StringOutputBuffer buffer(data);
+				std::ostream out(&buffer);
+				BinaryWriter writer(out);
+				writer.start();
+				m_reader(job->input, &writer);
+				writer.end();
+			} catch (...) {
+				error = std::current_exception();
+			}
+			
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				job->data.swap(data);
+				job->error = error;
+				job->done = true;
+			}
+			m_done.notify_all();
+		}
+	}
+	
+	void ParallelReader::replay(std::size_t index, TripleSink *sink)
+	{
+		Job &job = m_jobs[index];
+		std::string data;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_done.wait(lock, [&job]() { return job.done; });
+			data.swap(job.data);
+			m_replayed = std::max(m_replayed, index + 1);
+		}
+		m_ready.notify_all();
+		
+		StringInputBuffer buffer(data);
+		std::istream in(&buffer);
+		BinaryReader reader(&in, sink);
+		reader.read();
+		
+		if (job.error)
+			std::rethrow_exception(job.error);
+	}
+	
+}
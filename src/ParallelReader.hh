@@ -0,0 +1,87 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef N3_PARALLELREADER_HH
+#define N3_PARALLELREADER_HH
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <functional>
+#include <exception>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "Parser.hh"
+
+namespace turtle {
+	
+	///
+	/// Reads a list of inputs on a pool of threads, in the order they are given.
+	/// Every input is read into a buffer of its own in the binary format;
+	/// replay() waits until an input has been read and passes its events on
+	/// to a sink, so the output keeps the order of the inputs no matter which
+	/// one finished first. Because all triples still end up in a single sink,
+	/// writers that collect declarations (N3P) write each of them only once.
+	/// Threads read at most READ_AHEAD inputs per thread past the one that is
+	/// replayed next, which bounds the memory held by the buffers.
+	///
+	class ParallelReader {
+	public:
+		/// reads input into sink, exceptions are passed on by replay()
+		typedef std::function<void (const std::string &input, TripleSink *sink)> Reader;
+		
+	private:
+		struct Job {
+			std::string input;
+			std::string data;
+			std::exception_ptr error;
+			bool done;
+		};
+		
+		Reader m_reader;
+		std::vector<Job> m_jobs;
+		std::size_t m_window; // how many jobs may be read ahead of m_replayed
+		std::size_t m_next;
+		std::size_t m_replayed; // jobs before this one have been replayed
+		bool m_stop;
+		std::mutex m_mutex;
+		std::condition_variable m_done;
+		std::condition_variable m_ready; // m_replayed moved or m_stop was set
+		std::vector<std::thread> m_threads;
+		
+		void work();
+		
+	public:
+		static const std::size_t READ_AHEAD = 2;
+		
+		ParallelReader(const std::vector<std::string> &inputs, unsigned threads, Reader reader);
+		
+		ParallelReader(const ParallelReader &) = delete;
+		ParallelReader &operator=(const ParallelReader &) = delete;
+		
+		/// Inputs that have not been started yet are skipped.
+		~ParallelReader();
+		
+		/// Passes the events of input index on to sink, after that the buffer is released.
+		/// Rethrows the exception that ended the reading of the input, if any.
+		void replay(std::size_t index, TripleSink *sink);
+	};
+
+}
+
+#endif /* N3_PARALLELREADER_HH */
@@ -17,6 +17,8 @@
 #include <utility>
 
 #include "Parser.hh"
+#include "IriValidator.hh"
+#include "WellKnown.hh"
 #include "Utf8.hh"
 #include "Utf16.hh"
 #include "Model.hh"
@@ -27,6 +29,8 @@ namespace turtle {
 	
 	// We do not check if uris are valid, this is used when translating \uxxxx escapes to chars
 	const std::string Parser::INVALID_ESCAPES("<>\"{}|^`\\");
+	
+	const std::size_t Parser::RESOLVE_CACHE_SIZE;
 
 	inline Uri Parser::resolve(const std::string &uri)
 	{
@@ -46,21 +50,122 @@ namespace turtle {
 		return m_base.resolve(u);
 	}
 
-	std::string Parser::toUri(const std::string &pname) const
+	const InternedRef &Parser::namespaceOf(const std::string &pname, std::size_t colon) const
 	{
-		std::size_t p = pname.find(':');
-		if (p == std::string::npos)
+		if (colon == std::string::npos)
 			throw ParseException();
 		
-		std::string prefix = pname.substr(0, p);
+		std::string prefix = pname.substr(0, colon);
 		
 		auto i = m_prefixMap.find(prefix);
 		if (i == m_prefixMap.end())
 			throw ParseException("unknown prefix: " + prefix, line());
 		
-		return i->second + unescape(p + 1, pname);
-		// checking for valid uris is redundant here, i->second is a valid uri, concatenating a fragment or path cannot give a invalid uri.
-		//return static_cast<std::string>(Uri(i->second + unescape(p + 1, pname)));
+		return i->second;
+	}
+
+	std::string Parser::toUri(const std::string &pname) const
+	{
+		std::size_t p = pname.find(':');
+		
+		return namespaceOf(pname, p)->value() + unescape(p + 1, pname);
+		// checking for valid uris is redundant here, the namespace is a valid uri, concatenating a fragment or path cannot give a invalid uri.
+		//return static_cast<std::string>(Uri(namespaceOf(pname, p)->value() + unescape(p + 1, pname)));
+	}
+
+	Parser::State Parser::state() const
+	{
+		State state { static_cast<std::string>(m_base), std::map<std::string, std::string>(), m_blanks.prefix(), m_blanks.counter() };
+		for (const auto &prefix : m_prefixMap)
+			state.prefixes.emplace(prefix.first, prefix.second->value());
+		
+		return state;
+	}
+
+	void Parser::restore(const State &state)
+	{
+		setBase(Uri(state.base));
+		m_prefixMap.clear();
+		for (const auto &prefix : state.prefixes)
+			m_prefixMap.emplace(prefix.first, m_namespaces.intern(prefix.second));
+		m_blanks.restore(state.blankPrefix, state.blankCounter);
+	}
+
+	Parser::Syntax Parser::syntax(const std::string &fileName)
+	{
+		std::size_t dot = fileName.rfind('.');
+		std::string extension = dot == std::string::npos ? std::string() : fileName.substr(dot);
+		
+		if (extension == ".trig")
+			return TRIG;
+		if (extension == ".nq")
+			return NQUADS;
+		
+		return TURTLE;
+	}
+
+	bool Parser::directive()
+	{
+		if (m_lookAhead == Token::Prefix) {
+			prefixID();
+		} else if (m_lookAhead == Token::Base) {
+			base();
+		} else if (m_lookAhead == Token::SparqlPrefix) {
+			sparqlPrefix();
+		} else if (m_lookAhead == Token::SparqlBase) {
+			sparqlBase();
+		} else
+			return false;
+		
+		return true;
+	}
+
+	void Parser::statements()
+	{
+		m_lookAhead = nextToken();
+		
+		if (!m_errorHandler) {
+			statementlist();
+			return;
+		}
+		
+		while (true) {
+			try {
+				statementlist();
+				return;
+			} catch (ParseException &e) {
+				m_buffer->discard();
+				m_errorHandler(e.line() == -1 ? ParseException(e.what(), line()) : e);
+				skip();
+			}
+		}
+	}
+
+	void Parser::statementlist()
+	{
+		if (m_syntax == TRIG)
+			trigdoc();
+		else if (m_syntax == NQUADS)
+			nquadsdoc();
+		else
+			turtledoc();
+	}
+
+	void Parser::skip()
+	{
+		// a statement ends with a '.', or with the '}' closing the graph it is in
+		while (m_lookAhead != Token::Eof) {
+			Token::Type token = m_lookAhead;
+			match();
+			
+			if (token == '{')
+				m_inGraph = true;
+			else if (m_inGraph ? token == '}' : token == '.')
+				break;
+		}
+		
+		m_inGraph = false;
+		m_graph.reset();
 	}
 
 	void Parser::turtledoc()
@@ -70,15 +175,8 @@ namespace turtle {
 				if (m_lookAhead == Token::PNameLN || m_lookAhead == Token::IriRef || m_lookAhead == Token::BlankNodeLabel || m_lookAhead == Token::PNameNS || m_lookAhead == '[' || m_lookAhead == '(') {
 					triples();
 					match('.');
-				} else if (m_lookAhead == Token::Prefix) {
-					prefixID();
-				} else if (m_lookAhead == Token::Base) {
-					base();
-				} else if (m_lookAhead == Token::SparqlPrefix) {
-					sparqlPrefix();
-				} else if (m_lookAhead == Token::SparqlBase) {
-					sparqlBase();
-				} else
+					statementEnd();
+				} else if (!directive())
 					throw ParseException("expected base, prefix or triple", line());
 			}
 		} catch (UriSyntaxException &e) {
@@ -86,18 +184,167 @@ namespace turtle {
 		}
 	}
 
+	void Parser::trigdoc()
+	{
+		try {
+			while (m_lookAhead != Token::Eof) {
+				if (m_lookAhead == Token::PNameLN || m_lookAhead == Token::IriRef || m_lookAhead == Token::BlankNodeLabel || m_lookAhead == Token::PNameNS) {
+					std::unique_ptr<Resource> s = subject();
+					if (m_lookAhead == '{') {
+						wrappedgraph(std::move(s));
+					} else {
+						propertylist(s.get());
+						match('.');
+						statementEnd();
+					}
+				} else if (m_lookAhead == '[') {
+					match();
+					std::unique_ptr<BlankNode> b(new BlankNode(m_blanks.generate()));
+					if (m_lookAhead == ']') {
+						match();
+						if (m_lookAhead == '{') {
+							wrappedgraph(std::move(b));
+							continue;
+						}
+					} else {
+						propertylist(b.get());
+						match(']');
+					}
+					propertylistopt(b.get());
+					match('.');
+					statementEnd();
+				} else if (m_lookAhead == '(') {
+					triples();
+					match('.');
+					statementEnd();
+				} else if (m_lookAhead == '{') {
+					wrappedgraph(nullptr);
+				} else if (m_lookAhead == Token::Graph) {
+					match();
+					wrappedgraph(label());
+				} else if (!directive())
+					throw ParseException("expected base, prefix, graph or triple", line());
+			}
+		} catch (UriSyntaxException &e) {
+			throw ParseException(e.what(), line());
+		}
+	}
+
+	void Parser::nquadsdoc()
+	{
+		try {
+			while (m_lookAhead != Token::Eof) {
+				std::unique_ptr<Resource> s = nquadsSubject();
+				URIResource property(absoluteIri());
+				std::unique_ptr<N3Node> o = nquadsObject();
+				
+				if (m_lookAhead != '.')
+					m_graph = nquadsSubject();
+				
+				emit(*s, property, *o);
+				m_graph.reset();
+				
+				match('.');
+				statementEnd();
+			}
+		} catch (UriSyntaxException &e) {
+			throw ParseException(e.what(), line());
+		}
+	}
+
+	/// Subject or graph name of a quad.
+	std::unique_ptr<Resource> Parser::nquadsSubject()
+	{
+		if (m_lookAhead == Token::IriRef) {
+			return std::unique_ptr<Resource>(new URIResource(absoluteIri()));
+		} else if (m_lookAhead == Token::BlankNodeLabel) {
+			match();
+			return std::unique_ptr<Resource>(new BlankNode(m_blanks.generate(m_lexeme.substr(2))));
+		} else
+			throw ParseException("expected blank node or IRI ref", line());
+	}
+
+	std::unique_ptr<N3Node> Parser::nquadsObject()
+	{
+		if (m_lookAhead == Token::StringLiteralQuote) {
+			match();
+			return dtlang(extractString(m_lexeme));
+		} else if (m_lookAhead == Token::IriRef || m_lookAhead == Token::BlankNodeLabel) {
+			return nquadsSubject();
+		} else
+			throw ParseException("expected blank node, IRI ref or literal", line());
+	}
+
+	/// N-Quads has no base, IRIs are not resolved.
+	std::string Parser::absoluteIri()
+	{
+		int at = line();
+		
+		if (m_lookAhead != Token::IriRef)
+			throw ParseException("expected IRI ref", at);
+		
+		match();
+		std::string uri = extractUri(m_lexeme);
+		if (!Uri::absolute(uri))
+			throw ParseException("relative IRI <" + uri + ">", at);
+		if (m_validateIris)
+			validate(uri, at);
+		
+		return uri;
+	}
+
+	void Parser::wrappedgraph(std::unique_ptr<Resource> &&graph)
+	{
+		m_graph = std::move(graph);
+		
+		match('{');
+		m_inGraph = true;
+		while (m_lookAhead != '}') {
+			triples();
+			if (m_lookAhead != '.')
+				break;
+			match();
+			statementEnd();
+		}
+		match('}');
+		statementEnd();
+		m_inGraph = false;
+		
+		m_graph.reset();
+	}
+
+	std::unique_ptr<Resource> Parser::label()
+	{
+		if (m_lookAhead == Token::PNameLN || m_lookAhead == Token::IriRef || m_lookAhead == Token::PNameNS) {
+			return std::unique_ptr<Resource>(new URIResource(resource()));
+		} else if (m_lookAhead == Token::BlankNodeLabel) {
+			match();
+			return std::unique_ptr<Resource>(new BlankNode(m_blanks.generate(m_lexeme.substr(2))));
+		} else if (m_lookAhead == '[') {
+			match();
+			match(']');
+			return std::unique_ptr<Resource>(new BlankNode(m_blanks.generate()));
+		} else
+			throw ParseException("expected blank node or uri as graph name", line());
+	}
+
 	void Parser::base()
 	{
+		int at = line();
 		match(Token::Base);
 		match(Token::IriRef);
 		std::string u = extractUri(m_lexeme);
 		match('.');
 		
-		m_base = resolve(std::move(u));
+		Uri uri = resolve(std::move(u));
+		if (m_validateIris)
+			validate(static_cast<std::string>(uri), at);
+		setBase(std::move(uri));
 	}
 
 	void Parser::prefixID()
 	{
+		int at = line();
 		match(Token::Prefix);
 		match(Token::PNameNS);
 		std::string prefix = m_lexeme.substr(0, m_lexeme.length() - 1);
@@ -106,22 +353,29 @@ namespace turtle {
 		match('.');
 		
 		std::string ns = static_cast<std::string>(resolve(std::move(u)));
+		if (m_validateIris)
+			validate(ns, at);
 		m_sink->prefix(prefix, ns);
-		m_prefixMap[prefix] = ns;
+		m_prefixMap[prefix] = m_namespaces.intern(ns);
 	}
 
 	void Parser::sparqlBase()
 	{
+		int at = line();
 		match(Token::SparqlBase);
 		match(Token::IriRef);
 		
 		std::string u = extractUri(m_lexeme);
 		
-		m_base = resolve(std::move(u));
+		Uri uri = resolve(std::move(u));
+		if (m_validateIris)
+			validate(static_cast<std::string>(uri), at);
+		setBase(std::move(uri));
 	}
 
 	void Parser::sparqlPrefix()
 	{
+		int at = line();
 		match(Token::SparqlPrefix);
 		match(Token::PNameNS);
 		std::string prefix = m_lexeme.substr(0, m_lexeme.length() - 1);
@@ -129,8 +383,10 @@ namespace turtle {
 		std::string u = extractUri(m_lexeme);
 		
 		std::string ns = static_cast<std::string>(resolve(std::move(u)));
+		if (m_validateIris)
+			validate(ns, at);
 		m_sink->prefix(prefix, ns);
-		m_prefixMap[prefix] = ns;
+		m_prefixMap[prefix] = m_namespaces.intern(ns);
 	}
 
 	void Parser::triples()
@@ -146,7 +402,7 @@ namespace turtle {
 	std::unique_ptr<Resource> Parser::subject()
 	{
 		if (m_lookAhead == Token::PNameLN || m_lookAhead == Token::IriRef || m_lookAhead == Token::PNameNS) {
-			return std::unique_ptr<Resource>(new URIResource(iri()));
+			return std::unique_ptr<Resource>(new URIResource(resource()));
 		} else if (m_lookAhead == Token::BlankNodeLabel) {
 			match();
 			return std::unique_ptr<Resource>(new BlankNode(m_blanks.generate(m_lexeme.substr(2))));
@@ -176,40 +432,80 @@ namespace turtle {
 			match();
 			objectlist(subject, &RDF::type);
 		} else if (m_lookAhead == Token::PNameLN || m_lookAhead == Token::IriRef || m_lookAhead == Token::PNameNS) {
-			URIResource property(iri());
+			URIResource property = resource();
 			objectlist(subject, &property);
 		} else
 			throw ParseException("expected 'a' or uri as property", line());
 	}
 
+	void Parser::validate(const std::string &iri, int line)
+	{
+		const char *error = IriValidator::check(iri);
+		if (error)
+			throw ParseException("invalid IRI <" + iri + ">: " + error, line);
+	}
+
 	std::string Parser::iri()
 	{
+		int at = line(); // the next token may be on a later line
+		
 		if (m_lookAhead == Token::IriRef) {
 			match();
 			std::string uri = extractUri(m_lexeme);
-			if (Uri::absolute(uri))
+			if (Uri::absolute(uri)) {
+				if (m_validateIris)
+					validate(uri, at);
 				return std::move(uri);
-			return static_cast<std::string>(resolve(std::move(uri)));
-		} else if (m_lookAhead == Token::PNameLN) {
-			match();
-			return toUri(m_lexeme);
-		} else if (m_lookAhead == Token::PNameNS) {
+			}
+			
+			const std::string *cached = m_resolveCache.find(uri);
+			if (cached)
+				return *cached;
+			
+			m_base.resolve(uri, m_resolved);
+			if (m_validateIris)
+				validate(m_resolved, at);
+			m_resolveCache.insert(uri, m_resolved);
+			
+			return m_resolved;
+		} else if (m_lookAhead == Token::PNameLN || m_lookAhead == Token::PNameNS) {
 			match();
-			return toUri(m_lexeme);
+			std::string uri = toUri(m_lexeme);
+			if (m_validateIris)
+				validate(uri, at);
+			return uri;
 		} else
 			throw ParseException("expected IRI ref or prefixed name", line());
 	}
 
+	URIResource Parser::resource()
+	{
+		if (m_lookAhead != Token::PNameLN && m_lookAhead != Token::PNameNS)
+			return URIResource(iri());
+		
+		int at = line();
+		match();
+		
+		// keeps the split toUri() would join, the namespace is shared
+		std::size_t p = m_lexeme.find(':');
+		const InternedRef &ns = namespaceOf(m_lexeme, p);
+		std::string local = unescape(p + 1, m_lexeme);
+		if (m_validateIris)
+			validate(ns->value() + local, at);
+		
+		return URIResource(ns, std::move(local));
+	}
+
 	void Parser::objectlist(const Resource *subject, const URIResource *property)
 	{
 		if (m_lookAhead == Token::PNameLN || m_lookAhead == Token::IriRef || m_lookAhead == Token::BlankNodeLabel || m_lookAhead == Token::PNameNS || m_lookAhead == '[' || m_lookAhead == '(' || m_lookAhead == Token::StringLiteralQuote || m_lookAhead == Token::StringLiteralSingleQuote || m_lookAhead == Token::StringLiteralLongSingleQuote || m_lookAhead == Token::StringLiteralLongQuote || m_lookAhead == Token::True || m_lookAhead == Token::False || m_lookAhead == Token::Integer || m_lookAhead == Token::Decimal || m_lookAhead == Token::Double) {
 			std::unique_ptr<N3Node> obj = object();
-			m_sink->triple(*subject, *property, *obj);
+			emit(*subject, *property, *obj);
 			while (m_lookAhead == ',') {
 				match();
 				if (m_lookAhead == Token::PNameLN || m_lookAhead == Token::IriRef || m_lookAhead == Token::BlankNodeLabel || m_lookAhead == Token::PNameNS || m_lookAhead == '[' || m_lookAhead == '(' || m_lookAhead == Token::StringLiteralQuote || m_lookAhead == Token::StringLiteralSingleQuote || m_lookAhead == Token::StringLiteralLongSingleQuote || m_lookAhead == Token::StringLiteralLongQuote || m_lookAhead == Token::True || m_lookAhead == Token::False || m_lookAhead == Token::Integer || m_lookAhead == Token::Decimal || m_lookAhead == Token::Double) {
 					std::unique_ptr<N3Node> obj = object();
-					m_sink->triple(*subject, *property, *obj);
+					emit(*subject, *property, *obj);
 				} else
 					throw ParseException("expected object after ','", line());
 			}
@@ -224,7 +520,7 @@ namespace turtle {
 			match();
 			return std::unique_ptr<N3Node>(new BlankNode(m_blanks.generate(m_lexeme.substr(2))));
 		} else if (m_lookAhead == Token::PNameLN || m_lookAhead == Token::IriRef || m_lookAhead == Token::PNameNS) {
-			return std::unique_ptr<N3Node>(new URIResource(iri()));
+			return std::unique_ptr<N3Node>(new URIResource(resource()));
 		} else if (m_lookAhead == Token::StringLiteralQuote) {
 			match();
 			return dtlang(extractString(m_lexeme));
@@ -233,13 +529,13 @@ namespace turtle {
 			return dtlang(extractString(m_lexeme));
 		} else if (m_lookAhead == Token::Integer) {
 			match();
-			return std::unique_ptr<Literal>(new IntegerLiteral(m_lexeme));
+			return std::unique_ptr<Literal>(new IntegerLiteral(number(LiteralValidator::INTEGER)));
 		} else if (m_lookAhead == Token::Decimal) {
 			match();
-			return std::unique_ptr<Literal>(new DecimalLiteral(m_lexeme));
+			return std::unique_ptr<Literal>(new DecimalLiteral(number(LiteralValidator::DECIMAL)));
 		} else if (m_lookAhead == Token::Double) {
 			match();
-			return std::unique_ptr<Literal>(new DoubleLiteral(m_lexeme));
+			return std::unique_ptr<Literal>(new DoubleLiteral(number(LiteralValidator::DOUBLE)));
 		} else if (m_lookAhead == Token::True) {
 			match();
 			return std::unique_ptr<Literal>(new BooleanLiteral(m_lexeme));
@@ -265,27 +561,59 @@ namespace turtle {
 	{
 		if (m_lookAhead == Token::LangTag) {
 			match();
-			return std::unique_ptr<Literal>(new StringLiteral(std::move(lexicalValue), m_lexeme.substr(1)));
+			return std::unique_ptr<Literal>(new StringLiteral(std::move(lexicalValue), m_languages.intern(m_lexeme.data() + 1, m_lexeme.length() - 1)));
 		} else if (m_lookAhead == Token::CaretCaret) {
+			int at = line();
 			match();
-			std::string type = iri();
-			if (type == IntegerLiteral::TYPE)
-				return std::unique_ptr<Literal>(new IntegerLiteral(lexicalValue)); //TODO valid check
-			if (type == DecimalLiteral::TYPE)
-				return std::unique_ptr<Literal>(new DecimalLiteral(lexicalValue));
-			if (type == BooleanLiteral::TYPE)
-				return std::unique_ptr<Literal>(new BooleanLiteral(lexicalValue));
-			if (type == DoubleLiteral::TYPE)
-				return std::unique_ptr<Literal>(new DoubleLiteral(lexicalValue));
-			if (type == StringLiteral::TYPE)
-				return std::unique_ptr<Literal>(new StringLiteral(std::move(lexicalValue)));
+			std::string type = m_syntax == NQUADS ? absoluteIri() : iri();
+			if (m_validateLiterals || m_canonicalLiterals)
+				validate(lexicalValue, type, at);
+			switch (WellKnown::lookup(type)) {
+				case WellKnown::XSD_INTEGER:
+					return std::unique_ptr<Literal>(new IntegerLiteral(lexicalValue));
+				case WellKnown::XSD_DECIMAL:
+					return std::unique_ptr<Literal>(new DecimalLiteral(lexicalValue));
+				case WellKnown::XSD_BOOLEAN:
+					return std::unique_ptr<Literal>(new BooleanLiteral(lexicalValue));
+				case WellKnown::XSD_DOUBLE:
+					return std::unique_ptr<Literal>(new DoubleLiteral(lexicalValue));
+				case WellKnown::XSD_STRING:
+					return std::unique_ptr<Literal>(new StringLiteral(std::move(lexicalValue)));
+				default:
+					break;
+			}
 			
-			return std::unique_ptr<Literal>(new OtherLiteral(std::move(lexicalValue), std::move(type)));
+			return std::unique_ptr<Literal>(new OtherLiteral(std::move(lexicalValue), m_datatypes.intern(type)));
 		}
 		
 		return std::unique_ptr<Literal>(new StringLiteral(std::move(lexicalValue)));
 	}
 
+	/// Replaces lexical by its canonical form when literals are canonicalised.
+	void Parser::validate(std::string &lexical, const std::string &datatype, int line)
+	{
+		LiteralValidator::Type type = LiteralValidator::type(datatype);
+		if (type == LiteralValidator::OTHER)
+			return;
+		
+		const char *error = LiteralValidator::check(type, lexical, m_canonicalLiterals ? &m_canonical : nullptr);
+		if (error) {
+			if (m_validateLiterals)
+				throw ParseException("invalid literal \"" + lexical + "\"^^<" + datatype + ">: " + error, line);
+		} else if (m_canonicalLiterals) {
+			lexical.swap(m_canonical);
+		}
+	}
+	
+	/// The lexical form of the number just matched.
+	const std::string &Parser::number(LiteralValidator::Type type)
+	{
+		if (m_canonicalLiterals && !LiteralValidator::check(type, m_lexeme, &m_canonical))
+			return m_canonical;
+		
+		return m_lexeme;
+	}
+
 	std::unique_ptr<RDFList> Parser::collection()
 	{
 		std::unique_ptr<RDFList> list(new RDFList());
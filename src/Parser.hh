@@ -20,13 +20,18 @@
 #include <cstddef>
 #include <map>
 #include <memory>
+#include <vector>
+#include <functional>
 #include <stdexcept>
 #include <FlexLexer.h>
 
 #include "Uri.hh"
 #include "Token.hh"
 #include "Model.hh"
+#include "Interned.hh"
 #include "BlankNodeIdGenerator.hh"
+#include "LruCache.hh"
+#include "LiteralValidator.hh"
 
 namespace turtle {
 
@@ -47,6 +52,12 @@ namespace turtle {
 		virtual void triple(const Resource &subject, const URIResource &property, const N3Node &object) = 0;
 		virtual unsigned count() const = 0;
 		
+		/// A triple in a named graph (TriG, N-Quads). Sinks for formats without graphs keep the default, which drops the graph.
+		virtual void quad(const Resource &subject, const URIResource &property, const N3Node &object, const Resource &graph)
+		{
+			triple(subject, property, object);
+		}
+		
 		virtual ~TripleSink() {}
 	};
 	
@@ -62,6 +73,61 @@ namespace turtle {
 		virtual unsigned count() const override { return m_count; }
 	};
 	
+	///
+	/// Holds the triples of a statement until it is known to be complete,
+	/// used by the parser when it recovers from errors.
+	///
+	class StatementBuffer : public TripleSink {
+		
+		struct Statement {
+			std::unique_ptr<Resource> subject;
+			std::unique_ptr<URIResource> property;
+			std::unique_ptr<N3Node> object;
+			std::unique_ptr<Resource> graph; // null for the default graph
+		};
+		
+		TripleSink *m_sink;
+		std::vector<Statement> m_statements;
+		
+	public:
+		explicit StatementBuffer(TripleSink *sink) : TripleSink(), m_sink(sink), m_statements()
+		{
+			// nop
+		}
+		
+		void start() override { m_sink->start(); }
+		void end() override { m_sink->end(); }
+		void document(const std::string &source) override { m_sink->document(source); }
+		void prefix(const std::string &prefix, const std::string &ns) override { m_sink->prefix(prefix, ns); }
+		
+		void triple(const Resource &subject, const URIResource &property, const N3Node &object) override
+		{
+			m_statements.push_back(Statement { std::unique_ptr<Resource>(subject.clone()), std::unique_ptr<URIResource>(property.clone()), std::unique_ptr<N3Node>(object.clone()), std::unique_ptr<Resource>() });
+		}
+		
+		void quad(const Resource &subject, const URIResource &property, const N3Node &object, const Resource &graph) override
+		{
+			m_statements.push_back(Statement { std::unique_ptr<Resource>(subject.clone()), std::unique_ptr<URIResource>(property.clone()), std::unique_ptr<N3Node>(object.clone()), std::unique_ptr<Resource>(graph.clone()) });
+		}
+		
+		unsigned count() const override { return m_sink->count(); }
+		
+		/// Passes the held triples on.
+		void commit()
+		{
+			for (const Statement &s : m_statements) {
+				if (s.graph)
+					m_sink->quad(*s.subject, *s.property, *s.object, *s.graph);
+				else
+					m_sink->triple(*s.subject, *s.property, *s.object);
+			}
+			m_statements.clear();
+		}
+		
+		/// Drops the held triples.
+		void discard() { m_statements.clear(); }
+	};
+	
 	
 	/*
 	 * Grammar:
@@ -98,23 +164,71 @@ namespace turtle {
 	 * iri              -> IRIREF | prefixedname
 	 * prefixedname     -> PNAME_LN | PNAME_NS
 	 * 
+	 * TriG adds:
+	 * 
+	 * trigdoc          -> EPSILON | block trigdoc | directive trigdoc
+	 * block            -> wrappedgraph | GRAPH label wrappedgraph | label wrappedgraph | triples POINT
+	 * label            -> iri | BLANK_NODE_LABEL | LBRACKET RBRACKET
+	 * wrappedgraph     -> LBRACE triplesblock RBRACE
+	 * triplesblock     -> EPSILON | triples | triples POINT triplesblock
+	 * 
+	 * N-Quads:
+	 * 
+	 * nquadsdoc        -> EPSILON | nqsubject IRIREF nqobject graphopt POINT nquadsdoc
+	 * nqsubject        -> IRIREF | BLANK_NODE_LABEL
+	 * nqobject         -> IRIREF | BLANK_NODE_LABEL | STRING_LITERAL_QUOTE nqdtlang
+	 * nqdtlang         -> EPSILON | LANGTAG | CARETCARET IRIREF
+	 * graphopt         -> EPSILON | IRIREF | BLANK_NODE_LABEL
+	 * 
+	 * where every IRIREF is absolute.
+	 * 
 	 * see http://hackingoff.com/compilers/ll-1-parser-generator
 	 */
 	class Parser {
+	public:
+		enum Syntax { TURTLE, TRIG, NQUADS };
+		
+		/// Receives the errors of skipped statements, see recover().
+		typedef std::function<void(const ParseException &)> ErrorHandler;
 		
+		/// What the parser remembers between statements, see resume().
+		struct State {
+			std::string base;
+			std::map<std::string, std::string> prefixes;
+			std::string blankPrefix;
+			unsigned blankCounter;
+		};
+		
+	private:
 		static const std::string LOCAL_NAME_ESCAPE_CHARS;
 		static const std::string INVALID_ESCAPES;
+		static const std::size_t RESOLVE_CACHE_SIZE = 1024;
 		
 		::yyFlexLexer m_lexer;
 		
 		Uri m_base;
 		TripleSink *m_sink;
-		std::map<std::string, std::string> m_prefixMap;
+		Syntax m_syntax;
+		std::map<std::string, InternedRef> m_prefixMap; // namespaces are shared with the URIResources of prefixed names
+		std::unique_ptr<Resource> m_graph; // null for the default graph
+		bool m_inGraph; // between the braces of a TriG graph
 		
 		BlankNodeIdGenerator m_blanks;
 		
+		std::unique_ptr<StatementBuffer> m_buffer; // only when recovering
+		ErrorHandler m_errorHandler;
+		
 		Token::Type m_lookAhead;
 		std::string m_lexeme;
+		std::string m_resolved; // buffer for resolving relative IRIs
+		LruCache m_resolveCache; // relative IRIs resolved against m_base
+		bool m_validateIris;
+		bool m_validateLiterals;
+		bool m_canonicalLiterals;
+		std::string m_canonical; // buffer for canonical lexical forms
+		InternCache m_datatypes;
+		InternCache m_languages;
+		InternCache m_namespaces;
 		
 		Token::Type nextToken() { return m_lexer.yylex(); }
 		
@@ -133,11 +247,47 @@ namespace turtle {
 			m_lookAhead = nextToken();
 		}
 		
+		void setBase(Uri &&base)
+		{
+			m_base = std::move(base);
+			m_resolveCache.clear();
+		}
+		
 		Uri resolve(const std::string &uri);
 		Uri resolve(std::string &&uri);
+		const InternedRef &namespaceOf(const std::string &pname, std::size_t colon) const;
 		std::string toUri(const std::string &pname) const;
+		static void validate(const std::string &iri, int line);
+		void validate(std::string &lexical, const std::string &datatype, int line);
+		const std::string &number(LiteralValidator::Type type);
+		
+		void emit(const Resource &subject, const URIResource &property, const N3Node &object)
+		{
+			if (m_graph)
+				m_sink->quad(subject, property, object, *m_graph);
+			else
+				m_sink->triple(subject, property, object);
+		}
+		
+		/// Called after each complete statement.
+		void statementEnd()
+		{
+			if (m_buffer)
+				m_buffer->commit();
+		}
 		
+		void statements();
+		void statementlist();
+		void skip();
 		void turtledoc();
+		void trigdoc();
+		void nquadsdoc();
+		std::unique_ptr<Resource> nquadsSubject();
+		std::unique_ptr<N3Node> nquadsObject();
+		std::string absoluteIri();
+		void wrappedgraph(std::unique_ptr<Resource> &&graph);
+		std::unique_ptr<Resource> label();
+		bool directive();
 		void base();
 		void prefixID();
 		void sparqlBase();
@@ -147,6 +297,7 @@ namespace turtle {
 		void propertylist(const Resource *subject);
 		void property(const Resource *subject);
 		std::string iri();
+		URIResource resource();
 		void objectlist(const Resource *subject, const URIResource *property);
 		std::unique_ptr<N3Node> object();
 		std::unique_ptr<Literal> dtlang(std::string &&lexicalValue);
@@ -159,17 +310,57 @@ namespace turtle {
 		static std::string extractString(const std::string &stringLiteral);
 		
 	public:
-		Parser(std::istream *in, const Uri &base, TripleSink *sink) : m_lexer(in), m_base(base), m_sink(sink), m_prefixMap(), m_blanks(), m_lookAhead(0), m_lexeme() {}
+		Parser(std::istream *in, const Uri &base, TripleSink *sink, Syntax syntax = TURTLE) : m_lexer(in), m_base(base), m_sink(sink), m_syntax(syntax), m_prefixMap(), m_graph(), m_inGraph(false), m_blanks(), m_buffer(), m_errorHandler(), m_lookAhead(0), m_lexeme(), m_resolved(), m_resolveCache(RESOLVE_CACHE_SIZE), m_validateIris(false), m_validateLiterals(false), m_canonicalLiterals(false), m_canonical(), m_datatypes(), m_languages(), m_namespaces() {}
 		
 		void parse()
 		{
 			m_sink->document(static_cast<std::string>(m_base));
-			m_lookAhead = nextToken();
-			
-			turtledoc();
+			statements();
+		}
+		
+		/// Continues the document with the statements read from in, keeping the
+		/// base, prefixes and blank node labels. The earlier input must have
+		/// ended at a statement boundary. Line numbers keep counting.
+		void resume(std::istream *in)
+		{
+			m_lexer.switch_streams(in, nullptr);
+			statements();
+		}
+		
+		/// Instead of stopping at the first syntax error, skips the statement it
+		/// is in, up to the next '.' or the '}' closing the TriG graph, and
+		/// continues. Triples of a skipped statement are not passed on. handler
+		/// is called with each error.
+		void recover(const ErrorHandler &handler)
+		{
+			if (!m_buffer) {
+				m_buffer = std::unique_ptr<StatementBuffer>(new StatementBuffer(m_sink));
+				m_sink = m_buffer.get();
+			}
+			m_errorHandler = handler;
 		}
+		
+		/// Checks every IRI against RFC 3987, an invalid one is a ParseException.
+		void validateIris() { m_validateIris = true; }
+		
+		/// Checks the lexical form of numbers, booleans, dates and times, an invalid one is a ParseException.
+		void validateLiterals() { m_validateLiterals = true; }
+		
+		/// Writes valid numbers and booleans in their canonical form, e.g. 007 as 7 and 1 as true.
+		void canonicalLiterals() { m_canonicalLiterals = true; }
+		
+		State state() const;
+		
+		void restore(const State &state);
+		
+		/// The syntax for a file name: TriG for .trig, N-Quads for .nq, Turtle otherwise.
+		static Syntax syntax(const std::string &fileName);
 
 		int line() const { return m_lexer.lineno(); }
+		
+		/// How often a relative IRI was found in the cache of resolved IRIs.
+		std::uint64_t resolveCacheHits() const { return m_resolveCache.hits(); }
+		std::uint64_t resolveCacheMisses() const { return m_resolveCache.misses(); }
 	};
 
 }
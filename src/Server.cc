@@ -0,0 +1,361 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+#include <cerrno>
+#include <streambuf>
+#include <exception>
+
+#include "Server.hh"
+#include "Parser.hh"
+#include "Binary.hh"
+#include "OutputFile.hh"
+#include "FileDescriptorBuffer.hh"
+
+#ifndef _WIN32
+#	include <csignal>
+#	include <unistd.h>
+#	include <sys/socket.h>
+#	include <sys/stat.h>
+#	include <sys/time.h>
+#	include <sys/un.h>
+#endif
+
+namespace turtle {
+	
+#ifndef _WIN32
+	
+	namespace {
+		
+		void writeAll(int fd, const char *data, std::size_t length)
+		{
+			while (length > 0) {
+				ssize_t n = ::write(fd, data, length);
+				if (n < 0 && errno == EINTR)
+					continue;
+				if (n <= 0)
+					throw IOException(std::string("error writing to socket: ") + std::strerror(errno));
+				data += n;
+				length -= n;
+			}
+		}
+		
+		///
+		/// Writes the output as length prefixed chunks.
+		///
+		class ChunkOutputBuffer : public std::streambuf {
+			int m_fd;
+			std::vector<char> &m_buffer;
+			
+			void flushChunk()
+			{
+				std::size_t length = pptr() - pbase();
+				if (length == 0)
+					return;
+				
+				std::string header;
+				StringOutputBuffer out(header);
+				binary::writeVarInt(&out, length);
+				writeAll(m_fd, header.data(), header.length());
+				writeAll(m_fd, pbase(), length);
+				setp(m_buffer.data(), m_buffer.data() + m_buffer.size());
+			}
+			
+		protected:
+			int_type overflow(int_type c) override
+			{
+				flushChunk();
+				if (!traits_type::eq_int_type(c, traits_type::eof())) {
+					*pptr() = traits_type::to_char_type(c);
+					pbump(1);
+				}
+				
+				return traits_type::not_eof(c);
+			}
+			
+			int sync() override
+			{
+				flushChunk();
+				
+				return 0;
+			}
+			
+		public:
+			ChunkOutputBuffer(int fd, std::vector<char> &buffer) : std::streambuf(), m_fd(fd), m_buffer(buffer)
+			{
+				setp(m_buffer.data(), m_buffer.data() + m_buffer.size());
+			}
+			
+			/// flushes the output and writes the final chunk with the status
+			void finish(const std::string &status)
+			{
+				flushChunk();
+				
+				std::string trailer;
+				StringOutputBuffer out(trailer);
+				binary::writeVarInt(&out, 0);
+				binary::writeString(&out, status);
+				writeAll(m_fd, trailer.data(), trailer.length());
+			}
+		};
+		
+		sockaddr_un address(const std::string &path)
+		{
+			sockaddr_un addr;
+			std::memset(&addr, 0, sizeof(addr));
+			addr.sun_family = AF_UNIX;
+			
+			if (path.length() >= sizeof(addr.sun_path))
+				throw IOException("socket path too long: " + path);
+			
+			std::strcpy(addr.sun_path, path.c_str());
+			
+			return addr;
+		}
+		
+		/// Removes a socket left behind at path, refuses to remove anything else.
+		void removeStale(const std::string &path)
+		{
+			struct stat st;
+			if (::lstat(path.c_str(), &st) != 0) {
+				if (errno == ENOENT)
+					return;
+				throw IOException("error accessing " + path + ": " + std::strerror(errno));
+			}
+			
+			if (!S_ISSOCK(st.st_mode))
+				throw IOException(path + " exists and is not a socket");
+			
+			::unlink(path.c_str());
+		}
+		
+		void setTimeouts(int fd, int seconds)
+		{
+			timeval timeout;
+			timeout.tv_sec = seconds;
+			timeout.tv_usec = 0;
+			
+			::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+			::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+		}
+	}
+	
+	Server::Server(const std::string &path, unsigned threads, Handler handler) :
+		m_path(path), m_handler(handler), m_socket(-1), m_stop(false), m_connections(), m_mutex(), m_ready(), m_workers()
+	{
+		std::signal(SIGPIPE, SIG_IGN);
+		
+		sockaddr_un addr = address(path);
+		removeStale(path);
+		
+		m_socket = ::socket(AF_UNIX, SOCK_STREAM, 0);
+		if (m_socket < 0)
+			throw IOException(std::string("error creating socket: ") + std::strerror(errno));
+		
+		if (::bind(m_socket, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 || ::listen(m_socket, 64) != 0) {
+			std::string message = std::strerror(errno);
+			::close(m_socket);
+			throw IOException("error listening on " + path + ": " + message);
+		}
+		
+		for (unsigned i = 0; i < std::max(1u, threads); i++)
+			m_workers.emplace_back(&Server::work, this);
+	}
+	
+	Server::~Server()
+	{
+		stop();
+		
+		for (std::thread &t : m_workers)
+			t.join();
+		
+		for (int connection : m_connections)
+			::close(connection);
+		
+		::close(m_socket);
+		::unlink(m_path.c_str());
+	}
+	
+	void Server::run()
+	{
+		for (;;) {
+			int connection = ::accept(m_socket, nullptr, nullptr);
+			
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (m_stop) {
+				if (connection >= 0)
+					::close(connection);
+				return;
+			}
+			
+			if (connection >= 0) {
+				setTimeouts(connection, TIMEOUT);
+				m_connections.push_back(connection);
+				m_ready.notify_one();
+			}
+		}
+	}
+	
+	void Server::stop()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stop = true;
+		}
+		m_ready.notify_all();
+		
+		::shutdown(m_socket, SHUT_RDWR); // wakes up accept()
+	}
+	
+	void Server::work()
+	{
+		std::vector<char> buffer(CHUNK_SIZE);
+		
+		for (;;) {
+			int connection;
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_ready.wait(lock, [this]() { return m_stop || !m_connections.empty(); });
+				if (m_stop)
+					return;
+				
+				connection = m_connections.front();
+				m_connections.pop_front();
+			}
+			
+			try {
+				serve(connection, buffer);
+			} catch (IOException &e) {
+				// client went away
+			}
+			
+			::close(connection);
+		}
+	}
+	
+	void Server::serve(int connection, std::vector<char> &buffer)
+	{
+		FileDescriptorInputBuffer in(connection);
+		
+		std::string line;
+		for (int c = in.sbumpc(); c != '\n' && line.length() <= MAX_REQUEST_LENGTH; c = in.sbumpc()) {
+			if (c == std::streambuf::traits_type::eof())
+				return; // closed or timed out
+			line.push_back(static_cast<char>(c));
+		}
+		
+		ChunkOutputBuffer chunks(connection, buffer);
+		std::ostream out(&chunks);
+		
+		std::string status;
+		Request request;
+		if (line.length() > MAX_REQUEST_LENGTH) {
+			status = "request too long";
+		} else if (!parse(line, request)) {
+			status = "malformed request";
+		} else {
+			try {
+				m_handler(request, out);
+			} catch (ParseException &e) {
+				status = e.line() == -1 ? std::string("parse error: ") + e.what() : "parse error at line " + std::to_string(e.line()) + ": " + e.what();
+			} catch (std::exception &e) {
+				status = e.what();
+			}
+		}
+		
+		chunks.finish(status);
+	}
+	
+	std::string Server::request(const std::string &path, const Request &request, std::ostream &out)
+	{
+		std::signal(SIGPIPE, SIG_IGN);
+		
+		sockaddr_un addr = address(path);
+		
+		int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+		if (fd < 0 || ::connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0) {
+			std::string message = std::strerror(errno);
+			if (fd >= 0)
+				::close(fd);
+			throw IOException("error connecting to " + path + ": " + message);
+		}
+		
+		std::string status;
+		FileDescriptorInputBuffer in(fd);
+		try {
+			std::string line = request.input + '\t' + request.format + '\t' + request.base + '\n';
+			writeAll(fd, line.data(), line.length());
+			
+			std::string chunk;
+			for (std::uint64_t length = binary::readVarInt(&in); length > 0; length = binary::readVarInt(&in)) {
+				binary::readBytes(&in, chunk, length);
+				out.write(chunk.data(), chunk.length());
+			}
+			binary::readString(&in, status);
+		} catch (BinaryFormatException &e) {
+			::close(fd);
+			if (in.error())
+				throw IOException("error reading from " + path + ": " + std::strerror(in.error()));
+			throw IOException("connection to " + path + " closed unexpectedly");
+		} catch (...) {
+			::close(fd);
+			throw;
+		}
+		
+		::close(fd);
+		
+		return status;
+	}
+	
+#else
+	
+	Server::Server(const std::string &path, unsigned threads, Handler handler) :
+		m_path(path), m_handler(handler), m_socket(-1), m_stop(false), m_connections(), m_mutex(), m_ready(), m_workers()
+	{
+		throw IOException("--serve is not supported on Windows");
+	}
+	
+	Server::~Server() {}
+	void Server::run() {}
+	void Server::stop() {}
+	void Server::work() {}
+	void Server::serve(int connection, std::vector<char> &buffer) {}
+	
+	std::string Server::request(const std::string &path, const Request &request, std::ostream &out)
+	{
+		throw IOException("--connect is not supported on Windows");
+	}
+	
+#endif // _WIN32
+	
+	bool Server::parse(const std::string &line, Request &request)
+	{
+		std::string::size_type tab1 = line.find('\t');
+		std::string::size_type tab2 = tab1 == std::string::npos ? std::string::npos : line.find('\t', tab1 + 1);
+		
+		request.input  = line.substr(0, tab1);
+		request.format = tab1 == std::string::npos ? std::string() : line.substr(tab1 + 1, tab2 == std::string::npos ? std::string::npos : tab2 - tab1 - 1);
+		request.base   = tab2 == std::string::npos ? std::string() : line.substr(tab2 + 1);
+		
+		if (!request.base.empty() && request.base.back() == '\r')
+			request.base.pop_back();
+		
+		return !request.input.empty() && request.input != "-" && request.base.find('\t') == std::string::npos;
+	}
+	
+}
@@ -0,0 +1,96 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef N3_SERVER_HH
+#define N3_SERVER_HH
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <ostream>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace turtle {
+	
+	///
+	/// Serves translation requests on a Unix domain socket, so that short
+	/// translations do not pay for starting a process.
+	///
+	/// A request is a single line "input-path TAB format TAB base-uri LF",
+	/// format and base-uri may be empty. The response is the output in
+	/// chunks, each a varint length followed by that many bytes, ended by a
+	/// chunk of length 0 and a status string (varint length and bytes),
+	/// which is empty on success and holds the error message otherwise.
+	///
+	/// Connections are handled by a fixed pool of threads, each keeping its
+	/// output buffer between requests.
+	///
+	class Server {
+	public:
+		struct Request {
+			std::string input;
+			std::string format;
+			std::string base;
+		};
+		
+		/// writes the translation of request to out, throws on errors
+		typedef std::function<void (const Request &request, std::ostream &out)> Handler;
+		
+		static const std::size_t CHUNK_SIZE = 64 * 1024;
+		static const std::size_t MAX_REQUEST_LENGTH = 64 * 1024;
+		static const int TIMEOUT = 30; // seconds a client may stall reading or writing
+		
+	private:
+		std::string m_path;
+		Handler m_handler;
+		int m_socket;
+		bool m_stop;
+		std::deque<int> m_connections;
+		std::mutex m_mutex;
+		std::condition_variable m_ready;
+		std::vector<std::thread> m_workers;
+		
+		void work();
+		void serve(int connection, std::vector<char> &buffer);
+		
+	public:
+		/// Creates the socket at path, replacing a stale socket but nothing else. Throws IOException.
+		Server(const std::string &path, unsigned threads, Handler handler);
+		
+		Server(const Server &) = delete;
+		Server &operator=(const Server &) = delete;
+		
+		~Server();
+		
+		/// Accepts connections until stop() is called.
+		void run();
+		
+		void stop();
+		
+		/// Parses a request line (without LF), false when it is malformed.
+		static bool parse(const std::string &line, Request &request);
+		
+		/// Sends request to the server at path and copies the output to out.
+		/// Returns the status, empty on success. Throws IOException when the server can not be reached.
+		static std::string request(const std::string &path, const Request &request, std::ostream &out);
+	};
+
+}
+
+#endif /* N3_SERVER_HH */
@@ -0,0 +1,196 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#include "ShardingSink.hh"
+
+#include <functional>
+#include <sstream>
+
+namespace turtle {
+	
+	void ShardingSink::Shard::start()
+	{
+		m_thread = std::thread(&Shard::run, this);
+	}
+	
+	void ShardingSink::Shard::add(Event &&event)
+	{
+		m_batch.push_back(std::move(event));
+		
+		if (m_batch.size() >= BATCH_SIZE)
+			flush();
+	}
+	
+	void ShardingSink::Shard::flush()
+	{
+		if (m_batch.empty())
+			return;
+		
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_ready.wait(lock, [this] { return m_queue.size() < MAX_QUEUED_BATCHES; });
+		m_queue.push_back(std::move(m_batch));
+		lock.unlock();
+		m_ready.notify_all();
+		
+		m_batch = Batch();
+		m_batch.reserve(BATCH_SIZE);
+	}
+	
+	void ShardingSink::Shard::end()
+	{
+		if (!m_thread.joinable())
+			return;
+		
+		flush();
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_done = true;
+		}
+		m_ready.notify_all();
+		m_thread.join();
+	}
+	
+	void ShardingSink::Shard::run()
+	{
+		m_sink->start();
+		
+		for (;;) {
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_ready.wait(lock, [this] { return m_done || !m_queue.empty(); });
+			if (m_queue.empty())
+				break;
+			
+			Batch batch = std::move(m_queue.front());
+			m_queue.pop_front();
+			lock.unlock();
+			m_ready.notify_all();
+			
+			for (const Event &e : batch) {
+				if (e.type == Event::TRIPLE && e.graph)
+					m_sink->quad(*e.subject, *e.property, *e.object, *e.graph);
+				else if (e.type == Event::TRIPLE)
+					m_sink->triple(*e.subject, *e.property, *e.object);
+				else if (e.type == Event::PREFIX)
+					m_sink->prefix(e.prefix, e.value);
+				else
+					m_sink->document(e.value);
+			}
+		}
+		
+		m_sink->end();
+	}
+	
+	
+	
+	ShardingSink::ShardingSink(std::vector<std::unique_ptr<TripleSink>> &&sinks, Key key) : TripleSink(), m_shards(), m_key(key), m_started(false)
+	{
+		for (auto &sink : sinks)
+			m_shards.emplace_back(new Shard(std::move(sink)));
+	}
+	
+	ShardingSink::~ShardingSink()
+	{
+		end();
+	}
+	
+	void ShardingSink::start()
+	{
+		if (m_started)
+			return;
+		
+		for (auto &shard : m_shards)
+			shard->start();
+		
+		m_started = true;
+	}
+	
+	void ShardingSink::end()
+	{
+		for (auto &shard : m_shards)
+			shard->end();
+	}
+	
+	void ShardingSink::document(const std::string &source)
+	{
+		for (auto &shard : m_shards) {
+			Event e(Event::DOCUMENT);
+			e.value = source;
+			shard->add(std::move(e));
+		}
+	}
+	
+	void ShardingSink::prefix(const std::string &prefix, const std::string &ns)
+	{
+		for (auto &shard : m_shards) {
+			Event e(Event::PREFIX);
+			e.prefix = prefix;
+			e.value  = ns;
+			shard->add(std::move(e));
+		}
+	}
+	
+	std::size_t ShardingSink::shard(const Resource &subject, const URIResource &property) const
+	{
+		std::hash<std::string> hash;
+		std::size_t h;
+		
+		if (m_key == PREDICATE) {
+			h = hash(property.uri());
+		} else if (const URIResource *u = dynamic_cast<const URIResource *>(&subject)) {
+			h = hash(u->uri());
+		} else if (const BlankNode *b = dynamic_cast<const BlankNode *>(&subject)) {
+			h = hash(b->id());
+		} else {
+			std::ostringstream s;
+			s << subject;
+			h = hash(s.str());
+		}
+		
+		return h % m_shards.size();
+	}
+	
+	void ShardingSink::triple(const Resource &subject, const URIResource &property, const N3Node &object)
+	{
+		Event e(Event::TRIPLE);
+		e.subject.reset(subject.clone());
+		e.property.reset(property.clone());
+		e.object.reset(object.clone());
+		
+		m_shards[shard(subject, property)]->add(std::move(e));
+	}
+	
+	void ShardingSink::quad(const Resource &subject, const URIResource &property, const N3Node &object, const Resource &graph)
+	{
+		Event e(Event::TRIPLE);
+		e.subject.reset(subject.clone());
+		e.property.reset(property.clone());
+		e.object.reset(object.clone());
+		e.graph.reset(graph.clone());
+		
+		m_shards[shard(subject, property)]->add(std::move(e));
+	}
+	
+	unsigned ShardingSink::count() const
+	{
+		unsigned n = 0;
+		for (auto &shard : m_shards)
+			n += shard->sink().count();
+		
+		return n;
+	}
+	
+}
@@ -0,0 +1,105 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#ifndef N3_SHARDINGSINK_HH
+#define N3_SHARDINGSINK_HH
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "Parser.hh"
+#include "Model.hh"
+
+namespace turtle {
+	
+	///
+	/// Distributes triples over several sinks, by a hash of the subject or by
+	/// predicate. Every shard sink runs on its own thread and receives all
+	/// document and prefix events, so that every shard is self-contained.
+	///
+	class ShardingSink : public TripleSink {
+	public:
+		enum Key { SUBJECT, PREDICATE };
+		
+	private:
+		struct Event {
+			enum Type { TRIPLE, PREFIX, DOCUMENT } type;
+			std::unique_ptr<Resource> subject;
+			std::unique_ptr<URIResource> property;
+			std::unique_ptr<N3Node> object;
+			std::unique_ptr<Resource> graph; // null for the default graph
+			std::string prefix;
+			std::string value; // namespace or document
+			
+			explicit Event(Type t) : type(t), subject(), property(), object(), graph(), prefix(), value() {}
+		};
+		
+		typedef std::vector<Event> Batch;
+		
+		class Shard {
+			std::unique_ptr<TripleSink> m_sink;
+			Batch m_batch;
+			std::deque<Batch> m_queue;
+			bool m_done;
+			std::mutex m_mutex;
+			std::condition_variable m_ready;
+			std::thread m_thread;
+			
+			void run();
+			
+		public:
+			explicit Shard(std::unique_ptr<TripleSink> &&sink) : m_sink(std::move(sink)), m_batch(), m_queue(), m_done(false), m_mutex(), m_ready(), m_thread() {}
+			
+			void start();
+			void add(Event &&event);
+			void flush();
+			void end();
+			
+			const TripleSink &sink() const { return *m_sink; }
+		};
+		
+		static const std::size_t BATCH_SIZE = 1024;
+		static const std::size_t MAX_QUEUED_BATCHES = 16;
+		
+		std::vector<std::unique_ptr<Shard>> m_shards;
+		Key m_key;
+		bool m_started;
+		
+		std::size_t shard(const Resource &subject, const URIResource &property) const;
+		
+	public:
+		ShardingSink(std::vector<std::unique_ptr<TripleSink>> &&sinks, Key key);
+		~ShardingSink();
+		
+		void start() override;
+		void end() override;
+		void document(const std::string &source) override;
+		void prefix(const std::string &prefix, const std::string &ns) override;
+		void triple(const Resource &subject, const URIResource &property, const N3Node &object) override;
+		void quad(const Resource &subject, const URIResource &property, const N3Node &object, const Resource &graph) override;
+		unsigned count() const override;
+	};
+
+}
+
+#endif /* N3_SHARDINGSINK_HH */
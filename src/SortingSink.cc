@@ -0,0 +1,376 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "SortingSink.hh"
+
+#include <algorithm>
+#include <cstring>
+#include <queue>
+
+#include "BinaryReader.hh"
+
+namespace turtle {
+	
+	namespace {
+		
+		const std::size_t RECORD_OVERHEAD = sizeof(std::string);
+		
+		///
+		/// Walks a record, which BinaryTermEncoder wrote without references.
+		///
+		struct RecordCursor {
+			const unsigned char *p;
+			const unsigned char *end;
+			
+			std::uint64_t varInt()
+			{
+				std::uint64_t value = 0;
+				for (int shift = 0; p != end; shift += 7) {
+					unsigned char c = *p++;
+					value |= static_cast<std::uint64_t>(c & 0x7F) << shift;
+					if (!(c & 0x80))
+						break;
+				}
+				
+				return value;
+			}
+			
+			std::size_t string(const unsigned char **data)
+			{
+				std::size_t length = static_cast<std::size_t>(varInt());
+				*data = p;
+				p += length;
+				
+				return length;
+			}
+		};
+		
+		int compare(std::uint64_t a, std::uint64_t b)
+		{
+			return a < b ? -1 : a > b;
+		}
+		
+		/// Compares the bytes of two strings, not the lengths in front of them.
+		int compareStrings(RecordCursor &a, RecordCursor &b)
+		{
+			const unsigned char *x, *y;
+			std::size_t m = a.string(&x);
+			std::size_t n = b.string(&y);
+			
+			int c = std::memcmp(x, y, std::min(m, n));
+			
+			return c ? c : compare(m, n);
+		}
+		
+		/// IRIs, blank node labels and language tags, which are always written in full
+		int compareReferences(RecordCursor &a, RecordCursor &b)
+		{
+			a.varInt();
+			b.varInt();
+			
+			return compareStrings(a, b);
+		}
+		
+		/// Terms of different kinds are ordered by their tag, integers by value.
+		int compareTerms(RecordCursor &a, RecordCursor &b)
+		{
+			BinaryTag::Type s = *a.p++;
+			BinaryTag::Type t = *b.p++;
+			if (s != t)
+				return s < t ? -1 : 1;
+			
+			switch (s) {
+				case BinaryTag::Iri:
+				case BinaryTag::Blank:
+					return compareReferences(a, b);
+				case BinaryTag::LangString:
+				case BinaryTag::Typed: {
+					int c = compareStrings(a, b);
+					return c ? c : compareReferences(a, b);
+				}
+				case BinaryTag::Integer: {
+					std::int64_t x = binary::unzigzag(a.varInt());
+					std::int64_t y = binary::unzigzag(b.varInt());
+					return x < y ? -1 : x > y;
+				}
+				case BinaryTag::Decimal: {
+					std::int64_t x = binary::unzigzag(a.varInt());
+					std::int64_t y = binary::unzigzag(b.varInt());
+					int c = x < y ? -1 : x > y;
+					return c ? c : compare(a.varInt(), b.varInt());
+				}
+				case BinaryTag::True:
+				case BinaryTag::False:
+					return 0;
+				case BinaryTag::List: {
+					std::uint64_t m = a.varInt();
+					std::uint64_t n = b.varInt();
+					for (std::uint64_t i = 0; i < std::min(m, n); i++) {
+						int c = compareTerms(a, b);
+						if (c)
+							return c;
+					}
+					return compare(m, n);
+				}
+				default: // lexical forms
+					return compareStrings(a, b);
+			}
+		}
+		
+		/// Orders records by subject, predicate, object and graph, triples before quads.
+		bool recordLess(const std::string &a, const std::string &b)
+		{
+			const unsigned char *x = reinterpret_cast<const unsigned char *>(a.data());
+			const unsigned char *y = reinterpret_cast<const unsigned char *>(b.data());
+			RecordCursor r { x, x + a.length() };
+			RecordCursor s { y, y + b.length() };
+			
+			int c = compareTerms(r, s);
+			if (!c)
+				c = compareReferences(r, s);
+			if (!c)
+				c = compareTerms(r, s);
+			if (!c) {
+				bool quad = r.p != r.end, otherQuad = s.p != s.end;
+				c = quad != otherQuad ? (quad ? 1 : -1) : quad ? compareTerms(r, s) : 0;
+			}
+			
+			return c < 0;
+		}
+		
+		///
+		/// Reads the records of a sorted run, from a temporary file or from memory.
+		///
+		class RunReader {
+			TemporaryFile *m_file;
+			const std::vector<std::string> *m_run;
+			std::size_t m_index;
+			std::string m_record;
+			const std::string *m_current;
+		public:
+			explicit RunReader(TemporaryFile *file) : m_file(file), m_run(nullptr), m_index(0), m_record(), m_current(nullptr)
+			{
+				m_file->rewind();
+			}
+			
+			explicit RunReader(const std::vector<std::string> *run) : m_file(nullptr), m_run(run), m_index(0), m_record(), m_current(nullptr) {}
+			
+			bool next()
+			{
+				if (m_run) {
+					if (m_index == m_run->size())
+						return false;
+					m_current = &(*m_run)[m_index++];
+					
+					return true;
+				}
+				
+				if (std::streambuf::traits_type::eq_int_type(m_file->sgetc(), std::streambuf::traits_type::eof()))
+					return false;
+				
+				binary::readString(m_file, m_record);
+				
+				return true;
+			}
+			
+			const std::string &record() const { return m_run ? *m_current : m_record; }
+		};
+		
+		void writeRecord(TemporaryFile *file, const std::string &record)
+		{
+			binary::writeString(file, record);
+		}
+		
+		template<typename Output>
+		void mergeRuns(std::vector<RunReader> &readers, bool unique, Output &&output)
+		{
+			auto greater = [&readers](std::size_t a, std::size_t b) { return recordLess(readers[b].record(), readers[a].record()); };
+			std::priority_queue<std::size_t, std::vector<std::size_t>, decltype(greater)> queue(greater);
+			
+			for (std::size_t i = 0; i < readers.size(); i++) {
+				if (readers[i].next())
+					queue.push(i);
+			}
+			
+			std::string last;
+			bool first = true;
+			
+			while (!queue.empty()) {
+				std::size_t i = queue.top();
+				queue.pop();
+				
+				const std::string &record = readers[i].record();
+				if (!unique || first || record != last) {
+					output(record);
+					if (unique)
+						last = record;
+					first = false;
+				}
+				
+				if (readers[i].next())
+					queue.push(i);
+			}
+		}
+	}
+	
+	SortingSink::SortingSink(std::unique_ptr<TripleSink> &&sink, bool unique, std::size_t maxMemory) :
+		TripleSink(), m_sink(std::move(sink)), m_unique(unique), m_maxRunSize(std::max<std::size_t>(maxMemory / 2, 1)),
+		m_record(), m_buffer(m_record), m_encoder(&m_buffer, 0), m_run(), m_runSize(0), m_files(), m_spilling(), m_error(), m_received(0), m_emitted(0)
+	{
+		// nop
+	}
+	
+	void SortingSink::sort(Run &run, bool unique)
+	{
+		std::sort(run.begin(), run.end(), recordLess);
+		
+		if (unique)
+			run.erase(std::unique(run.begin(), run.end()), run.end());
+	}
+	
+	SortingSink::File SortingSink::spill(Run run, bool unique)
+	{
+		sort(run, unique);
+		
+		File file(new TemporaryFile());
+		for (const std::string &record : run)
+			writeRecord(file.get(), record);
+		
+		if (file->pubsync() != 0)
+			throw IOException("error writing temporary file");
+		
+		return file;
+	}
+	
+	SortingSink::File SortingSink::merge(std::vector<File> files, bool unique)
+	{
+		std::vector<RunReader> readers;
+		for (File &f : files)
+			readers.emplace_back(f.get());
+		
+		File file(new TemporaryFile());
+		mergeRuns(readers, unique, [&file](const std::string &record) { writeRecord(file.get(), record); });
+		
+		if (file->pubsync() != 0)
+			throw IOException("error writing temporary file");
+		
+		return file;
+	}
+	
+	void SortingSink::add(const Resource &subject, const URIResource &property, const N3Node &object, const Resource *graph)
+	{
+		m_record.clear();
+		subject.visit(m_encoder);
+		m_encoder.iri(property.uri());
+		object.visit(m_encoder);
+		if (graph)
+			graph->visit(m_encoder);
+		
+		m_runSize += m_record.capacity() + RECORD_OVERHEAD;
+		m_run.push_back(m_record);
+		m_received++;
+		
+		if (m_runSize >= m_maxRunSize) {
+			collect();
+			
+			// after a failure the output is lost anyway, end() reports it
+			if (m_error.empty())
+				m_spilling = std::async(std::launch::async, &SortingSink::spill, std::move(m_run), m_unique);
+			m_run = Run();
+			m_runSize = 0;
+		}
+	}
+	
+	void SortingSink::collect()
+	{
+		if (!m_spilling.valid())
+			return;
+		
+		try {
+			m_files.push_back(m_spilling.get());
+		} catch (std::exception &e) {
+			if (m_error.empty())
+				m_error = e.what();
+		}
+	}
+	
+	void SortingSink::emit(const std::string &record)
+	{
+		StringInputBuffer in(record);
+		BinaryTermDecoder decoder(&in, 0);
+		
+		std::shared_ptr<const N3Node> subject = decoder.term();
+		std::shared_ptr<const URIResource> property = decoder.iri();
+		std::shared_ptr<const N3Node> object = decoder.term();
+		
+		if (std::streambuf::traits_type::eq_int_type(in.sgetc(), std::streambuf::traits_type::eof())) {
+			m_sink->triple(*static_cast<const Resource *>(subject.get()), *property, *object);
+		} else {
+			std::shared_ptr<const N3Node> graph = decoder.term();
+			m_sink->quad(*static_cast<const Resource *>(subject.get()), *property, *object, *static_cast<const Resource *>(graph.get()));
+		}
+		m_emitted++;
+	}
+	
+	void SortingSink::end()
+	{
+		collect();
+		if (!m_error.empty())
+			throw IOException("error sorting triples in a temporary file: " + m_error);
+		
+		// reduce the number of files by merging groups of them in parallel
+		while (m_files.size() >= MERGE_WAYS) {
+			std::vector<std::future<File>> merges;
+			
+			for (std::size_t i = 0; i < m_files.size(); i += MERGE_WAYS) {
+				std::vector<File> group;
+				for (std::size_t j = i; j < std::min(i + MERGE_WAYS, m_files.size()); j++)
+					group.push_back(std::move(m_files[j]));
+				
+				merges.push_back(std::async(std::launch::async, &SortingSink::merge, std::move(group), m_unique));
+			}
+			
+			m_files.clear();
+			std::string error;
+			for (auto &f : merges) {
+				try {
+					m_files.push_back(f.get());
+				} catch (std::exception &e) {
+					if (error.empty())
+						error = e.what();
+				}
+			}
+			if (!error.empty())
+				throw IOException("error merging sorted temporary files: " + error);
+		}
+		
+		sort(m_run, m_unique);
+		
+		std::vector<RunReader> readers;
+		for (File &f : m_files)
+			readers.emplace_back(f.get());
+		readers.emplace_back(&m_run);
+		
+		mergeRuns(readers, m_unique, [this](const std::string &record) { emit(record); });
+		
+		m_files.clear();
+		m_run = Run();
+		m_runSize = 0;
+		
+		m_sink->end();
+	}
+	
+}
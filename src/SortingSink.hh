@@ -0,0 +1,106 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#ifndef N3_SORTINGSINK_HH
+#define N3_SORTINGSINK_HH
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <memory>
+#include <future>
+
+#include "Parser.hh"
+#include "Model.hh"
+#include "Binary.hh"
+#include "BinaryWriter.hh"
+#include "TemporaryFile.hh"
+
+namespace turtle {
+	
+	///
+	/// Passes triples on to another sink in sorted order, optionally without
+	/// duplicates. Triples are kept as self-contained binary records; when the
+	/// records exceed the memory budget, they are sorted and spilled to a
+	/// temporary file on a background thread, and the files are merged at the end.
+	/// A failing spill or merge is reported by end(), as an IOException.
+	///
+	/// Triples are ordered by subject, predicate, object and graph. IRIs and
+	/// lexical forms compare by their bytes, integers by value, and terms of
+	/// different kinds (IRI, blank node, literal types) by kind.
+	///
+	class SortingSink : public TripleSink {
+	public:
+		static const std::size_t DEFAULT_MAX_MEMORY = 512 * 1024 * 1024;
+		
+	private:
+		typedef std::vector<std::string> Run;
+		typedef std::unique_ptr<TemporaryFile> File;
+		
+		static const std::size_t MERGE_WAYS = 16;
+		
+		std::unique_ptr<TripleSink> m_sink;
+		bool m_unique;
+		std::size_t m_maxRunSize;
+		std::string m_record;
+		StringOutputBuffer m_buffer;
+		BinaryTermEncoder m_encoder;
+		Run m_run;
+		std::size_t m_runSize;
+		std::vector<File> m_files;
+		std::future<File> m_spilling;
+		std::string m_error; // of the first spill that failed
+		std::size_t m_received;
+		std::size_t m_emitted;
+		
+		static void sort(Run &run, bool unique);
+		static File spill(Run run, bool unique);
+		static File merge(std::vector<File> files, bool unique);
+		
+		void add(const Resource &subject, const URIResource &property, const N3Node &object, const Resource *graph);
+		void collect();
+		void emit(const std::string &record);
+		
+	public:
+		/// maxMemory is the budget for the triples kept in memory, which is shared by the run being filled and the run being spilled.
+		SortingSink(std::unique_ptr<TripleSink> &&sink, bool unique, std::size_t maxMemory = DEFAULT_MAX_MEMORY);
+		
+		void start() override { m_sink->start(); }
+		void end() override;
+		
+		void document(const std::string &source) override { m_sink->document(source); }
+		void prefix(const std::string &prefix, const std::string &ns) override { m_sink->prefix(prefix, ns); }
+		
+		void triple(const Resource &subject, const URIResource &property, const N3Node &object) override
+		{
+			add(subject, property, object, nullptr);
+		}
+		
+		void quad(const Resource &subject, const URIResource &property, const N3Node &object, const Resource &graph) override
+		{
+			add(subject, property, object, &graph);
+		}
+		
+		unsigned count() const override { return m_sink->count(); }
+		
+		/// The number of triples dropped as duplicates, valid after end().
+		std::size_t duplicates() const { return m_received - m_emitted; }
+	};
+
+}
+
+#endif /* N3_SORTINGSINK_HH */
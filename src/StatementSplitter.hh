@@ -0,0 +1,101 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef N3_STATEMENTSPLITTER_HH
+#define N3_STATEMENTSPLITTER_HH
+
+#include <cstddef>
+
+namespace turtle {
+	
+	///
+	/// Finds statement boundaries in Turtle, TriG and N-Quads text without
+	/// parsing it: a '.' outside IRIs, strings, comments and brackets that is
+	/// followed by white space or a comment, or a '}' closing a TriG graph.
+	/// Scanning must start at a boundary (or at the start of the document).
+	///
+	class StatementSplitter {
+		
+		static bool space(char c)
+		{
+			return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+		}
+		
+	public:
+		/// The offset just after the last complete statement in data, 0 if there is none.
+		/// When final, data ends the input, so a '.' at the very end counts as a boundary.
+		static std::size_t last(const char *data, std::size_t length, bool final = false)
+		{
+			std::size_t boundary = 0;
+			int depth = 0;
+			
+			for (std::size_t i = 0; i < length; i++) {
+				char c = data[i];
+				switch (c) {
+					case '#' :
+						while (i < length && data[i] != '\n')
+							i++;
+						break;
+					case '<' :
+						while (i < length && data[i] != '>')
+							i++;
+						break;
+					case '"' :
+					case '\'' :
+						if (i + 2 < length && data[i + 1] == c && data[i + 2] == c) {
+							for (i += 3; i + 2 < length && !(data[i] == c && data[i + 1] == c && data[i + 2] == c); i++) {
+								if (data[i] == '\\')
+									i++;
+							}
+							if (i + 2 >= length)
+								return boundary; // unterminated, wait for more input
+							i += 2;
+						} else if (i + 2 >= length) {
+							return boundary; // can not tell a long string from a short one yet
+						} else {
+							for (i++; i < length && data[i] != c && data[i] != '\n'; i++) {
+								if (data[i] == '\\')
+									i++;
+							}
+						}
+						break;
+					case '\\' :
+						i++; // escaped character in a local name
+						break;
+					case '[' : case '(' : case '{' :
+						depth++;
+						break;
+					case ']' : case ')' :
+						depth--;
+						break;
+					case '}' :
+						if (--depth == 0)
+							boundary = i + 1;
+						break;
+					case '.' :
+						if (depth == 0 && (i + 1 < length ? space(data[i + 1]) || data[i + 1] == '#' : final))
+							boundary = i + 1;
+						break;
+				}
+			}
+			
+			return boundary;
+		}
+	};
+
+}
+
+#endif /* N3_STATEMENTSPLITTER_HH */
@@ -0,0 +1,138 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#ifndef N3_TEMPORARYFILE_HH
+#define N3_TEMPORARYFILE_HH
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdint>
+#include <algorithm>
+#include <vector>
+#include <streambuf>
+
+#include "OutputFile.hh"
+
+namespace turtle {
+	
+	///
+	/// Buffered stream buffer on an anonymous temporary file, which is removed
+	/// when closed. Write to it first, then call rewind() and read it back,
+	/// or copy parts of it with copy() in between writes.
+	///
+	class TemporaryFile : public std::streambuf {
+		
+		static const std::size_t BUFFER_SIZE = 64 * 1024;
+		
+		std::FILE *m_file;
+		std::vector<char> m_buffer;
+		std::uint64_t m_written;
+		
+	protected:
+		int_type overflow(int_type c) override
+		{
+			if (sync() != 0)
+				return traits_type::eof();
+			
+			if (!traits_type::eq_int_type(c, traits_type::eof())) {
+				*pptr() = traits_type::to_char_type(c);
+				pbump(1);
+			}
+			
+			return traits_type::not_eof(c);
+		}
+		
+		int sync() override
+		{
+			std::size_t n = pptr() - pbase();
+			
+			if (n && std::fwrite(pbase(), 1, n, m_file) != n)
+				return -1;
+			
+			m_written += n;
+			setp(m_buffer.data(), m_buffer.data() + m_buffer.size());
+			
+			return 0;
+		}
+		
+		int_type underflow() override
+		{
+			std::size_t n = std::fread(m_buffer.data(), 1, m_buffer.size(), m_file);
+			
+			if (n == 0)
+				return traits_type::eof();
+			
+			setg(m_buffer.data(), m_buffer.data(), m_buffer.data() + n);
+			
+			return traits_type::to_int_type(*gptr());
+		}
+		
+	public:
+		TemporaryFile() : std::streambuf(), m_file(std::tmpfile()), m_buffer(BUFFER_SIZE), m_written(0)
+		{
+			if (!m_file)
+				throw IOException("error creating temporary file");
+			
+			setp(m_buffer.data(), m_buffer.data() + m_buffer.size());
+		}
+		
+		TemporaryFile(const TemporaryFile &) = delete;
+		TemporaryFile &operator=(const TemporaryFile &) = delete;
+		
+		~TemporaryFile()
+		{
+			std::fclose(m_file);
+		}
+		
+		/// The number of bytes written.
+		std::uint64_t size() const { return m_written + (pptr() - pbase()); }
+		
+		/// Copies length bytes starting at offset to out, after which writing may continue.
+		void copy(std::uint64_t offset, std::uint64_t length, std::streambuf *out)
+		{
+			if (sync() != 0 || std::fseek(m_file, offset, SEEK_SET) != 0)
+				throw IOException("error accessing temporary file");
+			
+			while (length) {
+				std::size_t n = std::fread(m_buffer.data(), 1, std::min<std::uint64_t>(length, m_buffer.size()), m_file);
+				if (n == 0)
+					throw IOException("error reading temporary file");
+				
+				out->sputn(m_buffer.data(), n);
+				length -= n;
+			}
+			
+			if (std::fseek(m_file, 0, SEEK_END) != 0)
+				throw IOException("error accessing temporary file");
+		}
+		
+		/// Flushes everything written and switches to reading from the start of the file.
+		void rewind()
+		{
+			if (sync() != 0 || std::fflush(m_file) != 0)
+				throw IOException("error writing temporary file");
+			
+			setp(nullptr, nullptr);
+			setg(nullptr, nullptr, nullptr);
+			
+			std::rewind(m_file);
+		}
+	};
+
+}
+
+#endif /* N3_TEMPORARYFILE_HH */
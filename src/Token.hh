@@ -37,6 +37,7 @@
 #define SPARQL_PREFIX                    1016
 #define SPARQL_BASE                      1017
 #define CARETCARET                       1018
+#define GRAPH                            1019
 */
 
 namespace turtle {
@@ -66,6 +67,7 @@ namespace turtle {
 		static const Type SparqlPrefix                 = 1016;
 		static const Type SparqlBase                   = 1017;
 		static const Type CaretCaret                   = 1018;
+		static const Type Graph                        = 1019;
 		
 	};
 	
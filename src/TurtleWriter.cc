@@ -0,0 +1,210 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "TurtleWriter.hh"
+
+namespace turtle {
+	
+	namespace {
+		
+		inline bool digit(char c) { return c >= '0' && c <= '9'; }
+		
+		inline bool nameChar(char c)
+		{
+			return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || digit(c) || c == '_' || c == '-' || c == ':';
+		}
+		
+		/// Skips [0-9]* starting at i, returns the number of digits.
+		std::size_t digits(const std::string &s, std::size_t &i)
+		{
+			std::size_t start = i;
+			while (i < s.length() && digit(s[i]))
+				++i;
+			
+			return i - start;
+		}
+		
+		std::size_t sign(const std::string &s)
+		{
+			return !s.empty() && (s[0] == '+' || s[0] == '-') ? 1 : 0;
+		}
+	}
+	
+	/// PN_LOCAL restricted to ASCII and without escapes
+	bool TurtleFormatter::isLocalName(const std::string &s, std::size_t from)
+	{
+		if (from == s.length())
+			return true;
+		
+		if (s[from] == '-' || s[from] == '.' || s.back() == '.')
+			return false;
+		
+		for (std::size_t i = from; i < s.length(); i++) {
+			if (!nameChar(s[i]) && s[i] != '.')
+				return false;
+		}
+		
+		return true;
+	}
+	
+	bool TurtleFormatter::isBoolean(const std::string &s)
+	{
+		return s == "true" || s == "false";
+	}
+	
+	bool TurtleFormatter::isInteger(const std::string &s)
+	{
+		std::size_t i = sign(s);
+		
+		return digits(s, i) > 0 && i == s.length();
+	}
+	
+	bool TurtleFormatter::isDecimal(const std::string &s)
+	{
+		std::size_t i = sign(s);
+		digits(s, i);
+		
+		if (i == s.length() || s[i] != '.')
+			return false;
+		
+		++i;
+		
+		return digits(s, i) > 0 && i == s.length();
+	}
+	
+	bool TurtleFormatter::isDouble(const std::string &s)
+	{
+		std::size_t i = sign(s);
+		std::size_t n = digits(s, i);
+		
+		if (i < s.length() && s[i] == '.') {
+			++i;
+			n += digits(s, i);
+		}
+		
+		if (n == 0 || i == s.length() || (s[i] != 'e' && s[i] != 'E'))
+			return false;
+		
+		++i;
+		if (i < s.length() && (s[i] == '+' || s[i] == '-'))
+			++i;
+		
+		return digits(s, i) > 0 && i == s.length();
+	}
+	
+	void TurtleFormatter::uri(const std::string &uri)
+	{
+		std::size_t end = uri.find_last_of("#/");
+		if (end == std::string::npos)
+			end = uri.find_last_of(':');
+		
+		if (end != std::string::npos && !m_namespaces.empty()) {
+			auto i = m_namespaces.find(uri.substr(0, end + 1));
+			
+			if (i != m_namespaces.end() && isLocalName(uri, end + 1)) {
+				const std::string &prefix = i->second;
+				
+				m_outbuf->sputn(prefix.c_str(), prefix.length());
+				m_outbuf->sputc(':');
+				m_outbuf->sputn(uri.c_str() + end + 1, uri.length() - end - 1);
+				
+				return;
+			}
+		}
+		
+		m_outbuf->sputc('<');
+		m_outbuf->sputn(uri.c_str(), uri.length());
+		m_outbuf->sputc('>');
+	}
+	
+	void TurtleFormatter::visit(const RDFList &list)
+	{
+		m_outbuf->sputc('(');
+		
+		for (const N3Node *n : list) {
+			m_outbuf->sputc(' ');
+			n->visit(*this);
+		}
+		
+		m_outbuf->sputn(" )", 2);
+	}
+	
+	
+	void TurtleWriter::endStatement()
+	{
+		if (m_subject.empty())
+			return;
+		
+		m_outbuf->sputn(" .", 2);
+		endl();
+		
+		m_subject.clear();
+		m_property.clear();
+	}
+	
+	void TurtleWriter::prefix(const std::string &prefix, const std::string &ns)
+	{
+		auto i = m_prefixes.find(prefix);
+		if (i != m_prefixes.end()) {
+			if (i->second == ns)
+				return;
+			
+			m_namespaces.erase(i->second);
+		}
+		
+		m_prefixes[prefix] = ns;
+		m_namespaces[ns] = prefix;
+		
+		endStatement();
+		
+		m_outbuf->sputn("@prefix ", 8);
+		write(prefix);
+		m_outbuf->sputn(": <", 3);
+		write(ns);
+		m_outbuf->sputn("> .", 3);
+		endl();
+	}
+	
+	void TurtleWriter::triple(const Resource &subject, const URIResource &property, const N3Node &object)
+	{
+		m_count++;
+		
+		if (format(subject) != m_subject) {
+			endStatement();
+			m_subject = m_term;
+			write(m_subject);
+			m_outbuf->sputc(' ');
+			m_property = predicate(property);
+		} else if (predicate(property) == m_property) {
+			m_outbuf->sputn(" ,", 2);
+			endl();
+			m_outbuf->sputn("\t\t", 2);
+			object.visit(m_formatter);
+			
+			return;
+		} else {
+			m_outbuf->sputn(" ;", 2);
+			endl();
+			m_outbuf->sputc('\t');
+			m_property = m_term;
+		}
+		
+		write(m_property);
+		m_outbuf->sputc(' ');
+		object.visit(m_formatter);
+	}
+	
+}
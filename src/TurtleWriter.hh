@@ -0,0 +1,202 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef N3_TURTLEWRITER_HH
+#define N3_TURTLEWRITER_HH
+
+#include <ostream>
+#include <string>
+#include <unordered_map>
+
+#include "Parser.hh"
+#include "Model.hh"
+#include "Binary.hh"
+
+#ifdef _WIN32
+#	define CTURTLE_CRLF
+#endif
+
+namespace turtle {
+	
+	class TurtleFormatter : public N3NodeVisitor {
+		
+		std::streambuf *m_outbuf;
+		const std::unordered_map<std::string, std::string> &m_namespaces; // namespace -> prefix
+		
+		void output(const std::string &s)
+		{
+			for (auto i = s.cbegin(); i != s.cend(); ++i) {
+				switch (*i) {
+					case '\n' : m_outbuf->sputc('\\'); m_outbuf->sputc('n');  break;
+					case '\r' : m_outbuf->sputc('\\'); m_outbuf->sputc('r');  break;
+					case '"'  : m_outbuf->sputc('\\'); m_outbuf->sputc('"');  break;
+					case '\\' : m_outbuf->sputc('\\'); m_outbuf->sputc('\\'); break;
+					default   : m_outbuf->sputc(*i);
+				}
+			}
+		}
+		
+		void output(const Literal &literal)
+		{
+			m_outbuf->sputc('"');
+			output(literal.lexical());
+			m_outbuf->sputn("\"^^", 3);
+			uri(literal.datatype());
+		}
+		
+		/// Writes the literal as a bare number or boolean if its lexical form allows it.
+		void output(const Literal &literal, bool (*bare)(const std::string &))
+		{
+			const std::string &lexical = literal.lexical();
+			
+			if (bare(lexical))
+				m_outbuf->sputn(lexical.c_str(), lexical.length());
+			else
+				output(literal);
+		}
+		
+	public:
+		TurtleFormatter(std::streambuf *outbuf, const std::unordered_map<std::string, std::string> &namespaces) : N3NodeVisitor(), m_outbuf(outbuf), m_namespaces(namespaces)
+		{
+			// nop
+		}
+		
+		/// Writes uri as a prefixed name if a prefix for it is known, as <uri> otherwise.
+		void uri(const std::string &uri);
+		
+		void visit(const URIResource &resource) override { uri(resource.uri()); }
+		void visit(const BlankNode &blankNode) override
+		{
+			const std::string &id = blankNode.id();
+			
+			m_outbuf->sputn("_:b", 3);
+			m_outbuf->sputn(id.c_str(), id.length());
+		}
+		
+		void visit(const Literal &literal) override        { output(literal); }
+		void visit(const BooleanLiteral &literal) override { output(literal, &isBoolean); }
+		void visit(const IntegerLiteral &literal) override { output(literal, &isInteger); }
+		void visit(const DoubleLiteral &literal)  override { output(literal, &isDouble);  }
+		void visit(const DecimalLiteral &literal) override { output(literal, &isDecimal); }
+		
+		void visit(const StringLiteral &literal) override
+		{
+			m_outbuf->sputc('"');
+			output(literal.lexical());
+			m_outbuf->sputc('"');
+			
+			const std::string &lang = literal.language();
+			if (!lang.empty()) {
+				m_outbuf->sputc('@');
+				m_outbuf->sputn(lang.c_str(), lang.length());
+			}
+		}
+		
+		void visit(const RDFList &list) override;
+		
+		static bool isLocalName(const std::string &s, std::size_t from);
+		static bool isBoolean(const std::string &s);
+		static bool isInteger(const std::string &s);
+		static bool isDecimal(const std::string &s);
+		static bool isDouble(const std::string &s);
+	};
+	
+	
+	///
+	/// Writes Turtle, using the prefixes seen so far for prefixed names.
+	/// Consecutive triples with the same subject are written as one statement,
+	/// using ';' between predicates and ',' between objects of one predicate.
+	/// Nothing is buffered besides the current subject and predicate.
+	///
+	class TurtleWriter : public TripleSink {
+		
+		std::streambuf *m_outbuf;
+		std::unordered_map<std::string, std::string> m_namespaces; // namespace -> prefix
+		std::unordered_map<std::string, std::string> m_prefixes;   // prefix -> namespace
+		TurtleFormatter m_formatter;
+		std::string m_term;
+		StringOutputBuffer m_termBuffer;
+		TurtleFormatter m_termFormatter;
+		std::string m_subject;
+		std::string m_property;
+		unsigned m_count;
+		
+		void endl()
+		{
+#ifdef CTURTLE_CRLF
+			m_outbuf->sputc('\r');
+#endif
+			m_outbuf->sputc('\n');
+		}
+		
+		const std::string &format(const N3Node &node)
+		{
+			m_term.clear();
+			node.visit(m_termFormatter);
+			
+			return m_term;
+		}
+		
+		const std::string &predicate(const URIResource &property)
+		{
+			if (property.wellKnown() == WellKnown::RDF_TYPE) {
+				m_term = "a";
+				
+				return m_term;
+			}
+			
+			return format(property);
+		}
+		
+		void write(const std::string &s)
+		{
+			m_outbuf->sputn(s.c_str(), s.length());
+		}
+		
+		void endStatement();
+		
+	public:
+		explicit TurtleWriter(std::ostream &out) : TripleSink(), m_outbuf(out.rdbuf()), m_namespaces(), m_prefixes(), m_formatter(out.rdbuf(), m_namespaces),
+			m_term(), m_termBuffer(m_term), m_termFormatter(&m_termBuffer, m_namespaces), m_subject(), m_property(), m_count(0)
+		{
+			// nop
+		}
+		
+		void start() override
+		{
+			// nop
+		}
+		
+		void end() override
+		{
+			endStatement();
+			m_outbuf->pubsync(); // flush
+		}
+		
+		void document(const std::string &source) override
+		{
+			// nop
+		}
+		
+		void prefix(const std::string &prefix, const std::string &ns) override;
+		void triple(const Resource &subject, const URIResource &property, const N3Node &object) override;
+		
+		unsigned count() const override { return m_count; }
+	};
+
+}
+
+#endif /* N3_TURTLEWRITER_HH */
@@ -14,6 +14,8 @@
 // limitations under the License.
 //
 
+#include <cstring>
+
 #include "Uri.hh"
 
 // ^(([^:/?#]+):)?(//([^/?#]*))?([^?#]*)(\?([^#]*))?(#(.*))?
@@ -21,158 +23,66 @@
 
 namespace turtle {
 
-	Uri::Uri(const Optional<std::string> &scheme,
-		     const Optional<std::string> &authority,
-		     const std::string &path,
-		     const Optional<std::string> &query,
-		     const Optional<std::string> &fragment)
-			: m_value(),
-			  m_scheme(std::string::npos),    m_schemeLength(std::string::npos),
-			  m_authority(std::string::npos), m_authorityLength(std::string::npos),
-			  m_host(std::string::npos),      m_hostLength(std::string::npos),
-			  m_path(std::string::npos),      m_pathLength(std::string::npos),
-			  m_query(std::string::npos),     m_queryLength(std::string::npos),
-			  m_fragment(std::string::npos)
+	static inline std::size_t find(const char *s, std::size_t from, std::size_t length, const char *chars)
 	{
-		if (scheme) {
-			m_scheme       = 0;
-			m_schemeLength = scheme->length();
-			m_value.append(*scheme).push_back(':');
-		}
-		
-		if (authority) {
-			m_value.append("//");
-			m_authority       = m_value.length();
-			m_authorityLength = authority->length();
-			m_value.append(*authority);
-			parseAuthorityComponents();
-		}
-		
-		m_path       = m_value.length();
-		m_pathLength = path.length();
-		m_value.append(path);
-		
-		if (query) {
-			m_value.push_back('?');
-			m_query       = m_value.length();
-			m_queryLength = query->length();
-			m_value.append(*query);
+		for (std::size_t i = from; i < length; i++) {
+			for (const char *c = chars; *c; c++) {
+				if (s[i] == *c)
+					return i;
+			}
 		}
 		
-		if (fragment) {
-			m_value.push_back('#');
-			m_fragment = m_value.length();
-			m_value.append(*fragment);
-		}	
+		return std::string::npos;
 	}
 	
-	void Uri::parseComponents()
+	void Uri::split(const char *uri, std::size_t length, Components &c)
 	{
-		std::size_t p = m_value.find_first_of(":/?#");
-		if (p == std::string::npos) {
-			m_path       = 0;
-			m_pathLength = m_value.length();
-		} else {
-			char c = m_value[p];
-			if (c == ':') {
-				if (p == 0) {
-					m_path = 0;
-					parsePath();
-				} else {
-					m_scheme       = 0;
-					m_schemeLength = p;
-					parseAuthority(p + 1);
-				}
-			} else if (c == '/') {
-				parseAuthority(0);
-			} else if (c == '?') {
-				m_path       = 0;
-				m_pathLength = p;
-				m_query      = p + 1;
-				parseQuery();
-			} else if (c == '#') {
-				m_path       = 0;
-				m_pathLength = p;
-				m_fragment   = p + 1;
-			}
-		}
+		const std::size_t npos = std::string::npos;
 		
-		parseAuthorityComponents();
-	}
-
-	void Uri::parseAuthority(std::size_t begin)
-	{
-		if (m_value.length() - begin >= 2 && m_value[begin] == '/' && m_value[begin + 1] == '/') {
-			begin += 2;
-			m_authority = begin;
-			std::size_t p = m_value.find_first_of("/?#", begin);
-			if (p != std::string::npos) {
-				m_authorityLength = p - begin;
-				char c = m_value[p];
-				if (c == '/') {
-					m_path = p;
-					parsePath();
-				} else if (c == '?') {
-					m_path       = p;
-					m_pathLength = 0;
-					m_query      = p + 1;
-					parseQuery();
-				} else {
-					m_path       = p;
-					m_pathLength = 0;
-					m_fragment   = p + 1;
-				}
-			} else {
-				m_authorityLength = m_value.length() - begin;
-				m_path            = m_value.length();
-				m_pathLength      = 0;
-			}
-		} else {
-			m_path = begin;
-			parsePath();
+		c = Components { npos, npos, npos, npos, npos, npos, npos, npos, npos };
+		
+		std::size_t begin = 0; // of the authority or the path
+		
+		std::size_t p = find(uri, 0, length, ":/?#");
+		if (p != npos && p > 0 && uri[p] == ':') {
+			c.scheme       = 0;
+			c.schemeLength = p;
+			begin          = p + 1;
 		}
-	}
-
-	void Uri::parsePath()
-	{
-		std::size_t p = m_value.find_first_of("?#", m_path);
-		if (p != std::string::npos) {
-			m_pathLength = p - m_path;
-			if (m_value[p] == '?') {
-				m_query = p + 1;
-				parseQuery();
-			} else {
-				m_fragment = p + 1;
-			}
+		
+		if (length - begin >= 2 && uri[begin] == '/' && uri[begin + 1] == '/') {
+			c.authority       = begin + 2;
+			p                 = find(uri, c.authority, length, "/?#");
+			c.authorityLength = (p == npos ? length : p) - c.authority;
+			c.path            = c.authority + c.authorityLength;
 		} else {
-			m_pathLength = m_value.length() - m_path;
+			c.path = begin;
 		}
-	}
-
-	void Uri::parseQuery()
-	{
-		std::size_t p = m_value.find('#', m_query);
-		if (p != std::string::npos) {
-			m_queryLength = p - m_query;
-			m_fragment    = p + 1;
+		
+		p = find(uri, c.path, length, "?#");
+		c.pathLength = (p == npos ? length : p) - c.path;
+		
+		if (p != npos && uri[p] == '?') {
+			c.query       = p + 1;
+			p             = find(uri, c.query, length, "#");
+			c.queryLength = (p == npos ? length : p) - c.query;
 		}
+		
+		if (p != npos)
+			c.fragment = p + 1;
 	}
 	
-	void Uri::parseAuthorityComponents()
+	void Uri::findHost(const char *authority, std::size_t length, std::size_t &host, std::size_t &hostLength)
 	{
-		if (m_authority == std::string::npos || m_authorityLength == 0)
-			return;
-		
-		const char *authoritybegin = m_value.c_str() + m_authority;
-		const char *authorityEnd   = authoritybegin  + m_authorityLength;
+		const char *authorityEnd = authority + length;
 		
 		const char *p = nullptr;
-		const char *h = std::string::traits_type::find(authoritybegin, m_authorityLength, '@');
+		const char *h = std::string::traits_type::find(authority, length, '@');
 		
 		if (h)
 			++h;
 		else
-			h = authoritybegin;
+			h = authority;
 		
 		if (h < authorityEnd) {
 			if (*h == '[') {
@@ -190,73 +100,118 @@ namespace turtle {
 			}
 		}
 		
-		m_host       = h - m_value.c_str();
-		m_hostLength = (p ? p : authorityEnd) - h;
+		host       = h - authority;
+		hostLength = (p ? p : authorityEnd) - h;
+		
+		if (hostLength == 0)
+			throw UriSyntaxException("host is empty " + std::string(authority, length));
+	}
+	
+	void Uri::parseComponents()
+	{
+		Components c;
+		split(m_value.data(), m_value.length(), c);
+		
+		m_scheme    = c.scheme;    m_schemeLength    = c.schemeLength;
+		m_authority = c.authority; m_authorityLength = c.authorityLength;
+		m_path      = c.path;      m_pathLength      = c.pathLength;
+		m_query     = c.query;     m_queryLength     = c.queryLength;
+		m_fragment  = c.fragment;
+		
+		parseAuthorityComponents();
+	}
+	
+	void Uri::parseAuthorityComponents()
+	{
+		if (m_authority == std::string::npos || m_authorityLength == 0)
+			return;
 		
-		if (m_hostLength == 0)
-			throw UriSyntaxException("host is empty " + m_value);
+		findHost(m_value.data() + m_authority, m_authorityLength, m_host, m_hostLength);
+		m_host += m_authority;
 	}
 
 	Uri Uri::resolve(const Uri &reference) const
 	{
 		if (reference.absolute())
 			return reference;
+		
+		std::string result;
+		resolve(reference.m_value.data(), reference.m_value.length(), result);
+		
+		return Uri(std::move(result));
+	}
 
-		Optional<std::string> scheme;
-		Optional<std::string> authority;
-		std::string path;
-		Optional<std::string> query;
-		
-		if (reference.m_scheme != std::string::npos) {
-			scheme    = reference.scheme();
-			authority = reference.authority();
-			path      = removeDotSegments(reference.m_value, reference.m_path, reference.m_pathLength);
-			query     = reference.query();
+	void Uri::resolve(const char *reference, std::size_t length, std::string &result) const
+	{
+		Components r;
+		split(reference, length, r);
+		
+		if (r.authority != std::string::npos && r.authorityLength > 0) {
+			std::size_t host, hostLength;
+			findHost(reference + r.authority, r.authorityLength, host, hostLength); // only validates
+		}
+		
+		if (r.scheme != std::string::npos) {
+			result.assign(reference, length);
+			return;
+		}
+		
+		result.clear();
+		
+		if (m_scheme != std::string::npos)
+			result.append(m_value, m_scheme, m_schemeLength).push_back(':');
+		
+		const char *query = nullptr; std::size_t queryLength = 0;
+		
+		if (r.authority != std::string::npos) {
+			result.append("//").append(reference + r.authority, r.authorityLength);
+			
+			std::size_t path = result.length();
+			result.append(reference + r.path, r.pathLength);
+			result.resize(path + removeDotSegments(&result[path], r.pathLength));
 			
-			if (!authority && path.empty() && !query) {
-				return reference; // correct?
+			if (r.query != std::string::npos) {
+				query = reference + r.query; queryLength = r.queryLength;
 			}
 		} else {
-			if (reference.m_authority != std::string::npos) {
-				authority = reference.authority();
-				path      = removeDotSegments(reference.m_value, reference.m_path, reference.m_pathLength);
-				query     = reference.query();
+			if (m_authority != std::string::npos)
+				result.append("//").append(m_value, m_authority, m_authorityLength);
+			
+			if (r.pathLength == 0) {
+				result.append(m_value, m_path, m_pathLength);
+				
+				if (r.query != std::string::npos) {
+					query = reference + r.query; queryLength = r.queryLength;
+				} else if (m_query != std::string::npos) {
+					query = m_value.data() + m_query; queryLength = m_queryLength;
+				}
 			} else {
-				if (reference.m_pathLength == 0) {
-					path = this->path();
-					if (reference.m_query != std::string::npos)
-						query = reference.query();
-					else
-						query = this->query();
-				} else {
-					if (reference.m_value[reference.m_path] == '/') {
-						path = removeDotSegments(reference.m_value, reference.m_path, reference.m_pathLength);
-					} else {
-						if (m_authority != std::string::npos && m_pathLength == 0) {
-							path.push_back('/');
-							path.append(reference.m_value, reference.m_path, reference.m_pathLength);
-						} else {
-							if (m_pathLength == 0) {
-								path = reference.path();
-							} else {
-								std::size_t n = m_value.rfind('/', m_path + m_pathLength);
-								if (n == std::string::npos || n < m_path)
-									path = reference.path();
-								else
-									path.append(m_value, m_path, n + 1 - m_path)
-									    .append(reference.m_value, reference.m_path, reference.m_pathLength);
-							}
-						}
-						path = removeDotSegments(path);
+				std::size_t path = result.length();
+				
+				if (reference[r.path] != '/') { // merge with the directory of the base path
+					if (m_authority != std::string::npos && m_pathLength == 0) {
+						result.push_back('/');
+					} else if (m_pathLength != 0) {
+						std::size_t n = m_value.rfind('/', m_path + m_pathLength);
+						if (n != std::string::npos && n >= m_path)
+							result.append(m_value, m_path, n + 1 - m_path);
 					}
-					query = reference.query();
 				}
-				authority = this->authority();
+				
+				result.append(reference + r.path, r.pathLength);
+				result.resize(path + removeDotSegments(&result[path], result.length() - path));
+				
+				if (r.query != std::string::npos) {
+					query = reference + r.query; queryLength = r.queryLength;
+				}
 			}
-			scheme = this->scheme();
 		}
 		
-		return Uri(scheme, authority, path, query, reference.fragment());
+		if (query)
+			result.append(1, '?').append(query, queryLength);
+		
+		if (r.fragment != std::string::npos)
+			result.append(1, '#').append(reference + r.fragment, length - r.fragment);
 	}
 
 	inline bool Uri::startsWith(const char *s, const char *prefix)
@@ -293,40 +248,32 @@ namespace turtle {
 	///       any) and any subsequent characters up to, but not including,
 	///       the next "/" character or the end of the input buffer.
 	///
-	std::string Uri::removeDotSegments(const std::string &input, std::size_t pos, std::size_t len)
+	std::size_t Uri::removeDotSegments(char *path, std::size_t length)
 	{
-		if (len == std::string::npos)
-			len = input.length() - pos;
-			
-		if (len == 0)
-			return std::string();
-			
-		std::string output(0, '\0');
-		output.reserve(len);
+		// the output, [path, o), never grows past the input still to be read, so this works in place
+		const char *i   = path;
+		const char *end = path + length;
+		char *o         = path;
+		
+		auto removeLastSegment = [path, &o]() {
+			while (o > path && *--o != '/')
+				;
+		};
 		
-		const char *i   = input.c_str() + pos;
-		const char *end = i + len;
-				
 		for (std::size_t left = end - i; left > 0; left = end - i) {
 			if (left >= 3 && startsWith(i, "../")) { // A1
 				i += 3;
 			} else if (left >= 2 && (startsWith(i, "./") || startsWith(i, "/./"))) { // A2, B1
 				i += 2;
 			} else if (left == 2 && startsWith(i, "/.")) { // B2
-				output.push_back('/');
+				*o++ = '/';
 				i = end;
 			} else if (left >= 4 && startsWith(i, "/../")) { // C1
 				i += 3;
-				std::size_t n = output.rfind('/');
-				if (n == std::string::npos)
-					n = 0;
-				output.erase(n);
+				removeLastSegment();
 			} else if (left == 3 && startsWith(i, "/..")) { // C2
-				std::size_t n = output.rfind('/');
-				if (n == std::string::npos)
-					n = 0;
-				output.erase(n);
-				output.push_back('/');
+				removeLastSegment();
+				*o++ = '/';
 				i = end;
 			} else if (left == 1 && *i == '.') { // D1
 				i = end;
@@ -336,12 +283,13 @@ namespace turtle {
 				const char *p = std::string::traits_type::find(i + 1, left - 1, '/');
 				if (!p)
 					p = end;
-				output.append(i, p - i);
+				std::memmove(o, i, p - i);
+				o += p - i;
 				i = p;
 			}
 		}
 		
-		return output;
+		return o - path;
 	}
 		
 	Uri::operator std::string() const
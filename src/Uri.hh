@@ -47,19 +47,22 @@ namespace turtle {
 		std::size_t m_query;     std::size_t m_queryLength;
 		std::size_t m_fragment;
 		
-		Uri(const Optional<std::string> &scheme,
-		    const Optional<std::string> &authority,
-		    const std::string &path,
-		    const Optional<std::string> &query,
-		    const Optional<std::string> &fragment);
+		/// Offsets into a uri, npos for an undefined component.
+		struct Components {
+			std::size_t scheme;    std::size_t schemeLength;
+			std::size_t authority; std::size_t authorityLength;
+			std::size_t path;      std::size_t pathLength;
+			std::size_t query;     std::size_t queryLength;
+			std::size_t fragment;
+		};
+		
+		static void split(const char *uri, std::size_t length, Components &components);
+		static void findHost(const char *authority, std::size_t length, std::size_t &host, std::size_t &hostLength);
 		
 		void parseComponents();
-		void parseAuthority(std::size_t begin);
 		void parseAuthorityComponents();
-		void parsePath();
-		void parseQuery();
 		
-		static std::string removeDotSegments(const std::string &input, std::size_t pos = 0, std::size_t len = std::string::npos);
+		static std::size_t removeDotSegments(char *path, std::size_t length);
 		static bool startsWith(const char *s, const char *prefix);
 
 	public:
@@ -154,6 +157,16 @@ namespace turtle {
 		}
 		
 		Uri resolve(const Uri &reference) const;
+		
+		/// Resolves reference against this uri into result, which is overwritten.
+		/// Works on offsets only, so no memory is allocated once result has grown
+		/// large enough.
+		void resolve(const char *reference, std::size_t length, std::string &result) const;
+		
+		void resolve(const std::string &reference, std::string &result) const
+		{
+			resolve(reference.data(), reference.length(), result);
+		}
 			
 		explicit operator std::string() const;
 			
@@ -20,12 +20,21 @@
 #include <cstdlib>
 #include <stdexcept>
 #include <algorithm>
+#include <vector>
+#include <set>
+#include <utility>
+#include <cerrno>
 
 #include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <dirent.h>
 
 #ifdef _WIN32
 #	include <io.h>     // _setmode
 #	include <fcntl.h>  // _O_BINARY
+#	include <direct.h> // _mkdir
+#	include <share.h>  // _SH_DENYNO
 #endif
 
 
@@ -43,7 +52,7 @@ namespace turtle {
 	//(Windows: OK, Linux: fail)
 	// Also PATH_MAX is only 255 on Windows
 	// Use _getcwd (Windows) getcwd (Linux) in stead?
-	std::string toUri(const std::string &file)
+	std::string absolutePath(const std::string &file)
 	{
 		char buf[PATH_MAX]; 
 #ifdef _WIN32
@@ -56,14 +65,23 @@ namespace turtle {
 		
 		std::replace(absPath.begin(), absPath.end(), '\\', '/');
 		
-		return "file:///" + absPath;
+		return absPath;
 #else
 		const char *rp = ::realpath(file.c_str(), buf);
 		
 		if (!rp)
 			throw std::runtime_error("could not determine the absolute path for " + file);
 			
-		return "file://" + std::string(rp);
+		return std::string(rp);
+#endif // _WIN32
+	}
+	
+	std::string toUri(const std::string &file)
+	{
+#ifdef _WIN32
+		return "file:///" + absolutePath(file);
+#else
+		return "file://" + absolutePath(file);
 #endif // _WIN32
 	}
 	
@@ -72,4 +90,114 @@ namespace turtle {
 		return access(fileName.c_str(), F_OK) == 0;
 	}
 	
+	std::uint64_t fileSize(const std::string &fileName)
+	{
+		struct stat st;
+		
+		return ::stat(fileName.c_str(), &st) == 0 ? static_cast<std::uint64_t>(st.st_size) : 0;
+	}
+	
+	bool truncate(const std::string &fileName, std::uint64_t size)
+	{
+#ifdef _WIN32
+		int fd;
+		if (::_sopen_s(&fd, fileName.c_str(), _O_RDWR | _O_BINARY, _SH_DENYNO, 0) != 0)
+			return false;
+		
+		bool ok = ::_chsize_s(fd, static_cast<__int64>(size)) == 0;
+		::_close(fd);
+		
+		return ok;
+#else
+		return ::truncate(fileName.c_str(), static_cast<off_t>(size)) == 0;
+#endif
+	}
+	
+	bool syncFile(const std::string &fileName)
+	{
+#ifdef _WIN32
+		int fd;
+		if (::_sopen_s(&fd, fileName.c_str(), _O_RDWR | _O_BINARY, _SH_DENYNO, 0) != 0)
+			return false;
+		
+		bool ok = ::_commit(fd) == 0;
+		::_close(fd);
+#else
+		int fd = ::open(fileName.c_str(), O_RDONLY);
+		if (fd < 0)
+			return false;
+		
+		bool ok = ::fsync(fd) == 0;
+		::close(fd);
+#endif
+		return ok;
+	}
+	
+	bool isDirectory(const std::string &fileName)
+	{
+		struct stat st;
+		
+		return ::stat(fileName.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+	}
+	
+	namespace {
+		
+		typedef std::set<std::pair<dev_t, ino_t>> Visited;
+		
+		void listFiles(const std::string &directory, std::vector<std::string> &files, Visited &visited)
+		{
+#ifndef _WIN32
+			// a symbolic link to a directory above would otherwise be followed forever
+			struct stat st;
+			if (::stat(directory.c_str(), &st) == 0 && !visited.insert(std::make_pair(st.st_dev, st.st_ino)).second)
+				return;
+#endif
+			
+			DIR *dir = ::opendir(directory.c_str());
+			if (!dir)
+				throw std::runtime_error("could not read directory " + directory);
+			
+			std::vector<std::string> names;
+			for (struct dirent *entry = ::readdir(dir); entry; entry = ::readdir(dir)) {
+				std::string name = entry->d_name;
+				if (name != "." && name != "..")
+					names.push_back(name);
+			}
+			::closedir(dir);
+			
+			std::sort(names.begin(), names.end());
+			
+			std::string prefix = directory.empty() || directory.back() == '/' ? directory : directory + '/';
+			for (const std::string &name : names) {
+				std::string path = prefix + name;
+				if (isDirectory(path))
+					listFiles(path, files, visited);
+				else
+					files.push_back(path);
+			}
+		}
+	}
+	
+	void listFiles(const std::string &directory, std::vector<std::string> &files)
+	{
+		Visited visited;
+		listFiles(directory, files, visited);
+	}
+	
+	bool makeDirectories(const std::string &directory)
+	{
+		if (directory.empty() || isDirectory(directory))
+			return true;
+		
+		std::string::size_type slash = directory.find_last_of('/', directory.length() - 2);
+		if (slash != std::string::npos && slash > 0 && !makeDirectories(directory.substr(0, slash)))
+			return false;
+		
+#ifdef _WIN32
+		return ::_mkdir(directory.c_str()) == 0 || errno == EEXIST;
+#else
+		return ::mkdir(directory.c_str(), 0777) == 0 || errno == EEXIST;
+#endif
+	}
+	
 }
@@ -17,15 +17,37 @@
 #ifndef N3_UTIL_HH
 #define N3_UTIL_HH
 
+#include <cstdint>
 #include <string>
+#include <vector>
 
 namespace turtle {
 
 	void useBinaryStreams();
 	
+	std::string absolutePath(const std::string &file);
+	
 	std::string toUri(const std::string &file);
 	
 	bool exists(const std::string &fileName);
+	
+	/// the size in bytes, 0 when the file does not exist
+	std::uint64_t fileSize(const std::string &fileName);
+	
+	/// Cuts fileName off at size bytes, false on failure.
+	bool truncate(const std::string &fileName, std::uint64_t size);
+	
+	/// Writes what the system buffers of fileName through to the disk, false on failure.
+	bool syncFile(const std::string &fileName);
+	
+	bool isDirectory(const std::string &fileName);
+	
+	/// Appends the paths of the files below directory to files, recursively, in sorted order.
+	/// A directory that is reached again through a symbolic link is skipped.
+	void listFiles(const std::string &directory, std::vector<std::string> &files);
+	
+	/// Creates directory and its missing parents, false on failure.
+	bool makeDirectories(const std::string &directory);
 }
 
 #endif /* N3_UTIL_HH */
@@ -0,0 +1,79 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <cstring>
+
+#include "WellKnown.hh"
+
+namespace turtle {
+	
+	namespace {
+		
+		constexpr char COMMON_PREFIX[] = "http://www.w3.org/";
+		constexpr std::size_t COMMON_PREFIX_LENGTH = sizeof(COMMON_PREFIX) - 1;
+		const std::size_t MAX_LENGTH = 64;
+		
+#define N3_WELL_KNOWN_LENGTH(name, iri) static_assert(sizeof(iri) - 1 <= MAX_LENGTH, "MAX_LENGTH is too small for " #name);
+		N3_WELL_KNOWN_IRIS(N3_WELL_KNOWN_LENGTH)
+#undef N3_WELL_KNOWN_LENGTH
+		
+		inline WellKnown::Iri match(const char *s, std::size_t length, const char *iri, std::size_t iriLength, WellKnown::Iri term)
+		{
+			return length == iriLength && std::memcmp(s, iri, length) == 0 ? term : WellKnown::NONE;
+		}
+		
+	}
+	
+	WellKnown::Iri WellKnown::lookup(const char *s, std::size_t length)
+	{
+		// all of them are W3C IRIs, which rules out most others without hashing them
+		if (length <= COMMON_PREFIX_LENGTH || std::memcmp(s, COMMON_PREFIX, COMMON_PREFIX_LENGTH) != 0)
+			return NONE;
+		
+		switch (hash(s, length)) {
+#define N3_WELL_KNOWN_CASE(name, iri) case hash(iri): return match(s, length, iri, sizeof(iri) - 1, name);
+			N3_WELL_KNOWN_IRIS(N3_WELL_KNOWN_CASE)
+#undef N3_WELL_KNOWN_CASE
+			default:
+				return NONE;
+		}
+	}
+	
+	WellKnown::Iri WellKnown::lookup(const std::string &ns, const std::string &local)
+	{
+		std::size_t length = ns.length() + local.length();
+		if (length > MAX_LENGTH)
+			return NONE;
+		
+		char iri[MAX_LENGTH];
+		std::memcpy(iri, ns.data(), ns.length());
+		std::memcpy(iri + ns.length(), local.data(), local.length());
+		
+		return lookup(iri, length);
+	}
+	
+	const char *WellKnown::iri(Iri term)
+	{
+		switch (term) {
+#define N3_WELL_KNOWN_IRI(name, iri) case name: return iri;
+			N3_WELL_KNOWN_IRIS(N3_WELL_KNOWN_IRI)
+#undef N3_WELL_KNOWN_IRI
+			default:
+				return "";
+		}
+	}
+
+}
@@ -0,0 +1,196 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef N3_WELLKNOWN_HH
+#define N3_WELLKNOWN_HH
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#define N3_RDF  "http://www.w3.org/1999/02/22-rdf-syntax-ns#"
+#define N3_RDFS "http://www.w3.org/2000/01/rdf-schema#"
+#define N3_OWL  "http://www.w3.org/2002/07/owl#"
+#define N3_XSD  "http://www.w3.org/2001/XMLSchema#"
+
+/// X(name, iri) for every well-known IRI.
+#define N3_WELL_KNOWN_IRIS(X) \
+	X(RDF_TYPE,                        N3_RDF "type") \
+	X(RDF_FIRST,                       N3_RDF "first") \
+	X(RDF_REST,                        N3_RDF "rest") \
+	X(RDF_NIL,                         N3_RDF "nil") \
+	X(RDF_PROPERTY,                    N3_RDF "Property") \
+	X(RDF_LIST,                        N3_RDF "List") \
+	X(RDF_STATEMENT,                   N3_RDF "Statement") \
+	X(RDF_SUBJECT,                     N3_RDF "subject") \
+	X(RDF_PREDICATE,                   N3_RDF "predicate") \
+	X(RDF_OBJECT,                      N3_RDF "object") \
+	X(RDF_VALUE,                       N3_RDF "value") \
+	X(RDF_LANG_STRING,                 N3_RDF "langString") \
+	X(RDF_XML_LITERAL,                 N3_RDF "XMLLiteral") \
+	X(RDFS_RESOURCE,                   N3_RDFS "Resource") \
+	X(RDFS_CLASS,                      N3_RDFS "Class") \
+	X(RDFS_LITERAL,                    N3_RDFS "Literal") \
+	X(RDFS_DATATYPE,                   N3_RDFS "Datatype") \
+	X(RDFS_CONTAINER,                  N3_RDFS "Container") \
+	X(RDFS_MEMBER,                     N3_RDFS "member") \
+	X(RDFS_SUB_CLASS_OF,               N3_RDFS "subClassOf") \
+	X(RDFS_SUB_PROPERTY_OF,            N3_RDFS "subPropertyOf") \
+	X(RDFS_DOMAIN,                     N3_RDFS "domain") \
+	X(RDFS_RANGE,                      N3_RDFS "range") \
+	X(RDFS_LABEL,                      N3_RDFS "label") \
+	X(RDFS_COMMENT,                    N3_RDFS "comment") \
+	X(RDFS_SEE_ALSO,                   N3_RDFS "seeAlso") \
+	X(RDFS_IS_DEFINED_BY,              N3_RDFS "isDefinedBy") \
+	X(OWL_THING,                       N3_OWL "Thing") \
+	X(OWL_NOTHING,                     N3_OWL "Nothing") \
+	X(OWL_CLASS,                       N3_OWL "Class") \
+	X(OWL_ONTOLOGY,                    N3_OWL "Ontology") \
+	X(OWL_OBJECT_PROPERTY,             N3_OWL "ObjectProperty") \
+	X(OWL_DATATYPE_PROPERTY,           N3_OWL "DatatypeProperty") \
+	X(OWL_ANNOTATION_PROPERTY,         N3_OWL "AnnotationProperty") \
+	X(OWL_FUNCTIONAL_PROPERTY,         N3_OWL "FunctionalProperty") \
+	X(OWL_INVERSE_FUNCTIONAL_PROPERTY, N3_OWL "InverseFunctionalProperty") \
+	X(OWL_TRANSITIVE_PROPERTY,         N3_OWL "TransitiveProperty") \
+	X(OWL_SYMMETRIC_PROPERTY,          N3_OWL "SymmetricProperty") \
+	X(OWL_RESTRICTION,                 N3_OWL "Restriction") \
+	X(OWL_ON_PROPERTY,                 N3_OWL "onProperty") \
+	X(OWL_SOME_VALUES_FROM,            N3_OWL "someValuesFrom") \
+	X(OWL_ALL_VALUES_FROM,             N3_OWL "allValuesFrom") \
+	X(OWL_HAS_VALUE,                   N3_OWL "hasValue") \
+	X(OWL_UNION_OF,                    N3_OWL "unionOf") \
+	X(OWL_INTERSECTION_OF,             N3_OWL "intersectionOf") \
+	X(OWL_EQUIVALENT_CLASS,            N3_OWL "equivalentClass") \
+	X(OWL_EQUIVALENT_PROPERTY,         N3_OWL "equivalentProperty") \
+	X(OWL_DISJOINT_WITH,               N3_OWL "disjointWith") \
+	X(OWL_INVERSE_OF,                  N3_OWL "inverseOf") \
+	X(OWL_SAME_AS,                     N3_OWL "sameAs") \
+	X(OWL_DIFFERENT_FROM,              N3_OWL "differentFrom") \
+	X(OWL_IMPORTS,                     N3_OWL "imports") \
+	X(OWL_VERSION_INFO,                N3_OWL "versionInfo") \
+	X(XSD_STRING,                      N3_XSD "string") \
+	X(XSD_BOOLEAN,                     N3_XSD "boolean") \
+	X(XSD_DECIMAL,                     N3_XSD "decimal") \
+	X(XSD_INTEGER,                     N3_XSD "integer") \
+	X(XSD_DOUBLE,                      N3_XSD "double") \
+	X(XSD_FLOAT,                       N3_XSD "float") \
+	X(XSD_DATE,                        N3_XSD "date") \
+	X(XSD_TIME,                        N3_XSD "time") \
+	X(XSD_DATE_TIME,                   N3_XSD "dateTime") \
+	X(XSD_DATE_TIME_STAMP,             N3_XSD "dateTimeStamp") \
+	X(XSD_DURATION,                    N3_XSD "duration") \
+	X(XSD_G_YEAR,                      N3_XSD "gYear") \
+	X(XSD_G_YEAR_MONTH,                N3_XSD "gYearMonth") \
+	X(XSD_G_MONTH,                     N3_XSD "gMonth") \
+	X(XSD_G_MONTH_DAY,                 N3_XSD "gMonthDay") \
+	X(XSD_G_DAY,                       N3_XSD "gDay") \
+	X(XSD_LONG,                        N3_XSD "long") \
+	X(XSD_INT,                         N3_XSD "int") \
+	X(XSD_SHORT,                       N3_XSD "short") \
+	X(XSD_BYTE,                        N3_XSD "byte") \
+	X(XSD_NON_NEGATIVE_INTEGER,        N3_XSD "nonNegativeInteger") \
+	X(XSD_POSITIVE_INTEGER,            N3_XSD "positiveInteger") \
+	X(XSD_NON_POSITIVE_INTEGER,        N3_XSD "nonPositiveInteger") \
+	X(XSD_NEGATIVE_INTEGER,            N3_XSD "negativeInteger") \
+	X(XSD_UNSIGNED_LONG,               N3_XSD "unsignedLong") \
+	X(XSD_UNSIGNED_INT,                N3_XSD "unsignedInt") \
+	X(XSD_UNSIGNED_SHORT,              N3_XSD "unsignedShort") \
+	X(XSD_UNSIGNED_BYTE,               N3_XSD "unsignedByte") \
+	X(XSD_ANY_URI,                     N3_XSD "anyURI") \
+	X(XSD_LANGUAGE,                    N3_XSD "language") \
+	X(XSD_NORMALIZED_STRING,           N3_XSD "normalizedString") \
+	X(XSD_TOKEN,                       N3_XSD "token") \
+	X(XSD_HEX_BINARY,                  N3_XSD "hexBinary") \
+	X(XSD_BASE64_BINARY,               N3_XSD "base64Binary")
+
+namespace turtle {
+	
+	///
+	/// The RDF, RDFS, OWL and XSD IRIs that get special treatment. lookup()
+	/// hashes an IRI once and confirms a match with a single memcmp. The
+	/// hashes of the known IRIs are computed at compile time as the labels of
+	/// a switch, so the hash is perfect for them: two IRIs with the same hash
+	/// would not compile.
+	///
+	class WellKnown {
+	public:
+		enum Iri {
+			NONE,
+#define N3_WELL_KNOWN_ENUM(name, iri) name,
+			N3_WELL_KNOWN_IRIS(N3_WELL_KNOWN_ENUM)
+#undef N3_WELL_KNOWN_ENUM
+			COUNT
+		};
+		
+	private:
+		static constexpr std::uint64_t word(const char *s, int i = 0)
+		{
+			return i == 8 ? 0 : static_cast<std::uint64_t>(static_cast<unsigned char>(s[i])) << (8 * i) | word(s, i + 1);
+		}
+		
+		static constexpr std::size_t length(const char *s)
+		{
+			return *s ? 1 + length(s + 1) : 0;
+		}
+		
+		static constexpr std::uint32_t mix(std::uint64_t a, std::uint64_t b, std::size_t length)
+		{
+			return static_cast<std::uint32_t>(((a * 0x9E3779B97F4A7C15ull) ^ ((b + length) * 0xC2B2AE3D27D4EB4Full)) >> 32);
+		}
+		
+	public:
+		/// The hash of a string literal of at least 16 characters, at compile time.
+		/// Only the length and the last 16 bytes are hashed, the well-known IRIs
+		/// differ there.
+		static constexpr std::uint32_t hash(const char *iri)
+		{
+			return mix(word(iri + length(iri) - 16), word(iri + length(iri) - 8), length(iri));
+		}
+		
+		/// The same hash at run time, length is at least 16.
+		static std::uint32_t hash(const char *s, std::size_t length)
+		{
+			return mix(load(s + length - 16), load(s + length - 8), length);
+		}
+		
+		/// Eight bytes as a little endian word.
+		static std::uint64_t load(const char *s)
+		{
+			std::uint64_t x;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+			std::memcpy(&x, s, 8);
+#else
+			x = word(s);
+#endif
+			return x;
+		}
+		
+		/// NONE if iri is not well-known.
+		static Iri lookup(const char *iri, std::size_t length);
+		
+		static Iri lookup(const std::string &iri) { return lookup(iri.data(), iri.length()); }
+		
+		/// The IRI ns followed by local, without building it on the heap.
+		static Iri lookup(const std::string &ns, const std::string &local);
+		
+		/// The IRI of term, empty for NONE.
+		static const char *iri(Iri term);
+	};
+
+}
+
+#endif /* N3_WELLKNOWN_HH */
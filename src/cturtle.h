@@ -0,0 +1,107 @@
+/*
+ * Copyright 2016 Giovanni Mels
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * C interface of libcturtle, for embedding the parser in other processes.
+ *
+ * Triples are passed to a callback as terms that point into the parser's
+ * own buffers. The pointers are only valid during the callback and the
+ * strings are not null terminated, use the lengths.
+ */
+
+#ifndef CTURTLE_H
+#define CTURTLE_H
+
+#include <stddef.h>
+
+#if defined(_WIN32) && defined(CTURTLE_BUILD)
+#	define CTURTLE_API __declspec(dllexport)
+#elif defined(_WIN32)
+#	define CTURTLE_API __declspec(dllimport)
+#elif defined(__GNUC__)
+#	define CTURTLE_API __attribute__((visibility("default")))
+#else
+#	define CTURTLE_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+	CTURTLE_IRI     = 0,
+	CTURTLE_BLANK   = 1,
+	CTURTLE_LITERAL = 2
+} cturtle_term_type;
+
+typedef enum {
+	CTURTLE_TURTLE = 0,
+	CTURTLE_TRIG   = 1,
+	CTURTLE_NQUADS = 2
+} cturtle_syntax;
+
+typedef enum {
+	CTURTLE_OK          = 0,
+	CTURTLE_PARSE_ERROR = 1,
+	CTURTLE_IO_ERROR    = 2,
+	CTURTLE_ABORTED     = 3,  /* a callback returned non-zero */
+	CTURTLE_ERROR       = 4   /* invalid arguments, out of memory, ... */
+} cturtle_status;
+
+typedef struct {
+	cturtle_term_type type;
+	const char *value;        /* iri, blank node id or lexical form */
+	size_t      value_length;
+	const char *datatype;     /* literals only, NULL otherwise */
+	size_t      datatype_length;
+	const char *language;     /* language tag of a literal, NULL if it has none */
+	size_t      language_length;
+} cturtle_term;
+
+/* graph is NULL for the default graph; return non-zero to stop parsing */
+typedef int (*cturtle_triple_callback)(void *user_data, const cturtle_term *subject, const cturtle_term *predicate, const cturtle_term *object, const cturtle_term *graph);
+
+/* called for every @prefix directive, may be NULL */
+typedef void (*cturtle_prefix_callback)(void *user_data, const char *prefix, size_t prefix_length, const char *ns, size_t ns_length);
+
+typedef struct {
+	cturtle_triple_callback triple;
+	cturtle_prefix_callback prefix;
+	void *user_data;
+} cturtle_callbacks;
+
+typedef struct {
+	int  line;          /* -1 when unknown */
+	char message[256];  /* null terminated, possibly truncated */
+} cturtle_error;
+
+/* the version of the library, e.g. "1.0.6" */
+CTURTLE_API const char *cturtle_version(void);
+
+/*
+ * Parses length bytes at data, resolving relative IRIs against base_uri.
+ * Collections are delivered as rdf:first/rdf:rest triples. error may be NULL.
+ */
+CTURTLE_API cturtle_status cturtle_parse_buffer(const char *data, size_t length, const char *base_uri, cturtle_syntax syntax, const cturtle_callbacks *callbacks, cturtle_error *error);
+
+/* Like cturtle_parse_buffer, reading from file descriptor fd until end of file. fd is not closed. */
+CTURTLE_API cturtle_status cturtle_parse_fd(int fd, const char *base_uri, cturtle_syntax syntax, const cturtle_callbacks *callbacks, cturtle_error *error);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CTURTLE_H */
@@ -0,0 +1,100 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <cstdio>
+#include <string>
+#include <sstream>
+#include <fstream>
+#include <iterator>
+#include <vector>
+#include <map>
+#include <memory>
+
+#include <unistd.h>
+
+#include "../src/Parser.hh"
+#include "../src/NTriplesWriter.hh"
+#include "../src/BatchTranslator.hh"
+#include "../src/Util.hh"
+
+#include "catch.hpp"
+
+
+namespace {
+	
+	std::string contents(const std::string &fileName)
+	{
+		std::ifstream in(fileName);
+		
+		return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+	}
+}
+
+
+TEST_CASE("batch translation", "[batch]")
+{
+	const std::string directory = "batch-test-out";
+	
+	std::map<std::string, std::string> docs = {
+		{ "a", "<s> <p> <o1> . <s> <p> <o2> ." },
+		{ "b", "<s> <p> ." },
+		{ "c", "<s> <p> <o3> ." }
+	};
+	
+	std::vector<turtle::BatchTranslator::Job> jobs = {
+		{ "a", directory + "/a.nt" },
+		{ "b", directory + "/b.nt" },
+		{ "c", directory + "/sub/dir/c.nt" }
+	};
+	
+	turtle::BatchTranslator translator(
+		[](std::ostream &out) { return std::unique_ptr<turtle::TripleSink>(new turtle::NTriplesWriter(out)); },
+		[&docs](const std::string &input, turtle::TripleSink *sink) {
+			std::istringstream in(docs.at(input));
+			turtle::Parser parser(&in, turtle::Uri("http://localhost/" + input), sink);
+			parser.parse();
+		}
+	);
+	
+	std::vector<turtle::BatchTranslator::Result> results = translator.run(jobs, 2);
+	
+	REQUIRE(results.size() == 3);
+	REQUIRE(results[0].count == 2);
+	REQUIRE(results[0].error.empty());
+	REQUIRE(!results[1].error.empty());
+	REQUIRE(results[2].count == 1);
+	
+	REQUIRE(contents(directory + "/sub/dir/c.nt") == "<http://localhost/s> <http://localhost/p> <http://localhost/o3> .\n");
+	REQUIRE(!turtle::exists(directory + "/b.nt"));
+	
+	// a link back up does not make listing loop
+	REQUIRE(::symlink("..", (directory + "/sub/dir/up").c_str()) == 0);
+	
+	std::vector<std::string> files;
+	turtle::listFiles(directory, files);
+	REQUIRE(files == std::vector<std::string>({ directory + "/a.nt", directory + "/sub/dir/c.nt" }));
+	
+	std::ostringstream summary;
+	turtle::BatchTranslator::summary(summary, results);
+	REQUIRE(summary.str().find("a\t" + directory + "/a.nt\t2\t") != std::string::npos);
+	
+	std::remove((directory + "/a.nt").c_str());
+	std::remove((directory + "/sub/dir/c.nt").c_str());
+	std::remove((directory + "/sub/dir/up").c_str());
+	::rmdir((directory + "/sub/dir").c_str());
+	::rmdir((directory + "/sub").c_str());
+	::rmdir(directory.c_str());
+}
@@ -0,0 +1,140 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#include <cstdint>
+#include <string>
+#include <sstream>
+
+#include "../src/Parser.hh"
+#include "../src/N3PWriter.hh"
+#include "../src/BinaryWriter.hh"
+#include "../src/BinaryReader.hh"
+#include "TestSinks.hh"
+
+#include "catch.hpp"
+
+
+TEST_CASE("binary round trip", "[binary]")
+{
+	std::istringstream in(
+		"@prefix ex: <http://example.org/ns#> .\n"
+		"ex:s ex:p ex:o, \"plain\", \"tagged\"@en, \"tagged\"@en-GB, \"x\"@en, \"it's\"^^ex:type, \"y\"^^ex:type ;\n"
+		"     ex:n 42, -7, 0, 007, +3, 123456789012345678901234567890, 1.5, -0.25, .5, 1.50, 1e3, true, false, \"1\"^^<http://www.w3.org/2001/XMLSchema#boolean> ;\n"
+		"     ex:list ( ex:a \"b\" ( ex:c _:x ) ) ;\n"
+		"     ex:nested [ ex:p _:x ] .\n"
+		"_:x ex:p ex:s .\n");
+	
+	std::ostringstream expected;
+	std::stringstream binary;
+	
+	turtle::N3PWriter n3pWriter(expected);
+	turtle::BinaryWriter binaryWriter(binary);
+	TeeSink tee(n3pWriter, binaryWriter);
+	
+	tee.start();
+	turtle::Parser parser(&in, turtle::Uri("http://localhost/test"), &tee);
+	parser.parse();
+	tee.end();
+	
+	REQUIRE(turtle::BinaryReader::accepts(binary));
+	
+	std::ostringstream actual;
+	turtle::N3PWriter writer(actual);
+	turtle::BinaryReader reader(&binary, &writer);
+	writer.start();
+	reader.read();
+	writer.end();
+	
+	REQUIRE(writer.count() == n3pWriter.count());
+	REQUIRE(actual.str() == expected.str());
+}
+
+TEST_CASE("binary back references", "[binary]")
+{
+	std::ostringstream once;
+	std::ostringstream twice;
+	
+	turtle::URIResource s("http://example.org/a/rather/long/subject/iri");
+	turtle::URIResource p("http://example.org/a/rather/long/property/iri");
+	turtle::StringLiteral o("value", "en");
+	
+	turtle::BinaryWriter w1(once);
+	w1.start();
+	w1.triple(s, p, o);
+	w1.end();
+	
+	turtle::BinaryWriter w2(twice);
+	w2.start();
+	w2.triple(s, p, o);
+	w2.triple(s, p, o);
+	w2.end();
+	
+	// tag, subject tag, distance, property distance, object tag, lexical, language distance
+	REQUIRE(twice.str().size() - once.str().size() == 1 + 1 + 1 + 1 + 1 + 6 + 1);
+}
+
+TEST_CASE("binary corrupt header", "[binary]")
+{
+	std::string header(turtle::BinaryWriter::MAGIC, turtle::BinaryWriter::MAGIC_LENGTH);
+	std::istringstream in(header + "\xff\xff\xff\xff\xff\xff\xff\xff\x7f");
+	
+	TestSink sink;
+	turtle::BinaryReader reader(&in, &sink);
+	REQUIRE_THROWS_AS(reader.read(), turtle::BinaryFormatException);
+	REQUIRE(sink.count() == 0);
+}
+
+TEST_CASE("binary corrupt lengths", "[binary]")
+{
+	const std::string huge = "\xff\xff\xff\xff\xff\xff\xff\xff\x7f";
+	const std::string stringData = huge + "abc", arrayData = huge + "\x40";
+	std::string s;
+	
+	turtle::StringInputBuffer string(stringData);
+	REQUIRE_THROWS_AS(turtle::binary::readString(&string, s), turtle::BinaryFormatException);
+	
+	turtle::StringInputBuffer array(arrayData);
+	turtle::binary::PackedArray a;
+	REQUIRE_THROWS_AS(a.read(&array), turtle::BinaryFormatException);
+}
+
+TEST_CASE("binary numbers", "[binary]")
+{
+	std::int64_t v;
+	std::uint64_t scale;
+	
+	REQUIRE(turtle::BinaryTermEncoder::parseInteger("0", &v));
+	REQUIRE(v == 0);
+	REQUIRE(turtle::BinaryTermEncoder::parseInteger("-123", &v));
+	REQUIRE(v == -123);
+	REQUIRE(!turtle::BinaryTermEncoder::parseInteger("-0", &v));
+	REQUIRE(!turtle::BinaryTermEncoder::parseInteger("+1", &v));
+	REQUIRE(!turtle::BinaryTermEncoder::parseInteger("01", &v));
+	REQUIRE(!turtle::BinaryTermEncoder::parseInteger("1234567890123456789", &v));
+	
+	REQUIRE(turtle::BinaryTermEncoder::parseDecimal("-0.05", &v, &scale));
+	REQUIRE(v == -5);
+	REQUIRE(scale == 2);
+	REQUIRE(turtle::BinaryTermEncoder::parseDecimal("10.50", &v, &scale));
+	REQUIRE(v == 1050);
+	REQUIRE(scale == 2);
+	REQUIRE(!turtle::BinaryTermEncoder::parseDecimal(".5", &v, &scale));
+	REQUIRE(!turtle::BinaryTermEncoder::parseDecimal("00.5", &v, &scale));
+	REQUIRE(!turtle::BinaryTermEncoder::parseDecimal("-0.0", &v, &scale));
+	
+	REQUIRE(turtle::BinaryTermEncoder::formatDecimal(-5, 2) == "-0.05");
+}
@@ -0,0 +1,151 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#	include <fcntl.h>
+#	include <unistd.h>
+#endif
+
+#include "../src/cturtle.h"
+
+#include "catch.hpp"
+
+
+namespace {
+	
+	std::string str(const char *s, std::size_t length)
+	{
+		return s ? std::string(s, length) : std::string("-");
+	}
+	
+	std::string str(const cturtle_term *t)
+	{
+		if (!t)
+			return "default";
+		
+		return std::to_string(t->type) + ":" + str(t->value, t->value_length) + ":" + str(t->datatype, t->datatype_length) + ":" + str(t->language, t->language_length);
+	}
+	
+	struct Collected {
+		std::vector<std::string> triples;
+		std::vector<std::string> prefixes;
+		std::size_t limit = 1000;
+	};
+	
+	int collect(void *user, const cturtle_term *s, const cturtle_term *p, const cturtle_term *o, const cturtle_term *g)
+	{
+		Collected *c = static_cast<Collected *>(user);
+		c->triples.push_back(str(s) + " " + str(p) + " " + str(o) + " " + str(g));
+		
+		return c->triples.size() >= c->limit;
+	}
+	
+	void prefix(void *user, const char *prefix, std::size_t prefixLength, const char *ns, std::size_t nsLength)
+	{
+		static_cast<Collected *>(user)->prefixes.push_back(std::string(prefix, prefixLength) + "=" + std::string(ns, nsLength));
+	}
+}
+
+
+TEST_CASE("c interface terms", "[c]")
+{
+	const std::string input = "@prefix ex: <http://example.org/> . ex:s ex:p \"a\"@en, 1, \"b\", _:x, <o> .";
+	
+	Collected c;
+	cturtle_callbacks callbacks = { collect, prefix, &c };
+	cturtle_error error;
+	
+	REQUIRE(cturtle_parse_buffer(input.data(), input.length(), "http://localhost/", CTURTLE_TURTLE, &callbacks, &error) == CTURTLE_OK);
+	
+	REQUIRE(c.prefixes == std::vector<std::string>({ "ex=http://example.org/" }));
+	REQUIRE(c.triples.size() == 5);
+	REQUIRE(c.triples[0] == "0:http://example.org/s:-:- 0:http://example.org/p:-:- 2:a:http://www.w3.org/1999/02/22-rdf-syntax-ns#langString:en default");
+	REQUIRE(c.triples[1].find(" 2:1:http://www.w3.org/2001/XMLSchema#integer:- default") != std::string::npos);
+	REQUIRE(c.triples[2].find(" 2:b:http://www.w3.org/2001/XMLSchema#string:- default") != std::string::npos);
+	REQUIRE(c.triples[3].find(" 1:") != std::string::npos);
+	REQUIRE(c.triples[4].find(" 0:http://localhost/o:-:- default") != std::string::npos);
+}
+
+TEST_CASE("c interface graphs and lists", "[c]")
+{
+	const std::string input = "<g> { <s> <p> ( 1 2 ) }";
+	
+	Collected c;
+	cturtle_callbacks callbacks = { collect, nullptr, &c };
+	
+	REQUIRE(cturtle_parse_buffer(input.data(), input.length(), "http://localhost/", CTURTLE_TRIG, &callbacks, nullptr) == CTURTLE_OK);
+	REQUIRE(c.triples.size() == 5);
+	for (const std::string &t : c.triples)
+		REQUIRE(t.substr(t.length() - 24) == "0:http://localhost/g:-:-");
+}
+
+TEST_CASE("c interface errors", "[c]")
+{
+	const std::string input = "<s> <p> <o> .\n<s> <p> <o2> .\n<s> <p> .";
+	
+	Collected c;
+	cturtle_callbacks callbacks = { collect, nullptr, &c };
+	cturtle_error error;
+	
+	REQUIRE(cturtle_parse_buffer(input.data(), input.length(), "http://localhost/", CTURTLE_TURTLE, &callbacks, &error) == CTURTLE_PARSE_ERROR);
+	REQUIRE(error.line == 3);
+	REQUIRE(std::string(error.message) == "expected object");
+	
+	c.triples.clear();
+	c.limit = 1;
+	REQUIRE(cturtle_parse_buffer(input.data(), input.length(), "http://localhost/", CTURTLE_TURTLE, &callbacks, &error) == CTURTLE_ABORTED);
+	REQUIRE(c.triples.size() == 1);
+	
+	REQUIRE(cturtle_parse_buffer(input.data(), input.length(), nullptr, CTURTLE_TURTLE, &callbacks, &error) == CTURTLE_ERROR);
+	REQUIRE(cturtle_parse_fd(-1, "http://localhost/", CTURTLE_TURTLE, &callbacks, &error) == CTURTLE_IO_ERROR);
+}
+
+TEST_CASE("c interface file descriptor", "[c]")
+{
+	std::FILE *f = std::tmpfile();
+	std::fputs("<s> <p> <o1>, <o2> .", f);
+	std::fflush(f);
+	std::rewind(f);
+	
+	Collected c;
+	cturtle_callbacks callbacks = { collect, nullptr, &c };
+	
+	REQUIRE(cturtle_parse_fd(fileno(f), "http://localhost/", CTURTLE_TURTLE, &callbacks, nullptr) == CTURTLE_OK);
+	REQUIRE(c.triples.size() == 2);
+	
+	std::fclose(f);
+}
+
+#ifndef _WIN32
+TEST_CASE("c interface read error", "[c]")
+{
+	int fd = ::open(".", O_RDONLY); // reading a directory fails
+	REQUIRE(fd >= 0);
+	
+	Collected c;
+	cturtle_callbacks callbacks = { collect, nullptr, &c };
+	cturtle_error error;
+	
+	REQUIRE(cturtle_parse_fd(fd, "http://localhost/", CTURTLE_TURTLE, &callbacks, &error) == CTURTLE_IO_ERROR);
+	REQUIRE(std::string(error.message) != "");
+	
+	::close(fd);
+}
+#endif
@@ -0,0 +1,128 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#include <string>
+#include <sstream>
+#include <ostream>
+
+#include <zlib.h>
+
+#include "../src/Compression.hh"
+
+#include "catch.hpp"
+
+
+namespace {
+	
+	// inflates all concatenated gzip members
+	std::string gunzip(const std::string &data)
+	{
+		std::string result;
+		z_stream zs = z_stream();
+		
+		REQUIRE(inflateInit2(&zs, 15 + 16) == Z_OK);
+		
+		zs.next_in  = reinterpret_cast<Bytef *>(const_cast<char *>(data.data()));
+		zs.avail_in = data.size();
+		
+		char buf[4096];
+		while (zs.avail_in) {
+			zs.next_out  = reinterpret_cast<Bytef *>(buf);
+			zs.avail_out = sizeof(buf);
+			
+			int r = inflate(&zs, Z_NO_FLUSH);
+			REQUIRE((r == Z_OK || r == Z_STREAM_END));
+			result.append(buf, sizeof(buf) - zs.avail_out);
+			
+			if (r == Z_STREAM_END)
+				inflateReset(&zs);
+		}
+		
+		inflateEnd(&zs);
+		
+		return result;
+	}
+	
+	/// a target that can not be written to, like a full disk
+	class FullBuffer : public std::streambuf {
+	protected:
+		int_type overflow(int_type c) override { return traits_type::eof(); }
+		std::streamsize xsputn(const char *s, std::streamsize n) override { return 0; }
+	};
+}
+
+
+TEST_CASE("codec from file name", "[compression]")
+{
+	turtle::CompressingStreamBuf::Codec codec;
+	
+	REQUIRE(turtle::CompressingStreamBuf::codec("out.nt.gz", &codec));
+	REQUIRE(codec == turtle::CompressingStreamBuf::GZIP);
+	REQUIRE(turtle::CompressingStreamBuf::codec("out.n3p.zst", &codec));
+	REQUIRE(codec == turtle::CompressingStreamBuf::ZSTD);
+	REQUIRE(!turtle::CompressingStreamBuf::codec("out.nt", &codec));
+	REQUIRE(!turtle::CompressingStreamBuf::codec(".gz", &codec));
+}
+
+TEST_CASE("parallel gzip blocks", "[compression]")
+{
+	std::string expected;
+	for (int i = 0; i < 20000; i++)
+		expected += "<http://example.org/s" + std::to_string(i) + "> <http://example.org/p> \"" + std::to_string(i * 7) + "\" .\n";
+	
+	std::ostringstream compressed;
+	{
+		turtle::CompressingStreamBuf buf(compressed.rdbuf(), turtle::CompressingStreamBuf::GZIP, 4, 64 * 1024);
+		std::ostream out(&buf);
+		
+		out << expected.substr(0, 1000) << std::flush; // sync in the middle of a block
+		out << expected.substr(1000);
+	}
+	
+	REQUIRE(compressed.str().size() < expected.size() / 2);
+	REQUIRE(gunzip(compressed.str()) == expected);
+}
+
+TEST_CASE("compression errors are reported", "[compression]")
+{
+	std::string data(200 * 1024, 'x');
+	
+	FullBuffer full;
+	turtle::CompressingStreamBuf buf(&full, turtle::CompressingStreamBuf::GZIP, 2, 64 * 1024);
+	std::ostream out(&buf);
+	
+	out << data;
+	out.flush();
+	REQUIRE(out.bad());
+	REQUIRE_THROWS_AS(buf.close(), turtle::CompressionException);
+	REQUIRE_THROWS_AS(buf.close(), turtle::CompressionException);
+}
+
+TEST_CASE("compression close", "[compression]")
+{
+	std::ostringstream compressed;
+	turtle::CompressingStreamBuf buf(compressed.rdbuf(), turtle::CompressingStreamBuf::GZIP);
+	std::ostream out(&buf);
+	
+	out << "<a> <b> <c> .\n";
+	buf.close();
+	
+	REQUIRE(gunzip(compressed.str()) == "<a> <b> <c> .\n");
+	
+	out << "ignored";
+	REQUIRE(out.bad());
+}
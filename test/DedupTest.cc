@@ -0,0 +1,112 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <string>
+#include <sstream>
+#include <memory>
+#include <chrono>
+#include <iostream>
+
+#include "../src/Parser.hh"
+#include "../src/NTriplesWriter.hh"
+#include "../src/DedupSink.hh"
+#include "TestSinks.hh"
+
+#include "catch.hpp"
+
+
+namespace {
+	
+	std::string input(int triples, int distinct)
+	{
+		std::string data = "@prefix ex: <http://example.org/ns#> .\n";
+		for (int i = 0; i < triples; i++) {
+			int n = i % distinct;
+			data += "ex:s" + std::to_string(n / 10) + " ex:p " + std::to_string(n) + " .\n";
+		}
+		
+		return data;
+	}
+}
+
+
+TEST_CASE("murmur3 reference values", "[dedup]")
+{
+	std::string fox = "The quick brown fox jumps over the lazy dog";
+	
+	turtle::Hash128 empty = turtle::hash::murmur3("", 0);
+	REQUIRE(empty.low == 0);
+	REQUIRE(empty.high == 0);
+	
+	turtle::Hash128 h = turtle::hash::murmur3(fox.data(), fox.size());
+	REQUIRE(h.low  == 0xe34bbc7bbc071b6cULL);
+	REQUIRE(h.high == 0x7a433ca9c49a9347ULL);
+}
+
+TEST_CASE("fingerprint set grows", "[dedup]")
+{
+	turtle::FingerprintSet set;
+	
+	for (std::uint64_t i = 0; i < 10000; i++)
+		REQUIRE(set.insert(turtle::hash::murmur3(&i, sizeof(i))));
+	for (std::uint64_t i = 0; i < 10000; i++)
+		REQUIRE(!set.insert(turtle::hash::murmur3(&i, sizeof(i))));
+	
+	REQUIRE(set.size() == 10000);
+}
+
+TEST_CASE("dedup drops repeated triples", "[dedup]")
+{
+	std::unique_ptr<turtle::TripleSink> target(new TestSink());
+	
+	turtle::DedupSink sink(std::move(target), 0);
+	translate(input(5000, 1000) + "[ ex:p ( 1 2 ) ] . [ ex:p ( 1 2 ) ] .\n", sink);
+	
+	REQUIRE(sink.count() == 1000 + 2); // distinct blank nodes are not duplicates
+	REQUIRE(sink.duplicates() == 4000);
+	REQUIRE(!sink.approximate());
+}
+
+TEST_CASE("dedup switches to a bloom filter", "[dedup]")
+{
+	std::unique_ptr<turtle::TripleSink> target(new TestSink());
+	
+	turtle::DedupSink sink(std::move(target), 64 * 1024);
+	translate(input(20000, 10000), sink);
+	
+	REQUIRE(sink.approximate());
+	REQUIRE(sink.duplicates() >= 10000);
+	REQUIRE(sink.duplicates() < 10000 + 100); // 64 KiB is about 50 bits per triple
+}
+
+TEST_CASE("dedup throughput", "[.][benchmark]")
+{
+	typedef std::chrono::high_resolution_clock Clock;
+	
+	std::string data = input(1000000, 250000);
+	
+	for (std::size_t memory : { std::size_t(0), std::size_t(256 * 1024) }) {
+		std::ostringstream out;
+		std::unique_ptr<turtle::TripleSink> target(new turtle::NTriplesWriter(out));
+		turtle::DedupSink sink(std::move(target), memory);
+		
+		Clock::time_point start = Clock::now();
+		translate(data, sink);
+		double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+		
+		std::cout << (memory ? "bloom filter" : "fingerprints") << ": " << sink.count() << " triples, " << sink.duplicates() << " duplicates in " << ms << " ms" << std::endl;
+	}
+}
@@ -0,0 +1,214 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <cstdio>
+#include <string>
+#include <sstream>
+#include <fstream>
+
+#include "../src/Parser.hh"
+#include "../src/NTriplesWriter.hh"
+#include "../src/StatementSplitter.hh"
+#include "../src/Checkpoint.hh"
+#include "../src/Follower.hh"
+#include "../src/OutputFile.hh"
+
+#include "catch.hpp"
+
+
+namespace {
+	
+	std::size_t last(const std::string &s, bool final = false)
+	{
+		return turtle::StatementSplitter::last(s.data(), s.length(), final);
+	}
+	
+	void append(const std::string &fileName, const std::string &data)
+	{
+		std::ofstream out(fileName, std::ios_base::out | std::ios_base::app | std::ios_base::binary);
+		out << data;
+	}
+}
+
+
+TEST_CASE("statement boundaries", "[follow]")
+{
+	REQUIRE(last("<a> <b> <c> .\n<a> <b> <d> .\n") == 27);
+	REQUIRE(last("<a> <b> <c> .\n<a> <b> <d> .") == 13);
+	REQUIRE(last("<a> <b> <c> .\n<a> <b> <d> .", true) == 27);
+	REQUIRE(last("<a> <b> <c> .\n<a> <b> <d>") == 13);
+	REQUIRE(last("<a> <b> 1.5 .\n") == 13);
+	REQUIRE(last("<a> <b> ex:c.d .\n") == 16);
+	REQUIRE(last("<http://a.b/ .x> <b> <c>") == 0);
+	REQUIRE(last("<a> <b> \"x . y\" .\n") == 17);
+	REQUIRE(last("<a> <b> \"x \\\" . y\" .\n") == 20);
+	REQUIRE(last("<a> <b> '''x\n . \n''' .\n") == 22);
+	REQUIRE(last("<a> <b> '''x\n . \n") == 0);
+	REQUIRE(last("<a> <b> [ <c> <d> . ] .\n") == 23);
+	REQUIRE(last("# a . comment\n<a> <b> <c> .#x\n") == 27);
+	REQUIRE(last("<g> { <a> <b> <c> . <a> <b> <d> } ") == 33);
+	REQUIRE(last("@prefix ex: <http://example.org/> .\n") == 35);
+}
+
+TEST_CASE("resuming keeps parser state", "[follow]")
+{
+	std::ostringstream out;
+	turtle::NTriplesWriter writer(out);
+	
+	std::istringstream first("@prefix ex: <http://example.org/> . _:x ex:p ex:o .");
+	turtle::Parser parser(&first, turtle::Uri("http://localhost/"), &writer);
+	parser.parse();
+	
+	std::istringstream second("@base <http://other/> . _:x ex:p <o> .");
+	parser.resume(&second);
+	
+	turtle::Parser::State state = parser.state();
+	REQUIRE(state.base == "http://other/");
+	REQUIRE(state.prefixes.size() == 1);
+	
+	std::istringstream empty;
+	turtle::Parser restored(&empty, turtle::Uri("http://localhost/"), &writer);
+	restored.restore(state);
+	std::istringstream third("_:x ex:p <o2> .");
+	restored.resume(&third);
+	
+	std::istringstream lines(out.str());
+	std::string l1, l2, l3;
+	std::getline(lines, l1);
+	std::getline(lines, l2);
+	std::getline(lines, l3);
+	
+	REQUIRE(l2.substr(0, l2.find(' ')) == l1.substr(0, l1.find(' ')));
+	REQUIRE(l3.substr(0, l3.find(' ')) == l1.substr(0, l1.find(' ')));
+	REQUIRE(l2.find("<http://other/o>") != std::string::npos);
+	REQUIRE(l3.find("<http://example.org/p> <http://other/o2>") != std::string::npos);
+}
+
+TEST_CASE("checkpoint files", "[follow]")
+{
+	const std::string fileName = "cturtle-test.checkpoint";
+	
+	turtle::Checkpoint checkpoint { 1234, 56, 78, turtle::Parser::State { "http://example.org/base", { { "", "http://default/" }, { "ex", "http://example.org/" } }, "ABC", 9 } };
+	checkpoint.save(fileName);
+	
+	turtle::Checkpoint loaded;
+	REQUIRE(turtle::Checkpoint::load(fileName, loaded));
+	REQUIRE(loaded.offset == 1234);
+	REQUIRE(loaded.line == 56);
+	REQUIRE(loaded.count == 78);
+	REQUIRE(loaded.state.base == checkpoint.state.base);
+	REQUIRE(loaded.state.prefixes == checkpoint.state.prefixes);
+	REQUIRE(loaded.state.blankPrefix == "ABC");
+	REQUIRE(loaded.state.blankCounter == 9);
+	REQUIRE(loaded.input.empty());
+	REQUIRE_FALSE(loaded.output);
+	
+	checkpoint.input = "part-2.ttl";
+	checkpoint.output = 4096;
+	checkpoint.save(fileName);
+	REQUIRE(turtle::Checkpoint::load(fileName, loaded));
+	REQUIRE(loaded.input == "part-2.ttl");
+	REQUIRE(loaded.output);
+	REQUIRE(*loaded.output == 4096);
+	
+	std::remove(fileName.c_str());
+	REQUIRE_FALSE(turtle::Checkpoint::load(fileName, loaded));
+	
+	append(fileName, "something else\n");
+	REQUIRE_THROWS_AS(turtle::Checkpoint::load(fileName, loaded), turtle::IOException);
+	std::remove(fileName.c_str());
+}
+
+TEST_CASE("resuming after the input was fixed", "[follow]")
+{
+	const std::string fileName = "cturtle-test-resume.ttl";
+	std::remove(fileName.c_str());
+	append(fileName, "@prefix ex: <http://example.org/> .\nex:a ex:p [ ex:q 1 ] .\nex:b ex:p \"broken .\n");
+	
+	std::ostringstream out;
+	turtle::Checkpoint checkpoint;
+	{
+		turtle::NTriplesWriter writer(out);
+		turtle::Follower follower(fileName, turtle::Uri("http://localhost/"), &writer);
+		
+		// a small file is parsed as a single piece, so fail at the first statement boundary instead
+		REQUIRE(follower.poll() > 0);
+		checkpoint = follower.checkpoint();
+		REQUIRE_THROWS_AS(follower.poll(true), turtle::ParseException);
+	}
+	REQUIRE(checkpoint.count == 2);
+	REQUIRE(checkpoint.line == 2);
+	
+	std::remove(fileName.c_str());
+	append(fileName, "@prefix ex: <http://example.org/> .\nex:a ex:p [ ex:q 1 ] .\nex:b ex:p \"fixed\" ; ex:r [] .\n");
+	
+	std::ostringstream rest;
+	turtle::NTriplesWriter writer(rest);
+	turtle::Follower follower(fileName, turtle::Uri("http://localhost/"), &writer);
+	follower.restore(checkpoint);
+	
+	REQUIRE(follower.poll(true) > 0);
+	REQUIRE(follower.poll(true) == 0);
+	REQUIRE(follower.checkpoint().count == 4);
+	REQUIRE(rest.str().find("<http://example.org/b> <http://example.org/p> \"fixed\" .") != std::string::npos);
+	
+	// labels continue where the first run stopped
+	std::string first = out.str(), second = rest.str();
+	std::string label = first.substr(first.find("_:"), first.find(' ', first.find("_:")) - first.find("_:"));
+	REQUIRE(second.find(label) == std::string::npos);
+	REQUIRE(second.find(label.substr(0, label.rfind('-') + 1)) != std::string::npos);
+	
+	std::remove(fileName.c_str());
+}
+
+TEST_CASE("following a growing file", "[follow]")
+{
+	const std::string fileName = "cturtle-test-follow.ttl";
+	std::remove(fileName.c_str());
+	append(fileName, "@prefix ex: <http://example.org/> .\nex:a ex:p ex:b .\nex:a ex:p ");
+	
+	std::ostringstream out;
+	turtle::NTriplesWriter writer(out);
+	turtle::Follower follower(fileName, turtle::Uri("http://localhost/"), &writer);
+	
+	REQUIRE(follower.poll() == 52);
+	REQUIRE(writer.count() == 1);
+	REQUIRE(follower.poll() == 0);
+	
+	append(fileName, "ex:c .\nex:a ex:p\n\n ex:d .\n");
+	REQUIRE(follower.poll() > 0);
+	REQUIRE(writer.count() == 3);
+	
+	turtle::Checkpoint checkpoint = follower.checkpoint();
+	REQUIRE(checkpoint.line == 6);
+	REQUIRE(checkpoint.count == 3);
+	
+	append(fileName, "ex:a ex:p .\n");
+	
+	std::ostringstream out2;
+	turtle::NTriplesWriter writer2(out2);
+	turtle::Follower restarted(fileName, turtle::Uri("http://localhost/"), &writer2);
+	restarted.restore(checkpoint);
+	
+	try {
+		restarted.poll();
+		FAIL("no parse error");
+	} catch (turtle::ParseException &e) {
+		REQUIRE(e.line() == 7);
+	}
+	
+	std::remove(fileName.c_str());
+}
@@ -0,0 +1,151 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#include <string>
+#include <sstream>
+#include <vector>
+#include <algorithm>
+
+#include "../src/Parser.hh"
+#include "../src/NTriplesWriter.hh"
+#include "../src/HdtWriter.hh"
+#include "../src/HdtReader.hh"
+#include "TestSinks.hh"
+
+#include "catch.hpp"
+
+
+namespace {
+	
+	std::vector<std::string> sortedLines(const std::string &s)
+	{
+		std::vector<std::string> lines;
+		std::istringstream in(s);
+		std::string line;
+		while (std::getline(in, line))
+			lines.push_back(line);
+		
+		std::sort(lines.begin(), lines.end());
+		lines.erase(std::unique(lines.begin(), lines.end()), lines.end());
+		
+		return lines;
+	}
+	
+	const std::string INPUT =
+		"@prefix ex: <http://example.org/ns#> .\n"
+		"ex:s ex:p ex:o, \"plain\", \"tagged\"@en, \"it's\\n\\\"quoted\\\"\"^^ex:type, 42, 1.5, 1e3, true ;\n"
+		"     a ex:Class ;\n"
+		"     ex:nested [ ex:p ex:s ] .\n"
+		"ex:o ex:p ex:s, ex:s, 42 .\n"
+		"_:x ex:q ex:o .\n";
+}
+
+
+TEST_CASE("hdt round trip", "[hdt]")
+{
+	std::ostringstream expected;
+	std::stringstream hdt;
+	
+	turtle::NTriplesWriter ntWriter(expected);
+	turtle::HdtWriter hdtWriter(hdt);
+	TeeSink tee(ntWriter, hdtWriter);
+	
+	std::istringstream in(INPUT);
+	tee.start();
+	turtle::Parser parser(&in, turtle::Uri("http://localhost/test"), &tee);
+	parser.parse();
+	tee.end();
+	
+	REQUIRE(turtle::HdtReader::accepts(hdt));
+	
+	std::ostringstream actual;
+	turtle::NTriplesWriter writer(actual);
+	turtle::HdtReader reader(&hdt, &writer);
+	reader.read("http://localhost/test");
+	writer.end();
+	
+	std::vector<std::string> e = sortedLines(expected.str());
+	
+	REQUIRE(writer.count() == e.size()); // duplicates are removed
+	
+	// triples are grouped by subject
+	std::vector<std::string> subjects;
+	std::istringstream lines(actual.str());
+	std::string line;
+	while (std::getline(lines, line)) {
+		std::string subject = line.substr(0, line.find(' '));
+		if (subjects.empty() || subjects.back() != subject) {
+			REQUIRE(std::find(subjects.begin(), subjects.end(), subject) == subjects.end());
+			subjects.push_back(subject);
+		}
+	}
+	REQUIRE(subjects.size() == 4);
+	
+	REQUIRE(sortedLines(actual.str()) == e);
+}
+
+TEST_CASE("hdt collections", "[hdt]")
+{
+	std::istringstream in("<http://example.org/s> <http://example.org/p> ( 1 ( 2 ) () ) .\n");
+	std::stringstream hdt;
+	
+	turtle::HdtWriter hdtWriter(hdt);
+	turtle::Parser parser(&in, turtle::Uri("http://localhost/test"), &hdtWriter);
+	parser.parse();
+	hdtWriter.end();
+	
+	TestSink sink;
+	turtle::HdtReader reader(&hdt, &sink);
+	reader.read("http://localhost/test");
+	
+	REQUIRE(sink.count() == 9);
+}
+
+TEST_CASE("hdt counts distinct triples", "[hdt]")
+{
+	std::istringstream in("<http://example.org/s> <http://example.org/p> <http://example.org/o>, <http://example.org/o>, \"x\" .\n<http://example.org/s> <http://example.org/p> \"x\" .\n");
+	std::stringstream hdt;
+	
+	turtle::HdtWriter hdtWriter(hdt);
+	turtle::Parser parser(&in, turtle::Uri("http://localhost/test"), &hdtWriter);
+	parser.parse();
+	hdtWriter.end();
+	
+	REQUIRE(hdtWriter.count() == 2);
+	
+	TestSink sink;
+	turtle::HdtReader reader(&hdt, &sink);
+	reader.read("http://localhost/test");
+	
+	REQUIRE(sink.count() == 2);
+}
+
+TEST_CASE("hdt invalid input", "[hdt]")
+{
+	std::istringstream in(std::string("\x89HDT\r\n\x1A\n\x05", 9));
+	
+	TestSink sink;
+	turtle::HdtReader reader(&in, &sink);
+	
+	REQUIRE_THROWS_AS(reader.read("http://localhost/test"), turtle::BinaryFormatException);
+	
+	// a dictionary section claiming more entries than it has data for
+	std::istringstream huge(std::string("\x89HDT\r\n\x1A\n", 8) + "\xff\xff\xff\xff\xff\xff\xff\xff\x7f" + std::string("\x00\x00\x00\x00", 4));
+	turtle::HdtReader hugeReader(&huge, &sink);
+	
+	REQUIRE_THROWS_AS(hugeReader.read("http://localhost/test"), turtle::BinaryFormatException);
+}
@@ -0,0 +1,156 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../src/Interned.hh"
+#include "../src/Model.hh"
+#include "../src/Parser.hh"
+#include "../src/NTriplesWriter.hh"
+#include "../src/N3PWriter.hh"
+#include "TestSinks.hh"
+
+#include "catch.hpp"
+
+
+namespace {
+	
+	template<typename Writer>
+	std::string translate(const std::string &input)
+	{
+		std::ostringstream out;
+		Writer writer(out);
+		std::istringstream in(input);
+		
+		writer.start();
+		turtle::Parser parser(&in, turtle::Uri("http://localhost/test"), &writer);
+		parser.parse();
+		writer.end();
+		
+		return out.str();
+	}
+	
+}
+
+
+TEST_CASE("interning", "[interned]")
+{
+	turtle::InternCache cache;
+	
+	turtle::InternedRef en = cache.intern("en");
+	REQUIRE(en->value() == "en");
+	REQUIRE(cache.intern("en").get() == en.get());
+	REQUIRE(cache.intern("nl").get() != en.get());
+	
+	const std::string lexeme = "@en";
+	REQUIRE(cache.intern(lexeme.data() + 1, 2).get() == en.get());
+	
+	// every cache has entries of its own
+	turtle::InternCache other;
+	REQUIRE(other.intern("en").get() != en.get());
+}
+
+TEST_CASE("interned entries live as long as their terms", "[interned]")
+{
+	std::unique_ptr<turtle::StringLiteral> literal;
+	{
+		turtle::InternCache cache;
+		literal.reset(new turtle::StringLiteral("x", cache.intern("en")));
+	}
+	REQUIRE(literal->language() == "en");
+	
+	std::unique_ptr<turtle::StringLiteral> clone(literal->clone());
+	literal.reset();
+	REQUIRE(clone->language() == "en");
+}
+
+TEST_CASE("interning starts over when full", "[interned]")
+{
+	turtle::InternCache cache;
+	turtle::InternedRef first = cache.intern("tag0");
+	
+	for (std::size_t i = 1; i <= turtle::InternCache::MAX_SIZE; i++)
+		cache.intern("tag" + std::to_string(i));
+	
+	REQUIRE(cache.intern("tag0").get() != first.get());
+	REQUIRE(first->value() == "tag0");
+}
+
+TEST_CASE("literals share their datatype and language", "[interned]")
+{
+	turtle::InternCache cache;
+	turtle::StringLiteral a("a", cache.intern("en"));
+	turtle::StringLiteral b(std::string("b"), cache.intern("en"));
+	std::unique_ptr<turtle::StringLiteral> c(a.clone());
+	
+	REQUIRE(a.languageEntry().get() == b.languageEntry().get());
+	REQUIRE(c->languageEntry().get() == a.languageEntry().get());
+	REQUIRE(c->language() == "en");
+	REQUIRE(turtle::StringLiteral("d").language().empty());
+	REQUIRE(turtle::StringLiteral("d", "en").language() == "en");
+	
+	turtle::OtherLiteral x("1", cache.intern("http://example.org/type"));
+	turtle::OtherLiteral y(std::string("2"), cache.intern("http://example.org/type"));
+	REQUIRE(x.datatypeEntry().get() == y.datatypeEntry().get());
+	REQUIRE(y.datatype() == "http://example.org/type");
+	REQUIRE(turtle::OtherLiteral("3", "http://example.org/type").datatype() == "http://example.org/type");
+	
+	REQUIRE(turtle::IntegerLiteral("1").datatypeEntry().get() == turtle::IntegerLiteral::DATATYPE);
+	REQUIRE(turtle::IntegerLiteral::DATATYPE->value() == turtle::IntegerLiteral::TYPE);
+}
+
+TEST_CASE("renderings", "[interned]")
+{
+	turtle::InternCache cache;
+	turtle::Renderings renderings;
+	int calls = 0;
+	auto render = [&calls](const std::string &value, std::string &bytes) { bytes = "@" + value; ++calls; };
+	
+	REQUIRE(renderings.get(cache.intern("en"), render) == "@en");
+	REQUIRE(renderings.get(cache.intern("nl"), render) == "@nl");
+	REQUIRE(renderings.get(cache.intern("en"), render) == "@en");
+	REQUIRE(calls == 2);
+	
+	// entries of other caches are rendered again, and kept alive while they are keys
+	REQUIRE(renderings.get(turtle::InternedRef::make("en"), render) == "@en");
+	REQUIRE(calls == 3);
+	
+	for (std::size_t i = 0; i < 2 * turtle::Renderings::MAX_SIZE; i++)
+		REQUIRE(renderings.get(turtle::InternedRef::make(std::to_string(i)), render) == "@" + std::to_string(i));
+}
+
+TEST_CASE("writers print interned datatypes and languages", "[interned]")
+{
+	const std::string input =
+		"<http://example.org/a> <http://example.org/p> \"x\"@en, \"y\"@en, \"z\", \"1\"^^<http://example.org/it's>, \"2\"^^<http://example.org/it's> .\n";
+	
+	std::string nt = translate<turtle::NTriplesWriter>(input);
+	REQUIRE(nt ==
+		"<http://example.org/a> <http://example.org/p> \"x\"@en .\n"
+		"<http://example.org/a> <http://example.org/p> \"y\"@en .\n"
+		"<http://example.org/a> <http://example.org/p> \"z\" .\n"
+		"<http://example.org/a> <http://example.org/p> \"1\"^^<http://example.org/it's> .\n"
+		"<http://example.org/a> <http://example.org/p> \"2\"^^<http://example.org/it's> .\n");
+	
+	std::string n3p = translate<turtle::N3PWriter>(input);
+	REQUIRE(n3p.find("literal('x',lang('en'))") != std::string::npos);
+	REQUIRE(n3p.find("literal('z',type('<http://www.w3.org/2001/XMLSchema#string>'))") != std::string::npos);
+	REQUIRE(n3p.find("literal('2',type('<http://example.org/it\\'s>'))") != std::string::npos);
+}
@@ -0,0 +1,250 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../src/LiteralValidator.hh"
+#include "../src/Parser.hh"
+#include "../src/NTriplesWriter.hh"
+#include "../src/N3PWriter.hh"
+
+#include "catch.hpp"
+
+
+namespace {
+	
+	using turtle::LiteralValidator;
+	
+	bool valid(LiteralValidator::Type type, const std::string &lexical)
+	{
+		return LiteralValidator::check(type, lexical) == nullptr;
+	}
+	
+	std::string canonical(LiteralValidator::Type type, const std::string &lexical)
+	{
+		std::string result;
+		const char *error = LiteralValidator::check(type, lexical, &result);
+		
+		return error ? error : result;
+	}
+	
+	template<typename Writer>
+	std::string translate(const std::string &input, bool canonical)
+	{
+		std::ostringstream out;
+		Writer writer(out);
+		std::istringstream in(input);
+		
+		writer.start();
+		turtle::Parser parser(&in, turtle::Uri("http://localhost/test"), &writer);
+		parser.validateLiterals();
+		if (canonical)
+			parser.canonicalLiterals();
+		parser.parse();
+		writer.end();
+		
+		return out.str();
+	}
+	
+	bool contains(const std::string &s, const std::string &part)
+	{
+		return s.find(part) != std::string::npos;
+	}
+	
+}
+
+
+TEST_CASE("digit runs", "[literal]")
+{
+	const std::string s = "0123456789012345678x9";
+	
+	for (std::size_t from = 0; from <= s.length(); from++) {
+		for (std::size_t end = from; end <= s.length(); end++) {
+			std::size_t expected = from;
+			while (expected < end && s[expected] >= '0' && s[expected] <= '9')
+				expected++;
+			REQUIRE(LiteralValidator::digits(s.data(), from, end) == expected);
+		}
+	}
+	
+	const std::string edges = "/0:9";
+	REQUIRE(LiteralValidator::digits(edges.data(), 0, 4) == 0);
+	REQUIRE(LiteralValidator::digits(edges.data(), 1, 4) == 2);
+	REQUIRE(LiteralValidator::digits(edges.data(), 3, 4) == 4);
+}
+
+TEST_CASE("datatypes", "[literal]")
+{
+	REQUIRE(LiteralValidator::type("http://www.w3.org/2001/XMLSchema#integer") == LiteralValidator::INTEGER);
+	REQUIRE(LiteralValidator::type("http://www.w3.org/2001/XMLSchema#dateTime") == LiteralValidator::DATE_TIME);
+	REQUIRE(LiteralValidator::type("http://www.w3.org/2001/XMLSchema#dateTimeStamp") == LiteralValidator::DATE_TIME_STAMP);
+	REQUIRE(LiteralValidator::type("http://www.w3.org/2001/XMLSchema#string") == LiteralValidator::OTHER);
+	REQUIRE(LiteralValidator::type("http://example.org/integer") == LiteralValidator::OTHER);
+}
+
+TEST_CASE("numbers", "[literal]")
+{
+	REQUIRE(valid(LiteralValidator::INTEGER, "-12345678901234567890"));
+	REQUIRE_FALSE(valid(LiteralValidator::INTEGER, ""));
+	REQUIRE_FALSE(valid(LiteralValidator::INTEGER, "abc"));
+	REQUIRE_FALSE(valid(LiteralValidator::INTEGER, "1.0"));
+	REQUIRE_FALSE(valid(LiteralValidator::INTEGER, "+"));
+	REQUIRE_FALSE(valid(LiteralValidator::INTEGER, "12 "));
+	
+	REQUIRE(valid(LiteralValidator::DECIMAL, "-.5"));
+	REQUIRE(valid(LiteralValidator::DECIMAL, "5."));
+	REQUIRE_FALSE(valid(LiteralValidator::DECIMAL, "."));
+	REQUIRE_FALSE(valid(LiteralValidator::DECIMAL, "1e3"));
+	
+	REQUIRE(valid(LiteralValidator::DOUBLE, "1e3"));
+	REQUIRE(valid(LiteralValidator::DOUBLE, "-INF"));
+	REQUIRE(valid(LiteralValidator::FLOAT, "NaN"));
+	REQUIRE_FALSE(valid(LiteralValidator::DOUBLE, "inf"));
+	REQUIRE_FALSE(valid(LiteralValidator::DOUBLE, "1e"));
+	REQUIRE_FALSE(valid(LiteralValidator::DOUBLE, "e1"));
+	
+	REQUIRE(valid(LiteralValidator::BOOLEAN, "1"));
+	REQUIRE_FALSE(valid(LiteralValidator::BOOLEAN, "TRUE"));
+	REQUIRE_FALSE(valid(LiteralValidator::BOOLEAN, "yes"));
+}
+
+TEST_CASE("canonical numbers", "[literal]")
+{
+	REQUIRE(canonical(LiteralValidator::INTEGER, "007") == "7");
+	REQUIRE(canonical(LiteralValidator::INTEGER, "+12") == "12");
+	REQUIRE(canonical(LiteralValidator::INTEGER, "-012") == "-12");
+	REQUIRE(canonical(LiteralValidator::INTEGER, "-0") == "0");
+	
+	REQUIRE(canonical(LiteralValidator::DECIMAL, "1") == "1.0");
+	REQUIRE(canonical(LiteralValidator::DECIMAL, "001.2300") == "1.23");
+	REQUIRE(canonical(LiteralValidator::DECIMAL, "-.50") == "-0.5");
+	REQUIRE(canonical(LiteralValidator::DECIMAL, "-0.0") == "0.0");
+	
+	REQUIRE(canonical(LiteralValidator::DOUBLE, "1") == "1.0E0");
+	REQUIRE(canonical(LiteralValidator::DOUBLE, "120e5") == "1.2E7");
+	REQUIRE(canonical(LiteralValidator::DOUBLE, "0.00123") == "1.23E-3");
+	REQUIRE(canonical(LiteralValidator::DOUBLE, ".5") == "5.0E-1");
+	REQUIRE(canonical(LiteralValidator::DOUBLE, "-0") == "-0.0E0");
+	REQUIRE(canonical(LiteralValidator::DOUBLE, "+INF") == "INF");
+	
+	REQUIRE(canonical(LiteralValidator::BOOLEAN, "1") == "true");
+	REQUIRE(canonical(LiteralValidator::BOOLEAN, "0") == "false");
+}
+
+TEST_CASE("dates and times", "[literal]")
+{
+	REQUIRE(valid(LiteralValidator::DATE_TIME, "2016-02-29T12:00:00Z"));
+	REQUIRE(valid(LiteralValidator::DATE_TIME, "2000-02-29T24:00:00"));
+	REQUIRE(valid(LiteralValidator::DATE_TIME, "-0044-03-15T10:00:00.5+14:00"));
+	REQUIRE(valid(LiteralValidator::DATE_TIME, "12016-01-01T00:00:00"));
+	REQUIRE_FALSE(valid(LiteralValidator::DATE_TIME, "2015-02-29T12:00:00"));
+	REQUIRE_FALSE(valid(LiteralValidator::DATE_TIME, "1900-02-29T12:00:00"));
+	REQUIRE_FALSE(valid(LiteralValidator::DATE_TIME, "2000-02-28T24:00:01"));
+	REQUIRE_FALSE(valid(LiteralValidator::DATE_TIME, "2016-01-01T00:00:00+14:01"));
+	REQUIRE_FALSE(valid(LiteralValidator::DATE_TIME, "02016-01-01T00:00:00"));
+	REQUIRE_FALSE(valid(LiteralValidator::DATE_TIME, "2016-1-01T00:00:00"));
+	REQUIRE_FALSE(valid(LiteralValidator::DATE_TIME, "2016-01-01"));
+	REQUIRE_FALSE(valid(LiteralValidator::DATE_TIME, "2016-01-01T00:00:00."));
+	
+	REQUIRE(valid(LiteralValidator::DATE_TIME_STAMP, "2016-01-01T00:00:00Z"));
+	REQUIRE_FALSE(valid(LiteralValidator::DATE_TIME_STAMP, "2016-01-01T00:00:00"));
+	
+	REQUIRE(valid(LiteralValidator::DATE, "2016-12-31"));
+	REQUIRE(valid(LiteralValidator::DATE, "2016-04-30-05:00"));
+	REQUIRE_FALSE(valid(LiteralValidator::DATE, "2016-04-31"));
+	
+	REQUIRE(valid(LiteralValidator::TIME, "23:59:59.999"));
+	REQUIRE_FALSE(valid(LiteralValidator::TIME, "12:60:00"));
+	REQUIRE_FALSE(valid(LiteralValidator::TIME, "12:00:60"));
+	
+	REQUIRE(valid(LiteralValidator::G_YEAR, "2016Z"));
+	REQUIRE_FALSE(valid(LiteralValidator::G_YEAR, "16"));
+	REQUIRE(valid(LiteralValidator::G_YEAR_MONTH, "2016-02"));
+	REQUIRE_FALSE(valid(LiteralValidator::G_YEAR_MONTH, "2016-13"));
+	
+	REQUIRE(canonical(LiteralValidator::DATE, "2016-12-31Z") == "2016-12-31Z");
+}
+
+TEST_CASE("strict literals in the parser", "[literal][parser]")
+{
+	const std::string input =
+		"@prefix xsd: <http://www.w3.org/2001/XMLSchema#> .\n"
+		"<http://example.org/a> <http://example.org/p> \"12\"^^xsd:integer .\n"
+		"<http://example.org/a> <http://example.org/p> \"abc\"^^xsd:integer .\n";
+	
+	try {
+		translate<turtle::NTriplesWriter>(input, false);
+		FAIL("invalid literal accepted");
+	} catch (const turtle::ParseException &e) {
+		REQUIRE(e.line() == 3);
+		REQUIRE(contains(e.what(), "\"abc\""));
+	}
+	
+	// custom datatypes are not checked
+	REQUIRE_NOTHROW(translate<turtle::NTriplesWriter>("<http://example.org/a> <http://example.org/p> \"abc\"^^<http://example.org/integer> .\n", false));
+}
+
+TEST_CASE("canonical literals in the writers", "[literal][parser]")
+{
+	const std::string input =
+		"@prefix xsd: <http://www.w3.org/2001/XMLSchema#> .\n"
+		"<http://example.org/a> <http://example.org/p> 007, -.50, 12e1, \"1\"^^xsd:boolean, \"+3\"^^xsd:integer .\n";
+	
+	std::string nt = translate<turtle::NTriplesWriter>(input, true);
+	REQUIRE(contains(nt, "\"7\"^^<http://www.w3.org/2001/XMLSchema#integer>"));
+	REQUIRE(contains(nt, "\"-0.5\"^^<http://www.w3.org/2001/XMLSchema#decimal>"));
+	REQUIRE(contains(nt, "\"1.2E2\"^^<http://www.w3.org/2001/XMLSchema#double>"));
+	REQUIRE(contains(nt, "\"true\"^^<http://www.w3.org/2001/XMLSchema#boolean>"));
+	REQUIRE(contains(nt, "\"3\"^^<http://www.w3.org/2001/XMLSchema#integer>"));
+	
+	std::string n3p = translate<turtle::N3PWriter>(input, true);
+	REQUIRE(contains(n3p, ",7)."));
+	REQUIRE(contains(n3p, ",-0.5)."));
+	REQUIRE(contains(n3p, ",1.2E2)."));
+	REQUIRE(contains(n3p, ",3)."));
+	
+	// without canonicalisation the values are written as they are
+	REQUIRE(contains(translate<turtle::NTriplesWriter>(input, false), "\"007\"^^"));
+}
+
+TEST_CASE("literal validation throughput", "[.][benchmark]")
+{
+	std::vector<std::string> values;
+	for (int i = 0; i < 100000; i++) {
+		values.push_back(std::to_string(i * 7919));
+		values.push_back(std::to_string(i) + ".25");
+		values.push_back("2016-03-" + std::to_string(10 + i % 19) + "T12:30:00Z");
+	}
+	
+	const LiteralValidator::Type types[] = { LiteralValidator::INTEGER, LiteralValidator::DECIMAL, LiteralValidator::DATE_TIME };
+	std::string result;
+	std::size_t invalid = 0;
+	
+	auto start = std::chrono::steady_clock::now();
+	for (int round = 0; round < 10; round++) {
+		for (std::size_t i = 0; i < values.size(); i++)
+			invalid += LiteralValidator::check(types[i % 3], values[i], &result) != nullptr;
+	}
+	std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+	
+	std::cout << "checked " << 10 * values.size() << " literals in " << elapsed.count() / 1e6 << " ms, " << elapsed.count() / (10 * values.size()) << " ns per literal" << std::endl;
+	REQUIRE(invalid == 0);
+}
@@ -0,0 +1,133 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <string>
+#include <sstream>
+
+#include "../src/LruCache.hh"
+#include "../src/Parser.hh"
+#include "../src/NTriplesWriter.hh"
+
+#include "catch.hpp"
+
+
+namespace {
+	
+	/// Looks up key, adding it on a miss like the parser does.
+	bool lookup(turtle::LruCache &cache, const std::string &key)
+	{
+		if (cache.find(key))
+			return true;
+		
+		cache.insert(key, "value of " + key);
+		
+		return false;
+	}
+	
+}
+
+
+TEST_CASE("keys are cached the second time they miss", "[lru]")
+{
+	turtle::LruCache cache(4);
+	
+	REQUIRE_FALSE(lookup(cache, "a"));
+	REQUIRE(cache.size() == 0);
+	REQUIRE_FALSE(lookup(cache, "a"));
+	REQUIRE(cache.size() == 1);
+	REQUIRE(lookup(cache, "a"));
+	REQUIRE(*cache.find("a") == "value of a");
+	
+	REQUIRE(cache.hits() == 2);
+	REQUIRE(cache.misses() == 2);
+}
+
+TEST_CASE("the least recently used key is dropped", "[lru]")
+{
+	turtle::LruCache cache(3);
+	
+	for (const char *key : { "a", "b", "c", "a", "b", "c" })
+		lookup(cache, key);
+	REQUIRE(cache.size() == 3);
+	
+	REQUIRE(lookup(cache, "a")); // b is now the least recently used
+	lookup(cache, "d");
+	lookup(cache, "d");
+	
+	REQUIRE(cache.size() == 3);
+	REQUIRE(cache.find("a"));
+	REQUIRE(cache.find("c"));
+	REQUIRE(cache.find("d"));
+	REQUIRE_FALSE(cache.find("b"));
+}
+
+TEST_CASE("entries survive the removal of their neighbours", "[lru]")
+{
+	turtle::LruCache cache(64);
+	
+	// many more keys than slots, so probe chains are broken up and repaired
+	for (int round = 0; round < 4; round++) {
+		for (int i = 0; i < 1000; i++) {
+			std::string key = "k" + std::to_string(i % 100 + round * 37);
+			lookup(cache, key);
+			lookup(cache, key);
+			
+			const std::string *value = cache.find(key);
+			REQUIRE(value);
+			REQUIRE(*value == "value of " + key);
+		}
+	}
+	REQUIRE(cache.size() == 64);
+}
+
+TEST_CASE("clearing keeps the counts", "[lru]")
+{
+	turtle::LruCache cache(4);
+	
+	lookup(cache, "a");
+	lookup(cache, "a");
+	lookup(cache, "a");
+	cache.clear();
+	
+	REQUIRE(cache.size() == 0);
+	REQUIRE_FALSE(cache.find("a"));
+	REQUIRE(cache.hits() == 1);
+	REQUIRE(cache.misses() == 3);
+}
+
+TEST_CASE("the parser resolves against the current base", "[lru][parser]")
+{
+	std::istringstream in(
+		"@base <http://example.org/one/> .\n"
+		"<s> <p> <o> .\n"
+		"<s> <p> <o> .\n"
+		"<s> <p> <o> .\n"
+		"@base <http://example.org/two/> .\n"
+		"<s> <p> <o> .\n");
+	std::ostringstream out;
+	turtle::NTriplesWriter writer(out);
+	
+	turtle::Parser parser(&in, turtle::Uri("http://localhost/"), &writer);
+	parser.parse();
+	
+	REQUIRE(out.str() ==
+		"<http://example.org/one/s> <http://example.org/one/p> <http://example.org/one/o> .\n"
+		"<http://example.org/one/s> <http://example.org/one/p> <http://example.org/one/o> .\n"
+		"<http://example.org/one/s> <http://example.org/one/p> <http://example.org/one/o> .\n"
+		"<http://example.org/two/s> <http://example.org/two/p> <http://example.org/two/o> .\n");
+	REQUIRE(parser.resolveCacheHits() == 3);
+	REQUIRE(parser.resolveCacheMisses() == 9);
+}
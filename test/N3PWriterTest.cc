@@ -0,0 +1,301 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#include <string>
+#include <sstream>
+#include <iostream>
+#include <unordered_map>
+#include <set>
+#include <fstream>
+#include <cstdlib>
+#include <cstdio>
+#include <chrono>
+#include <cctype>
+
+#include "../src/Parser.hh"
+#include "../src/N3PWriter.hh"
+#include "../src/N3PDictWriter.hh"
+#include "../src/N3PClusteredWriter.hh"
+#include "TestSinks.hh"
+
+#include "catch.hpp"
+
+
+namespace {
+	
+	///
+	/// Turns n3p-dict output back into plain N3P by substituting the dict/2 atoms.
+	///
+	std::string decodeDict(const std::string &input)
+	{
+		std::unordered_map<std::string, std::string> atoms;
+		std::istringstream in(input);
+		std::string result;
+		std::string line;
+		
+		while (std::getline(in, line)) {
+			if (line == ":- multifile(dict/2).")
+				continue;
+			
+			if (line.compare(0, 5, "dict(") == 0) {
+				std::size_t comma = line.find(',');
+				atoms[line.substr(5, comma - 5)] = line.substr(comma + 1, line.length() - comma - 3);
+				continue;
+			}
+			
+			bool quoted = false;
+			for (std::size_t i = 0; i < line.length();) {
+				char c = line[i];
+				if (quoted) {
+					result.push_back(c);
+					if (c == '\\') {
+						result.push_back(line[i + 1]);
+						i += 2;
+						continue;
+					}
+					quoted = c != '\'';
+					++i;
+				} else if (c == '\'') {
+					quoted = true;
+					result.push_back(c);
+					++i;
+				} else if (std::isalnum(static_cast<unsigned char>(c)) || c == '_') {
+					std::size_t j = i;
+					while (j < line.length() && (std::isalnum(static_cast<unsigned char>(line[j])) || line[j] == '_'))
+						++j;
+					std::string token = line.substr(i, j - i);
+					auto a = atoms.find(token);
+					result.append(a != atoms.end() ? a->second : token);
+					i = j;
+				} else {
+					result.push_back(c);
+					++i;
+				}
+			}
+			result.push_back('\n');
+		}
+		
+		return result;
+	}
+	
+	/// The atom the dict/2 facts of input map iri to, empty if there is none.
+	std::string atomOf(const std::string &input, const std::string &iri)
+	{
+		std::size_t end = input.find(",'<" + iri + ">').");
+		if (end == std::string::npos)
+			return std::string();
+		
+		std::size_t begin = input.rfind("dict(", end) + 5;
+		return input.substr(begin, end - begin);
+	}
+	
+	/// The lines that are not directives or pred/1 facts.
+	std::string clauses(const std::string &s)
+	{
+		std::istringstream in(s);
+		std::string result;
+		std::string line;
+		while (std::getline(in, line)) {
+			if (line.compare(0, 2, ":-") != 0 && line.compare(0, 5, "pred(") != 0)
+				result.append(line).push_back('\n');
+		}
+		
+		return result;
+	}
+	
+	const std::string INPUT =
+		"@prefix ex: <http://example.org/ns#> .\n"
+		"@prefix xsd: <http://www.w3.org/2001/XMLSchema#> .\n"
+		"ex:s ex:p ex:o, \"plain\", \"tagged\"@en, \"it's\"^^ex:type, 42, 1.5, 1e3, true ;\n"
+		"     a ex:Class ;\n"
+		"     ex:list ( ex:a \"b\" ( ex:c ) ) ;\n"
+		"     ex:nested [ ex:p <relative#i1> ] .\n"
+		"_:x <http://example.org/it's> ex:s .\n";
+	
+	/// Input with the triples of every predicate spread over the document.
+	std::string interleaved(int n)
+	{
+		std::string input = "@prefix ex: <http://example.org/ns#> .\n";
+		for (int i = 0; i < n; i++) {
+			input += "ex:s" + std::to_string(i) + " ex:p" + std::to_string(i % 13) + " " + std::to_string(i) + " ; a ex:C" + std::to_string(i % 5) + " .\n";
+			if (i % 100 == 0)
+				input += "@prefix ex" + std::to_string(i) + ": <http://example.org/ns" + std::to_string(i) + "#> .\n";
+		}
+		
+		return input;
+	}
+	
+	/// Times loading file in SWI-Prolog, returns a negative number if swipl is not available.
+	double load(const std::string &file)
+	{
+		typedef std::chrono::high_resolution_clock Clock;
+		
+		if (std::system("swipl --version > /dev/null 2>&1") != 0)
+			return -1.0;
+		
+		Clock::time_point start = Clock::now();
+		int r = std::system(("swipl -q -g \"consult('" + file + "'),halt.\" -t 'halt(1)' > /dev/null 2>&1").c_str());
+		
+		return r == 0 ? std::chrono::duration<double, std::milli>(Clock::now() - start).count() : -1.0;
+	}
+}
+
+
+TEST_CASE("dictionary round trip", "[n3p-dict]")
+{
+	std::ostringstream plain;
+	std::ostringstream dict;
+	
+	turtle::N3PWriter plainWriter(plain);
+	turtle::N3PDictWriter dictWriter(dict);
+	TeeSink tee(plainWriter, dictWriter);
+	
+	translate(INPUT, tee);
+	
+	const std::string p = atomOf(dict.str(), "http://example.org/ns#p");
+	
+	REQUIRE(dictWriter.count() == plainWriter.count());
+	REQUIRE(dict.str().find("'<http://example.org/ns#s>'(") == std::string::npos);
+	REQUIRE(p.length() > 1);
+	REQUIRE(p[0] == 'i');
+	REQUIRE(clauses(decodeDict(dict.str())) == clauses(plain.str()));
+	
+	// only declares what it uses, the predicates are atoms rather than IRIs
+	REQUIRE(dict.str().find(":- dynamic(" + p + "/2).") != std::string::npos);
+	REQUIRE(dict.str().find("22-rdf-syntax-ns#type>'/2") == std::string::npos);
+	REQUIRE(dict.str().find("pred(") == std::string::npos);
+}
+
+TEST_CASE("dictionary atoms are the same in every output", "[n3p-dict]")
+{
+	std::ostringstream a, b;
+	turtle::N3PDictWriter first(a);
+	turtle::N3PDictWriter second(b);
+	translate(INPUT, first);
+	translate("<http://example.org/ns#o> <http://example.org/ns#q> <http://example.org/ns#s> .\n", second);
+	
+	for (const char *iri : { "http://example.org/ns#s", "http://example.org/ns#o" }) {
+		REQUIRE(!atomOf(a.str(), iri).empty());
+		REQUIRE(atomOf(a.str(), iri) == atomOf(b.str(), iri));
+	}
+	
+	REQUIRE(atomOf(a.str(), "http://example.org/ns#p") != atomOf(b.str(), "http://example.org/ns#q"));
+	REQUIRE(decodeDict(a.str()).find("'<http://example.org/ns#p>'('<http://example.org/ns#s>',42).") != std::string::npos);
+}
+
+TEST_CASE("dictionary size and throughput", "[.][benchmark]")
+{
+	std::string input = "@prefix ex: <http://example.org/some/rather/long/namespace#> .\n";
+	for (int i = 0; i < 100000; i++) {
+		input += "ex:subject" + std::to_string(i % 5000) + " ex:property" + std::to_string(i % 20) + " ex:object" + std::to_string(i % 3000) + " .\n";
+		input += "ex:subject" + std::to_string(i % 5000) + " ex:label \"label " + std::to_string(i) + "\" .\n";
+	}
+	
+	typedef std::chrono::high_resolution_clock Clock;
+	
+	std::ostringstream plain;
+	turtle::N3PWriter plainWriter(plain);
+	Clock::time_point t0 = Clock::now();
+	translate(input, plainWriter);
+	Clock::time_point t1 = Clock::now();
+	
+	std::ostringstream dict;
+	turtle::N3PDictWriter dictWriter(dict);
+	translate(input, dictWriter);
+	Clock::time_point t2 = Clock::now();
+	
+	double plainMs = std::chrono::duration<double, std::milli>(t1 - t0).count();
+	double dictMs  = std::chrono::duration<double, std::milli>(t2 - t1).count();
+	
+	std::cout << "n3p:      " << plain.str().size() << " bytes, " << plainMs << " ms (" << (1000.0 * plainWriter.count() / plainMs) << " triples/s)" << std::endl;
+	std::cout << "n3p-dict: " << dict.str().size()  << " bytes, " << dictMs  << " ms (" << (1000.0 * dictWriter.count() / dictMs) << " triples/s)" << std::endl;
+	
+	REQUIRE(dict.str().size() < plain.str().size());
+}
+
+TEST_CASE("clustered clauses are contiguous", "[n3p-clustered]")
+{
+	std::string input = INPUT + interleaved(2000);
+	
+	std::ostringstream plain;
+	std::ostringstream clustered;
+	
+	turtle::N3PWriter plainWriter(plain);
+	turtle::N3PClusteredWriter clusteredWriter(clustered, false, 4096); // small enough to spill
+	TeeSink tee(plainWriter, clusteredWriter);
+	
+	translate(input, tee);
+	
+	REQUIRE(clusteredWriter.count() == plainWriter.count());
+	REQUIRE(clusteredWriter.spills() > 0);
+	
+	std::multiset<std::string> expected = lines(plain.str());
+	expected.erase(":- style_check(-discontiguous).");
+	REQUIRE(lines(clustered.str()) == expected);
+	
+	std::istringstream in(clustered.str());
+	std::string line, functor;
+	std::set<std::string> seen;
+	while (std::getline(in, line)) {
+		if (line.compare(0, 2, ":-") == 0)
+			continue;
+		
+		std::string f = line.substr(0, line.find('('));
+		if (f != functor) {
+			REQUIRE(seen.insert(f).second);
+			functor = f;
+		}
+	}
+}
+
+TEST_CASE("clustered load time", "[.][benchmark]")
+{
+	typedef std::chrono::high_resolution_clock Clock;
+	
+	std::string input = interleaved(200000);
+	
+	const std::string plainFile = "n3p-benchmark.pl";
+	const std::string clusteredFile = "n3p-clustered-benchmark.pl";
+	
+	Clock::time_point t0 = Clock::now();
+	{
+		std::ofstream out(plainFile);
+		turtle::N3PWriter writer(out);
+		translate(input, writer);
+	}
+	Clock::time_point t1 = Clock::now();
+	{
+		std::ofstream out(clusteredFile);
+		turtle::N3PClusteredWriter writer(out, false, 4 * 1024 * 1024);
+		translate(input, writer);
+	}
+	Clock::time_point t2 = Clock::now();
+	
+	std::cout << "n3p:           written in " << std::chrono::duration<double, std::milli>(t1 - t0).count() << " ms" << std::endl;
+	std::cout << "n3p-clustered: written in " << std::chrono::duration<double, std::milli>(t2 - t1).count() << " ms" << std::endl;
+	
+	double plainMs = load(plainFile);
+	double clusteredMs = load(clusteredFile);
+	
+	if (plainMs < 0 || clusteredMs < 0)
+		std::cout << "swipl not available, load times not measured" << std::endl;
+	else
+		std::cout << "swipl load: n3p " << plainMs << " ms, n3p-clustered " << clusteredMs << " ms" << std::endl;
+	
+	std::remove(plainFile.c_str());
+	std::remove(clusteredFile.c_str());
+}
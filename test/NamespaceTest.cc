@@ -0,0 +1,119 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include "../src/Parser.hh"
+#include "../src/NTriplesWriter.hh"
+#include "../src/N3PWriter.hh"
+#include "TestSinks.hh"
+
+#include "catch.hpp"
+
+
+namespace {
+	
+	const Graph &parse(const std::string &document, TestSink &sink)
+	{
+		std::stringstream input(document);
+		turtle::Parser parser(&input, turtle::Uri("http://localhost/test"), &sink);
+		parser.parse();
+		
+		return sink.getResult();
+	}
+	
+}
+
+TEST_CASE("prefixed names keep namespace and local name apart", "[namespace]")
+{
+	TestSink sink;
+	const Graph &graph = parse("@prefix ex: <http://example.org/> .\nex:s ex:p\\.q <http://example.org/o>, ex: .\n", sink);
+	
+	REQUIRE(graph.size() == 2);
+	
+	const turtle::URIResource &subject = dynamic_cast<const turtle::URIResource &>(graph[0].subject());
+	REQUIRE(subject.namespaceEntry().get() != nullptr);
+	REQUIRE(subject.namespaceEntry()->value() == "http://example.org/");
+	REQUIRE(subject.localName() == "s");
+	REQUIRE(subject.uri() == "http://example.org/s");
+	
+	const turtle::URIResource &property = dynamic_cast<const turtle::URIResource &>(graph[0].property());
+	REQUIRE(property.namespaceEntry().get() == subject.namespaceEntry().get());
+	REQUIRE(property.localName() == "p.q");
+	REQUIRE(property.uri() == "http://example.org/p.q");
+	
+	const turtle::URIResource &object = dynamic_cast<const turtle::URIResource &>(graph[0].object());
+	REQUIRE(object.namespaceEntry().get() == nullptr);
+	REQUIRE(object.localName() == "http://example.org/o");
+	
+	const turtle::URIResource &empty = dynamic_cast<const turtle::URIResource &>(graph[1].object());
+	REQUIRE(empty.namespaceEntry().get() == subject.namespaceEntry().get());
+	REQUIRE(empty.localName().empty());
+	REQUIRE(empty.uri() == "http://example.org/");
+}
+
+TEST_CASE("every parser has namespaces of its own", "[namespace]")
+{
+	TestSink first, second;
+	const Graph &a = parse("@prefix ex: <http://example.org/> .\nex:s ex:p ex:o .\n", first);
+	const Graph &b = parse("PREFIX x: <http://example.org/>\nx:s x:p x:o .\n", second);
+	
+	// the parsers are gone, the resources keep their namespace
+	const turtle::URIResource &s = dynamic_cast<const turtle::URIResource &>(a[0].subject());
+	const turtle::URIResource &t = dynamic_cast<const turtle::URIResource &>(b[0].subject());
+	REQUIRE(s.namespaceEntry().get() != t.namespaceEntry().get());
+	REQUIRE(s.uri() == "http://example.org/s");
+	REQUIRE(t.namespaceEntry()->value() == "http://example.org/");
+	
+	std::unique_ptr<turtle::URIResource> clone(s.clone());
+	REQUIRE(clone->namespaceEntry().get() == s.namespaceEntry().get());
+}
+
+TEST_CASE("split resources are well-known", "[namespace]")
+{
+	TestSink sink;
+	const Graph &graph = parse("@prefix rdf: <" N3_RDF "> .\n@prefix r: <http://www.w3.org/1999/02/> .\n<http://a> rdf:type r:22-rdf-syntax-ns\\#Property, rdf:typo .\n", sink);
+	
+	REQUIRE(graph[0].property().wellKnown() == turtle::WellKnown::RDF_TYPE);
+	REQUIRE(dynamic_cast<const turtle::URIResource &>(graph[0].object()).wellKnown() == turtle::WellKnown::RDF_PROPERTY);
+	REQUIRE(dynamic_cast<const turtle::URIResource &>(graph[1].object()).wellKnown() == turtle::WellKnown::NONE);
+}
+
+TEST_CASE("writers print split resources like whole ones", "[namespace]")
+{
+	turtle::InternedRef ns = turtle::InternedRef::make("http://example.org/it's/");
+	turtle::URIResource split(ns, std::string("a"));
+	turtle::URIResource whole(std::string("http://example.org/it's/a"));
+	
+	std::unique_ptr<turtle::URIResource> clone(split.clone());
+	REQUIRE(clone->namespaceEntry().get() == ns.get());
+	REQUIRE(clone->uri() == whole.uri());
+	
+	std::ostringstream nt;
+	turtle::NTripleFormatter ntriples(nt);
+	split.visit(ntriples);
+	split.visit(ntriples);
+	whole.visit(ntriples);
+	REQUIRE(nt.str() == "<http://example.org/it's/a><http://example.org/it's/a><http://example.org/it's/a>");
+	
+	std::ostringstream n3p;
+	turtle::N3PFormatter prolog(n3p, false);
+	split.visit(prolog);
+	whole.visit(prolog);
+	REQUIRE(n3p.str() == "'<http://example.org/it\\'s/a>''<http://example.org/it\\'s/a>'");
+}
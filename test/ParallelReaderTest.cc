@@ -0,0 +1,121 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include <map>
+
+#include "../src/Parser.hh"
+#include "../src/NTriplesWriter.hh"
+#include "../src/ParallelReader.hh"
+
+#include "catch.hpp"
+
+
+namespace {
+	
+	/// inputs are not files, the reader looks them up in a map
+	std::map<std::string, std::string> documents()
+	{
+		std::map<std::string, std::string> docs;
+		for (int i = 0; i < 50; i++) {
+			std::ostringstream doc;
+			for (int j = 0; j < 100 * (i % 7); j++)
+				doc << "<s" << i << "> <p> <o" << j << "> .\n";
+			docs["doc" + std::to_string(i)] = doc.str();
+		}
+		
+		return docs;
+	}
+	
+	void parse(const std::string &document, const std::string &base, turtle::TripleSink *sink)
+	{
+		std::istringstream in(document);
+		turtle::Parser parser(&in, turtle::Uri(base), sink);
+		parser.parse();
+	}
+}
+
+
+TEST_CASE("parallel reading keeps input order", "[parallel]")
+{
+	std::map<std::string, std::string> docs = documents();
+	std::vector<std::string> inputs;
+	for (auto &doc : docs)
+		inputs.push_back(doc.first);
+	
+	std::ostringstream expected;
+	{
+		turtle::NTriplesWriter writer(expected);
+		writer.start();
+		for (const std::string &input : inputs)
+			parse(docs[input], "http://localhost/" + input, &writer);
+		writer.end();
+	}
+	
+	std::ostringstream out;
+	turtle::NTriplesWriter writer(out);
+	turtle::ParallelReader pool(inputs, 4, [&docs](const std::string &input, turtle::TripleSink *sink) { parse(docs.at(input), "http://localhost/" + input, sink); });
+	writer.start();
+	for (std::size_t i = 0; i < inputs.size(); i++)
+		pool.replay(i, &writer);
+	writer.end();
+	
+	REQUIRE(out.str() == expected.str());
+	REQUIRE(writer.count() == 100 * (0+1+2+3+4+5+6) * 7);
+}
+
+TEST_CASE("parallel reading passes on errors", "[parallel]")
+{
+	std::vector<std::string> inputs = { "<a> <b> <c> .", "<a> <b> .", "<a> <b> <d> ." };
+	
+	std::ostringstream out;
+	turtle::NTriplesWriter writer(out);
+	turtle::ParallelReader pool(inputs, 2, [](const std::string &input, turtle::TripleSink *sink) { parse(input, "http://localhost/", sink); });
+	
+	writer.start();
+	pool.replay(0, &writer);
+	REQUIRE_THROWS_AS(pool.replay(1, &writer), turtle::ParseException);
+	writer.end();
+	
+	REQUIRE(writer.count() == 1);
+}
+
+TEST_CASE("parallel reading does not read too far ahead", "[parallel]")
+{
+	std::vector<std::string> inputs(20, "<a> <b> <c> .");
+	std::atomic<int> started(0);
+	
+	std::ostringstream out;
+	turtle::NTriplesWriter writer(out);
+	turtle::ParallelReader pool(inputs, 2, [&started](const std::string &input, turtle::TripleSink *sink) { ++started; parse(input, "http://localhost/", sink); });
+	
+	writer.start();
+	pool.replay(0, &writer);
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	REQUIRE(started <= static_cast<int>(1 + turtle::ParallelReader::READ_AHEAD * 2));
+	
+	for (std::size_t i = 1; i < inputs.size(); i++)
+		pool.replay(i, &writer);
+	writer.end();
+	
+	REQUIRE(started == 20);
+	REQUIRE(writer.count() == 20);
+}
@@ -23,167 +23,11 @@
 #include "../src/Parser.hh"
 #include "../src/NTriplesWriter.hh"
 #include "../src/Utf16.hh"
+#include "TestSinks.hh"
 
 #include "catch.hpp"
 
 
-class Triple {
-	turtle::Resource *m_subject;
-	turtle::URIResource *m_property;
-	turtle::N3Node *m_object;
-	
-public:
-
-	Triple(const turtle::Resource &subject, const turtle::URIResource &property, const turtle::N3Node &object)
-		: m_subject(subject.clone()), m_property(property.clone()), m_object(object.clone())
-	{
-		// nop
-	}
-	
-	Triple(const Triple &triple)
-		: m_subject(triple.m_subject->clone()), m_property(triple.m_property->clone()), m_object(triple.m_object->clone())
-	{
-		// nop
-	}
-	
-	Triple(Triple&& triple) : m_subject(), m_property(), m_object()
-	{
-		swap(*this, triple);
-	}
-	
-	Triple &operator=(Triple triple)
-	{
-		swap(*this, triple);
-		
-		return *this;
-	}
-	
-	~Triple()
-	{
-		delete m_subject;
-		delete m_property;
-		delete m_object;
-	}
-	
-	turtle::Resource    &subject()  const { return *m_subject;  }
-	turtle::URIResource &property() const { return *m_property; }
-	turtle::N3Node      &object()   const { return *m_object;   }
-	
-	friend void swap(Triple& first, Triple& second)
-	{
-		std::swap(first.m_subject, second.m_subject);
-		std::swap(first.m_property, second.m_property);
-		std::swap(first.m_object, second.m_object);
-	}
-	
-};
-
-class Graph {
-	
-	std::vector<Triple> m_triples;
-	
-public:
-
-	Graph() : m_triples() {}
-	
-	
-	Graph(const Graph &graph) : m_triples(graph.m_triples)
-	{
-	}
-	
-	Graph(Graph &&graph) : m_triples()
-	{
-		m_triples.swap(graph.m_triples);
-	}
-	
-	Graph &operator=(Graph graph)
-	{
-		swap(graph);
-	
-		return *this;
-	}
-	
-	Graph &operator=(Graph &&graph) noexcept
-	{
-		m_triples.swap(graph.m_triples);
-	
-		return *this;
-	}
-	
-	~Graph()
-	{
-	}
-	
-	void swap(Graph &other) noexcept
-	{
-		m_triples.swap(other.m_triples);
-	}
-	
-	void add(const turtle::Resource &subject, const turtle::URIResource &property, const turtle::N3Node &object)
-	{
-		m_triples.push_back(Triple(subject, property, object));
-	}
-	
-	const Triple &operator[](std::size_t index) const
-	{
-		return m_triples[index];
-	}
-	
-	Triple &operator[](std::size_t index)
-	{
-		return m_triples[index];
-	}
-	
-	std::size_t size() const
-	{
-		return m_triples.size();
-	}
-
-};
-
-class TestSink : public turtle::TripleSink {
-	
-	Graph m_graph;
-	
-public:
-	
-	TestSink() : m_graph()
-	{
-		// nop
-	}
-	
-	void start()
-	{
-		// nop
-	}
-	
-	void end()
-	{
-		// nop
-	}
-	
-	void document(const std::string &source)
-	{
-		// nop
-	}
-	
-	void prefix(const std::string &prefix, const std::string &ns)
-	{
-		// nop
-	}
-	
-	void triple(const turtle::Resource &subject, const turtle::URIResource &property, const turtle::N3Node &object)
-	{
-		m_graph.add(subject, property, object);
-	}
-	
-	unsigned count() const { return m_graph.size(); }
-	
-	const Graph &getResult() const { return m_graph; }
-};
-
-
-
 TEST_CASE("escaping", "[parser]")
 {
 	turtle::Uri base("http://localhost/test");
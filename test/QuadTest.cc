@@ -0,0 +1,186 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <string>
+#include <sstream>
+#include <memory>
+#include <set>
+
+#include "../src/Parser.hh"
+#include "../src/NTriplesWriter.hh"
+#include "../src/N3PWriter.hh"
+#include "../src/BinaryWriter.hh"
+#include "../src/BinaryReader.hh"
+#include "../src/DedupSink.hh"
+#include "../src/DocumentGraphSink.hh"
+#include "TestSinks.hh"
+
+#include "catch.hpp"
+
+
+namespace {
+	
+	const std::string TRIG =
+		"@prefix ex: <http://example.org/ns#> .\n"
+		"ex:s ex:p ex:o .\n"
+		"{ ex:s ex:p ex:d }\n"
+		"ex:g1 { ex:s ex:p ex:o1 . ex:s ex:q [ ex:r 1 ] . }\n"
+		"GRAPH ex:g2 { ex:s ex:p ex:o2 ; ex:q ex:o3 }\n"
+		"graph _:g3 { ex:s ex:p \"x\"@en }\n"
+		"[] { ex:s ex:p ex:o4 }\n"
+		"[ ex:p ex:o5 ] .\n";
+	
+	std::string nquads(const std::string &input, turtle::Parser::Syntax syntax)
+	{
+		std::ostringstream out;
+		turtle::NQuadsWriter writer(out);
+		translate(input, writer, syntax);
+		
+		return out.str();
+	}
+	
+	/// strips the generated prefixes of blank node ids, "_:bXYZ-label" becomes "_:label"
+	std::string blanks(std::string s)
+	{
+		std::size_t p = 0;
+		while ((p = s.find("_:b", p)) != std::string::npos) {
+			std::size_t end  = s.find(' ', p);
+			std::size_t dash = s.rfind('-', end);
+			s.erase(p + 2, dash - p - 1);
+			p += 2;
+		}
+		
+		return s;
+	}
+}
+
+
+TEST_CASE("trig graphs", "[quads]")
+{
+	std::multiset<std::string> expected = {
+		"<http://example.org/ns#s> <http://example.org/ns#p> <http://example.org/ns#o> .",
+		"<http://example.org/ns#s> <http://example.org/ns#p> <http://example.org/ns#d> .",
+		"<http://example.org/ns#s> <http://example.org/ns#p> <http://example.org/ns#o1> <http://example.org/ns#g1> .",
+		"_:0 <http://example.org/ns#r> \"1\"^^<http://www.w3.org/2001/XMLSchema#integer> <http://example.org/ns#g1> .",
+		"<http://example.org/ns#s> <http://example.org/ns#q> _:0 <http://example.org/ns#g1> .",
+		"<http://example.org/ns#s> <http://example.org/ns#p> <http://example.org/ns#o2> <http://example.org/ns#g2> .",
+		"<http://example.org/ns#s> <http://example.org/ns#q> <http://example.org/ns#o3> <http://example.org/ns#g2> .",
+		"<http://example.org/ns#s> <http://example.org/ns#p> \"x\"@en _:g3 .",
+		"<http://example.org/ns#s> <http://example.org/ns#p> <http://example.org/ns#o4> _:1 .",
+		"_:2 <http://example.org/ns#p> <http://example.org/ns#o5> ."
+	};
+	
+	REQUIRE(lines(blanks(nquads(TRIG, turtle::Parser::TRIG))) == expected);
+}
+
+TEST_CASE("trig syntax errors", "[quads]")
+{
+	REQUIRE_THROWS_AS(nquads("<http://a> { <http://s> <http://p> <http://o> ", turtle::Parser::TRIG), turtle::ParseException);
+	REQUIRE_THROWS_AS(nquads("( 1 ) { <http://s> <http://p> <http://o> }", turtle::Parser::TRIG), turtle::ParseException);
+	REQUIRE_THROWS_AS(nquads("{ <http://s> <http://p> <http://o> }", turtle::Parser::TURTLE), turtle::ParseException);
+}
+
+TEST_CASE("n-quads round trip", "[quads]")
+{
+	std::string output = nquads(TRIG, turtle::Parser::TRIG);
+	
+	REQUIRE(lines(nquads(output, turtle::Parser::NQUADS)).size() == 10);
+	REQUIRE(lines(blanks(nquads(output, turtle::Parser::NQUADS))) == lines(blanks(output)));
+}
+
+TEST_CASE("n-quads syntax errors", "[quads]")
+{
+	REQUIRE(lines(nquads("<http://s> <http://p> \"x\"^^<http://t> _:g .\n<http://s> <http://p> \"y\"@en .\n", turtle::Parser::NQUADS)).size() == 2);
+	
+	// Turtle terms
+	REQUIRE_THROWS_AS(nquads("( <http://a> ) <http://p> <http://o> .", turtle::Parser::NQUADS), turtle::ParseException);
+	REQUIRE_THROWS_AS(nquads("<http://s> <http://p> ( <http://a> ) .", turtle::Parser::NQUADS), turtle::ParseException);
+	REQUIRE_THROWS_AS(nquads("<http://s> <http://p> [ <http://q> <http://o> ] .", turtle::Parser::NQUADS), turtle::ParseException);
+	REQUIRE_THROWS_AS(nquads("<http://s> <http://p> <http://o> [] .", turtle::Parser::NQUADS), turtle::ParseException);
+	REQUIRE_THROWS_AS(nquads("<http://s> <http://p> 42 .", turtle::Parser::NQUADS), turtle::ParseException);
+	REQUIRE_THROWS_AS(nquads("<http://s> <http://p> true .", turtle::Parser::NQUADS), turtle::ParseException);
+	REQUIRE_THROWS_AS(nquads("<http://s> <http://p> 'x' .", turtle::Parser::NQUADS), turtle::ParseException);
+	REQUIRE_THROWS_AS(nquads("<http://s> <http://p> \"\"\"x\"\"\" .", turtle::Parser::NQUADS), turtle::ParseException);
+	REQUIRE_THROWS_AS(nquads("<http://s> a <http://o> .", turtle::Parser::NQUADS), turtle::ParseException);
+	
+	// relative IRIs
+	REQUIRE_THROWS_AS(nquads("<s> <http://p> <http://o> .", turtle::Parser::NQUADS), turtle::ParseException);
+	REQUIRE_THROWS_AS(nquads("<http://s> <p> <http://o> .", turtle::Parser::NQUADS), turtle::ParseException);
+	REQUIRE_THROWS_AS(nquads("<http://s> <http://p> <o> .", turtle::Parser::NQUADS), turtle::ParseException);
+	REQUIRE_THROWS_AS(nquads("<http://s> <http://p> \"x\"^^<t> .", turtle::Parser::NQUADS), turtle::ParseException);
+	REQUIRE_THROWS_AS(nquads("<http://s> <http://p> <http://o> <g> .", turtle::Parser::NQUADS), turtle::ParseException);
+}
+
+TEST_CASE("n3p graph argument", "[quads]")
+{
+	std::ostringstream out;
+	turtle::N3PWriter writer(out);
+	translate(TRIG, writer, turtle::Parser::TRIG);
+	
+	std::string s = out.str();
+	REQUIRE(s.find(":- dynamic('<http://example.org/ns#p>'/3).") != std::string::npos);
+	REQUIRE(s.find("'<http://example.org/ns#p>'('<http://example.org/ns#s>','<http://example.org/ns#o1>','<http://example.org/ns#g1>').") != std::string::npos);
+	REQUIRE(s.find("'<http://example.org/ns#p>'('<http://example.org/ns#s>','<http://example.org/ns#o>').") != std::string::npos);
+	REQUIRE(s.find("pred('<http://example.org/ns#q>').") != std::string::npos);
+}
+
+TEST_CASE("binary and dedup keep graphs", "[quads]")
+{
+	std::ostringstream binary;
+	{
+		turtle::BinaryWriter writer(binary);
+		translate(TRIG + "ex:g1 { ex:s ex:p ex:o1 } ex:g2 { ex:s ex:p ex:o1 }", writer, turtle::Parser::TRIG);
+	}
+	
+	std::ostringstream out;
+	std::unique_ptr<turtle::TripleSink> writer(new turtle::NQuadsWriter(out));
+	turtle::DedupSink dedup(std::move(writer));
+	
+	std::istringstream in(binary.str());
+	turtle::BinaryReader reader(&in, &dedup);
+	dedup.start();
+	reader.read();
+	dedup.end();
+	
+	REQUIRE(dedup.duplicates() == 1);
+	REQUIRE(lines(blanks(out.str())).size() == 11);
+	REQUIRE(out.str().find("<http://example.org/ns#o1> <http://example.org/ns#g2> .") != std::string::npos);
+}
+
+TEST_CASE("document as graph name", "[quads]")
+{
+	std::ostringstream out;
+	std::unique_ptr<turtle::TripleSink> writer(new turtle::NQuadsWriter(out));
+	turtle::DocumentGraphSink sink(std::move(writer));
+	
+	sink.start();
+	for (const char *doc : { "http://localhost/a", "http://localhost/b" }) {
+		std::istringstream in("<s> <p> <o> . <g> { <s> <p> <o2> }");
+		turtle::Parser parser(&in, turtle::Uri(doc), &sink, turtle::Parser::TRIG);
+		parser.parse();
+	}
+	sink.end();
+	
+	std::multiset<std::string> expected = {
+		"<http://localhost/s> <http://localhost/p> <http://localhost/o> <http://localhost/a> .",
+		"<http://localhost/s> <http://localhost/p> <http://localhost/o2> <http://localhost/a> .",
+		"<http://localhost/s> <http://localhost/p> <http://localhost/o> <http://localhost/b> .",
+		"<http://localhost/s> <http://localhost/p> <http://localhost/o2> <http://localhost/b> ."
+	};
+	
+	REQUIRE(lines(out.str()) == expected);
+	REQUIRE(sink.count() == 4);
+}
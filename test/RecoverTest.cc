@@ -0,0 +1,121 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <string>
+#include <sstream>
+#include <vector>
+#include <utility>
+
+#include "../src/Parser.hh"
+#include "../src/NTriplesWriter.hh"
+
+#include "catch.hpp"
+
+
+namespace {
+	
+	typedef std::vector<std::pair<int, std::string>> Errors;
+	
+	std::string recover(const std::string &input, Errors &errors, turtle::Parser::Syntax syntax = turtle::Parser::TURTLE)
+	{
+		std::ostringstream out;
+		turtle::NTriplesWriter writer(out);
+		std::istringstream in(input);
+		
+		writer.start();
+		turtle::Parser parser(&in, turtle::Uri("http://localhost/test"), &writer, syntax);
+		parser.recover([&errors](const turtle::ParseException &e) { errors.push_back(std::make_pair(e.line(), std::string(e.what()))); });
+		parser.parse();
+		writer.end();
+		
+		return out.str();
+	}
+	
+	bool contains(const std::string &s, const std::string &part)
+	{
+		return s.find(part) != std::string::npos;
+	}
+	
+}
+
+
+TEST_CASE("recovering skips bad statements", "[parser][recover]")
+{
+	const std::string input =
+		"@prefix ex: <http://example.org/> .\n"
+		"ex:a ex:p ex:b .\n"
+		"ex:c ex:p \"unterminated .\n"
+		"ex:d ex:p ex:e ; ex:q [ ex:r unknown:x ] .\n"
+		"ex:f ex:p ex:g .\n"
+		"ex:h ex:p ex:i ex:j .\n"
+		"ex:k ex:p 1 .\n";
+	
+	Errors errors;
+	std::string out = recover(input, errors);
+	
+	REQUIRE(errors.size() == 3);
+	REQUIRE(errors[0].first == 3);
+	REQUIRE(errors[1].first == 4);
+	REQUIRE(errors[1].second == "unknown prefix: unknown");
+	REQUIRE(errors[2].first == 6);
+	
+	REQUIRE(contains(out, "<http://example.org/a> <http://example.org/p> <http://example.org/b> ."));
+	REQUIRE(contains(out, "<http://example.org/f> <http://example.org/p> <http://example.org/g> ."));
+	REQUIRE(contains(out, "<http://example.org/k> <http://example.org/p> \"1\""));
+	
+	// nothing of a skipped statement gets through, not even the triples before the error
+	REQUIRE_FALSE(contains(out, "<http://example.org/d>"));
+	REQUIRE_FALSE(contains(out, "<http://example.org/h>"));
+}
+
+TEST_CASE("recovering at the end of the input", "[parser][recover]")
+{
+	Errors errors;
+	std::string out = recover("<http://example.org/a> <http://example.org/p> <http://example.org/b> .\n<http://example.org/c> <http://example.org/p>", errors);
+	
+	REQUIRE(errors.size() == 1);
+	REQUIRE(contains(out, "<http://example.org/a>"));
+	REQUIRE_FALSE(contains(out, "<http://example.org/c>"));
+}
+
+TEST_CASE("recovering skips the rest of a TriG graph", "[parser][recover]")
+{
+	const std::string input =
+		"@prefix ex: <http://example.org/> .\n"
+		"ex:g1 { ex:a ex:p ex:b . ex:c ex:p . ex:d ex:p ex:e }\n"
+		"ex:g2 { ex:f ex:p ex:g }\n"
+		"ex:h ex:p ex:i .\n";
+	
+	Errors errors;
+	std::string out = recover(input, errors, turtle::Parser::TRIG);
+	
+	REQUIRE(errors.size() == 1);
+	REQUIRE(errors[0].first == 2);
+	REQUIRE(contains(out, "<http://example.org/a>"));
+	REQUIRE_FALSE(contains(out, "<http://example.org/d>"));
+	REQUIRE(contains(out, "<http://example.org/f>"));
+	REQUIRE(contains(out, "<http://example.org/h>"));
+}
+
+TEST_CASE("without recovering the first error stops the parser", "[parser][recover]")
+{
+	std::ostringstream out;
+	turtle::NTriplesWriter writer(out);
+	std::istringstream in("<http://example.org/a> <http://example.org/p> .\n<http://example.org/b> <http://example.org/p> <http://example.org/c> .\n");
+	
+	turtle::Parser parser(&in, turtle::Uri("http://localhost/test"), &writer);
+	REQUIRE_THROWS_AS(parser.parse(), turtle::ParseException);
+}
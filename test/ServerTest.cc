@@ -0,0 +1,157 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <string>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <map>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <iostream>
+
+#include "../src/Parser.hh"
+#include "../src/NTriplesWriter.hh"
+#include "../src/OutputFile.hh"
+#include "../src/Server.hh"
+
+#include "catch.hpp"
+
+#ifndef _WIN32
+
+namespace {
+	
+	const std::string SOCKET = "cturtle-test.sock";
+	
+	struct TestServer {
+		
+		std::map<std::string, std::string> documents;
+		turtle::Server server;
+		std::thread thread;
+		
+		explicit TestServer(unsigned threads = 2) :
+			documents(), server(SOCKET, threads, [this](const turtle::Server::Request &request, std::ostream &out) { translate(request, out); }), thread()
+		{
+			thread = std::thread(&turtle::Server::run, &server);
+		}
+		
+		~TestServer()
+		{
+			server.stop();
+			thread.join();
+		}
+		
+		void translate(const turtle::Server::Request &request, std::ostream &out)
+		{
+			std::istringstream in(documents.at(request.input));
+			turtle::NTriplesWriter writer(out);
+			turtle::Parser parser(&in, turtle::Uri(request.base.empty() ? "http://localhost/" : request.base), &writer);
+			writer.start();
+			parser.parse();
+			writer.end();
+		}
+	};
+	
+	std::string request(const std::string &input, const std::string &base, std::string &status)
+	{
+		std::ostringstream out;
+		status = turtle::Server::request(SOCKET, turtle::Server::Request { input, "nt", base }, out);
+		
+		return out.str();
+	}
+}
+
+
+TEST_CASE("server requests", "[server]")
+{
+	TestServer test;
+	test.documents["small"] = "<s> <p> <o> .";
+	test.documents["bad"]   = "<s> <p> <o> . <s> <p> .";
+	
+	std::ostringstream large;
+	for (int i = 0; i < 20000; i++)
+		large << "<s> <p> <o" << i << "> .\n";
+	test.documents["large"] = large.str();
+	
+	std::string status;
+	
+	REQUIRE(request("small", std::string(), status) == "<http://localhost/s> <http://localhost/p> <http://localhost/o> .\n");
+	REQUIRE(status.empty());
+	
+	REQUIRE(request("small", "http://example.org/", status) == "<http://example.org/s> <http://example.org/p> <http://example.org/o> .\n");
+	
+	std::string output = request("large", std::string(), status);
+	REQUIRE(status.empty());
+	REQUIRE(std::count(output.begin(), output.end(), '\n') == 20000);
+	
+	REQUIRE(request("bad", std::string(), status) == "<http://localhost/s> <http://localhost/p> <http://localhost/o> .\n");
+	REQUIRE(status == "parse error at line 1: expected object");
+	
+	request("missing", std::string(), status);
+	REQUIRE(!status.empty());
+}
+
+TEST_CASE("server refuses bad sockets and requests", "[server]")
+{
+	{
+		std::ofstream file(SOCKET);
+		file << "not a socket";
+	}
+	REQUIRE_THROWS_AS(TestServer(), turtle::IOException);
+	REQUIRE(std::ifstream(SOCKET).good());
+	std::remove(SOCKET.c_str());
+	
+	TestServer test;
+	std::string status;
+	request(std::string(turtle::Server::MAX_REQUEST_LENGTH + 1, 'x'), std::string(), status);
+	REQUIRE(status == "request too long");
+}
+
+TEST_CASE("server request lines", "[server]")
+{
+	turtle::Server::Request request;
+	
+	REQUIRE(turtle::Server::parse("/data/a.ttl\tn3p\thttp://example.org/", request));
+	REQUIRE(request.input == "/data/a.ttl");
+	REQUIRE(request.format == "n3p");
+	REQUIRE(request.base == "http://example.org/");
+	
+	REQUIRE(turtle::Server::parse("/data/a.ttl", request));
+	REQUIRE(request.format.empty());
+	REQUIRE(request.base.empty());
+	
+	REQUIRE_FALSE(turtle::Server::parse("", request));
+	REQUIRE_FALSE(turtle::Server::parse("-\tnt\t", request));
+}
+
+TEST_CASE("server latency", "[.][benchmark]")
+{
+	TestServer test;
+	test.documents["small"] = "@prefix ex: <http://example.org/> . ex:s ex:p ex:o1, ex:o2, ex:o3 .";
+	
+	const int n = 1000;
+	std::string status;
+	
+	auto start = std::chrono::high_resolution_clock::now();
+	for (int i = 0; i < n; i++)
+		request("small", std::string(), status);
+	std::chrono::duration<double, std::micro> d = std::chrono::high_resolution_clock::now() - start;
+	
+	std::cout << "average request latency: " << d.count() / n << " us" << std::endl;
+}
+
+#endif // _WIN32
@@ -0,0 +1,138 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <string>
+#include <sstream>
+#include <vector>
+#include <memory>
+#include <set>
+
+#include "../src/Parser.hh"
+#include "../src/N3PWriter.hh"
+#include "../src/NTriplesWriter.hh"
+#include "../src/ShardingSink.hh"
+#include "../src/OutputFile.hh"
+#include "TestSinks.hh"
+
+#include "catch.hpp"
+
+
+namespace {
+	
+	const unsigned SHARDS = 4;
+	
+	std::string input(bool list)
+	{
+		std::string data = "@prefix ex: <http://example.org/ns#> .\n";
+		for (int i = 0; i < 5000; i++)
+			data += "ex:s" + std::to_string(i) + " ex:p" + std::to_string(i % 7) + " ex:o ; a ex:Class .\n";
+		if (list)
+			data += "[ ex:p0 ( 1 2 ) ] .\n";
+		
+		return data;
+	}
+	
+	unsigned shard(const std::string &data, turtle::ShardingSink::Key key, std::vector<std::ostringstream> &outputs, bool n3p)
+	{
+		std::vector<std::unique_ptr<turtle::TripleSink>> sinks;
+		for (auto &out : outputs) {
+			if (n3p)
+				sinks.emplace_back(new turtle::N3PWriter(out));
+			else
+				sinks.emplace_back(new turtle::NTriplesWriter(out));
+		}
+		
+		turtle::ShardingSink sink(std::move(sinks), key);
+		
+		std::istringstream in(data);
+		sink.start();
+		turtle::Parser parser(&in, turtle::Uri("http://localhost/test"), &sink);
+		parser.parse();
+		sink.end();
+		
+		return sink.count();
+	}
+}
+
+
+TEST_CASE("numbered shard file names", "[sharding]")
+{
+	REQUIRE(turtle::OutputFile::numbered("out.n3p.gz", 3) == "out.3.n3p.gz");
+	REQUIRE(turtle::OutputFile::numbered("dir.d/out", 0) == "dir.d/out.0");
+	REQUIRE(turtle::OutputFile::numbered(".hidden.nt", 1) == ".hidden.1.nt");
+}
+
+TEST_CASE("shards by subject", "[sharding]")
+{
+	std::string data = input(false);
+	
+	std::ostringstream single;
+	{
+		turtle::NTriplesWriter writer(single);
+		std::istringstream in(data);
+		writer.start();
+		turtle::Parser parser(&in, turtle::Uri("http://localhost/test"), &writer);
+		parser.parse();
+		writer.end();
+	}
+	
+	std::vector<std::ostringstream> outputs(SHARDS);
+	shard(data, turtle::ShardingSink::SUBJECT, outputs, false);
+	
+	REQUIRE(lines(single.str()).size() == 10000);
+	
+	std::multiset<std::string> all;
+	std::set<std::string> subjects;
+	for (auto &out : outputs) {
+		REQUIRE(!out.str().empty());
+		
+		std::set<std::string> own;
+		for (const std::string &line : lines(out.str())) {
+			all.insert(line);
+			own.insert(line.substr(0, line.find(' ')));
+		}
+		for (const std::string &s : own)
+			REQUIRE(subjects.insert(s).second); // no subject in two shards
+	}
+	
+	REQUIRE(all == lines(single.str()));
+}
+
+TEST_CASE("n3p shards are self-contained", "[sharding]")
+{
+	std::vector<std::ostringstream> outputs(SHARDS);
+	unsigned count = shard(input(true), turtle::ShardingSink::PREDICATE, outputs, true);
+	
+	REQUIRE(count == 10001);
+	
+	std::set<std::string> predicates;
+	for (auto &out : outputs) {
+		std::string s = out.str();
+		
+		REQUIRE(s.find(":- style_check(-discontiguous).") == 0);
+		REQUIRE(s.find("scount(") != std::string::npos);
+		
+		for (const std::string &line : lines(s)) {
+			if (line.compare(0, 5, "pred(") == 0) {
+				std::string pred = line.substr(5, line.length() - 7);
+				REQUIRE(predicates.insert(pred).second); // no predicate in two shards
+				REQUIRE(s.find("\n" + pred + "(") != std::string::npos);
+			}
+		}
+	}
+	
+	REQUIRE(predicates.size() == 7 + 1);
+}
@@ -0,0 +1,119 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <string>
+#include <sstream>
+#include <memory>
+#include <set>
+
+#include "../src/Parser.hh"
+#include "../src/NTriplesWriter.hh"
+#include "../src/SortingSink.hh"
+#include "TestSinks.hh"
+
+#include "catch.hpp"
+
+
+namespace {
+	
+	std::string input()
+	{
+		std::string data = "@prefix ex: <http://example.org/ns#> .\n";
+		for (int i = 0; i < 3000; i++) {
+			int n = (i * 7919) % 1000; // every triple three times, shuffled
+			data += "ex:s" + std::to_string(n % 100) + " ex:p" + std::to_string(n % 3) + " " + std::to_string(n) + " .\n";
+		}
+		
+		return data;
+	}
+}
+
+
+TEST_CASE("external sort removes duplicates", "[sort]")
+{
+	std::ostringstream out;
+	std::unique_ptr<turtle::TripleSink> writer(new turtle::NTriplesWriter(out));
+	
+	// a tiny budget, to spill many runs and merge them in several passes
+	turtle::SortingSink sink(std::move(writer), true, 4096);
+	translate(input(), sink);
+	
+	REQUIRE(sink.count() == 1000);
+	REQUIRE(sink.duplicates() == 2000);
+	
+	std::istringstream in(out.str());
+	std::string line;
+	std::set<std::string> lines, subjects;
+	std::string subject;
+	while (std::getline(in, line)) {
+		REQUIRE(lines.insert(line).second);
+		
+		std::string s = line.substr(0, line.find(' '));
+		if (s != subject) {
+			REQUIRE(subjects.insert(s).second); // subjects are grouped
+			subject = s;
+		}
+	}
+	
+	REQUIRE(subjects.size() == 100);
+}
+
+TEST_CASE("sort keeps duplicates unless asked", "[sort]")
+{
+	std::ostringstream sorted, plain;
+	
+	std::unique_ptr<turtle::TripleSink> writer(new turtle::NTriplesWriter(sorted));
+	turtle::SortingSink sink(std::move(writer), false, 4096);
+	translate(input(), sink);
+	
+	turtle::NTriplesWriter plainWriter(plain);
+	translate(input(), plainWriter);
+	
+	REQUIRE(sink.count() == 3000);
+	REQUIRE(sink.duplicates() == 0);
+	REQUIRE(lines(sorted.str()) == lines(plain.str()));
+}
+
+TEST_CASE("sort orders by content", "[sort]")
+{
+	std::ostringstream out;
+	std::unique_ptr<turtle::TripleSink> writer(new turtle::NTriplesWriter(out));
+	turtle::SortingSink sink(std::move(writer), true, 4096);
+	translate(input(), sink);
+	
+	// the IRIs have different lengths, s10 comes between s1 and s2
+	std::istringstream in(out.str());
+	std::string line, previous;
+	while (std::getline(in, line)) {
+		std::string iri = line.substr(1, line.find('>') - 1);
+		REQUIRE(previous <= iri);
+		previous = iri;
+	}
+	
+	std::istringstream numbers("<http://a> <http://p> 10, 9, -1, 100 .");
+	std::ostringstream sorted;
+	turtle::SortingSink numberSink(std::unique_ptr<turtle::TripleSink>(new turtle::NTriplesWriter(sorted)), false);
+	numberSink.start();
+	turtle::Parser parser(&numbers, turtle::Uri("http://localhost/test"), &numberSink);
+	parser.parse();
+	numberSink.end();
+	
+	REQUIRE(sorted.str() ==
+		"<http://a> <http://p> \"-1\"^^<http://www.w3.org/2001/XMLSchema#integer> .\n"
+		"<http://a> <http://p> \"9\"^^<http://www.w3.org/2001/XMLSchema#integer> .\n"
+		"<http://a> <http://p> \"10\"^^<http://www.w3.org/2001/XMLSchema#integer> .\n"
+		"<http://a> <http://p> \"100\"^^<http://www.w3.org/2001/XMLSchema#integer> .\n");
+}
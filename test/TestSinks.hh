@@ -0,0 +1,229 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#ifndef N3_TEST_SINKS_HH
+#define N3_TEST_SINKS_HH
+
+#include <vector>
+#include <string>
+#include <set>
+#include <sstream>
+
+#include "../src/Parser.hh"
+
+
+class Triple {
+	turtle::Resource *m_subject;
+	turtle::URIResource *m_property;
+	turtle::N3Node *m_object;
+	
+public:
+
+	Triple(const turtle::Resource &subject, const turtle::URIResource &property, const turtle::N3Node &object)
+		: m_subject(subject.clone()), m_property(property.clone()), m_object(object.clone())
+	{
+		// nop
+	}
+	
+	Triple(const Triple &triple)
+		: m_subject(triple.m_subject->clone()), m_property(triple.m_property->clone()), m_object(triple.m_object->clone())
+	{
+		// nop
+	}
+	
+	Triple(Triple&& triple) : m_subject(), m_property(), m_object()
+	{
+		swap(*this, triple);
+	}
+	
+	Triple &operator=(Triple triple)
+	{
+		swap(*this, triple);
+		
+		return *this;
+	}
+	
+	~Triple()
+	{
+		delete m_subject;
+		delete m_property;
+		delete m_object;
+	}
+	
+	turtle::Resource    &subject()  const { return *m_subject;  }
+	turtle::URIResource &property() const { return *m_property; }
+	turtle::N3Node      &object()   const { return *m_object;   }
+	
+	friend void swap(Triple& first, Triple& second)
+	{
+		std::swap(first.m_subject, second.m_subject);
+		std::swap(first.m_property, second.m_property);
+		std::swap(first.m_object, second.m_object);
+	}
+	
+};
+
+class Graph {
+	
+	std::vector<Triple> m_triples;
+	
+public:
+
+	Graph() : m_triples() {}
+	
+	
+	Graph(const Graph &graph) : m_triples(graph.m_triples)
+	{
+	}
+	
+	Graph(Graph &&graph) : m_triples()
+	{
+		m_triples.swap(graph.m_triples);
+	}
+	
+	Graph &operator=(Graph graph)
+	{
+		swap(graph);
+	
+		return *this;
+	}
+	
+	Graph &operator=(Graph &&graph) noexcept
+	{
+		m_triples.swap(graph.m_triples);
+	
+		return *this;
+	}
+	
+	~Graph()
+	{
+	}
+	
+	void swap(Graph &other) noexcept
+	{
+		m_triples.swap(other.m_triples);
+	}
+	
+	void add(const turtle::Resource &subject, const turtle::URIResource &property, const turtle::N3Node &object)
+	{
+		m_triples.push_back(Triple(subject, property, object));
+	}
+	
+	const Triple &operator[](std::size_t index) const
+	{
+		return m_triples[index];
+	}
+	
+	Triple &operator[](std::size_t index)
+	{
+		return m_triples[index];
+	}
+	
+	std::size_t size() const
+	{
+		return m_triples.size();
+	}
+
+};
+
+class TestSink : public turtle::TripleSink {
+	
+	Graph m_graph;
+	
+public:
+	
+	TestSink() : m_graph()
+	{
+		// nop
+	}
+	
+	void start()
+	{
+		// nop
+	}
+	
+	void end()
+	{
+		// nop
+	}
+	
+	void document(const std::string &source)
+	{
+		// nop
+	}
+	
+	void prefix(const std::string &prefix, const std::string &ns)
+	{
+		// nop
+	}
+	
+	void triple(const turtle::Resource &subject, const turtle::URIResource &property, const turtle::N3Node &object)
+	{
+		m_graph.add(subject, property, object);
+	}
+	
+	unsigned count() const { return m_graph.size(); }
+	
+	const Graph &getResult() const { return m_graph; }
+};
+
+class TeeSink : public turtle::TripleSink {
+	turtle::TripleSink &m_first;
+	turtle::TripleSink &m_second;
+public:
+	TeeSink(turtle::TripleSink &first, turtle::TripleSink &second) : m_first(first), m_second(second) {}
+	
+	void start() override { m_first.start(); m_second.start(); }
+	void end() override   { m_first.end();   m_second.end();   }
+	void document(const std::string &source) override { m_first.document(source); m_second.document(source); }
+	void prefix(const std::string &prefix, const std::string &ns) override { m_first.prefix(prefix, ns); m_second.prefix(prefix, ns); }
+	void triple(const turtle::Resource &subject, const turtle::URIResource &property, const turtle::N3Node &object) override
+	{
+		m_first.triple(subject, property, object);
+		m_second.triple(subject, property, object);
+	}
+	void quad(const turtle::Resource &subject, const turtle::URIResource &property, const turtle::N3Node &object, const turtle::Resource &graph) override
+	{
+		m_first.quad(subject, property, object, graph);
+		m_second.quad(subject, property, object, graph);
+	}
+	unsigned count() const override { return m_first.count(); }
+};
+
+/// Parses input into sink, between sink.start() and sink.end().
+inline void translate(const std::string &input, turtle::TripleSink &sink, turtle::Parser::Syntax syntax = turtle::Parser::TURTLE)
+{
+	std::istringstream in(input);
+	sink.start();
+	turtle::Parser parser(&in, turtle::Uri("http://localhost/test"), &sink, syntax);
+	parser.parse();
+	sink.end();
+}
+
+/// The lines of s, in any order.
+inline std::multiset<std::string> lines(const std::string &s)
+{
+	std::multiset<std::string> result;
+	std::istringstream in(s);
+	std::string line;
+	while (std::getline(in, line))
+		result.insert(line);
+	
+	return result;
+}
+
+#endif /* N3_TEST_SINKS_HH */
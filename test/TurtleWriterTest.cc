@@ -0,0 +1,117 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <string>
+#include <sstream>
+#include <set>
+
+#include "../src/Parser.hh"
+#include "../src/NTriplesWriter.hh"
+#include "../src/TurtleWriter.hh"
+#include "TestSinks.hh"
+
+#include "catch.hpp"
+
+
+namespace {
+	
+	std::string toTurtle(const std::string &input)
+	{
+		std::ostringstream out;
+		turtle::TurtleWriter writer(out);
+		translate(input, writer);
+		
+		return out.str();
+	}
+	
+	std::multiset<std::string> ntriples(const std::string &input)
+	{
+		std::ostringstream out;
+		turtle::NTriplesWriter writer(out);
+		translate(input, writer);
+		
+		std::multiset<std::string> result;
+		std::istringstream in(out.str());
+		std::string line;
+		while (std::getline(in, line))
+			result.insert(line);
+		
+		return result;
+	}
+}
+
+
+TEST_CASE("turtle groups subjects and predicates", "[turtle]")
+{
+	std::string input =
+		"@prefix ex: <http://example.org/ns#> .\n"
+		"ex:s ex:p ex:o1 .\n"
+		"ex:s ex:p ex:o2 .\n"
+		"ex:s a ex:C .\n"
+		"ex:t ex:p \"x\"@en, 1, 1.5, 1e3, true, \"x1\"^^<http://www.w3.org/2001/XMLSchema#integer> .\n"
+		"<http://other.org/a> ex:p <http://example.org/ns#not/local>, <http://example.org/ns#a.> .\n";
+	
+	std::string expected =
+		"@prefix ex: <http://example.org/ns#> .\n"
+		"ex:s ex:p ex:o1 ,\n"
+		"\t\tex:o2 ;\n"
+		"\ta ex:C .\n"
+		"ex:t ex:p \"x\"@en ,\n"
+		"\t\t1 ,\n"
+		"\t\t1.5 ,\n"
+		"\t\t1e3 ,\n"
+		"\t\ttrue ,\n"
+		"\t\t\"x1\"^^<http://www.w3.org/2001/XMLSchema#integer> .\n"
+		"<http://other.org/a> ex:p <http://example.org/ns#not/local> ,\n"
+		"\t\t<http://example.org/ns#a.> .\n";
+	
+	REQUIRE(toTurtle(input) == expected);
+}
+
+TEST_CASE("turtle round trip", "[turtle]")
+{
+	std::string input =
+		"@prefix ex: <http://example.org/ns#> .\n"
+		"@prefix : <http://example.org/default/> .\n"
+		"@prefix xsd: <http://www.w3.org/2001/XMLSchema#> .\n"
+		"ex:s ex:p ex:o, \"plain\", \"tagged\"@en, \"it's \\\"quoted\\\"\\n\"^^ex:type, 42, -1.5, 1E3, false ;\n"
+		"     a ex:Class ;\n"
+		"     :q \"2\"^^xsd:decimal, \"x\"^^xsd:double .\n"
+		"@prefix ex: <http://example.org/other#> .\n"
+		"ex:s ex:p :a-b.c, <http://example.org/ns#s> .\n"
+		":x ex:p \"\"\"long\nstring\"\"\" .\n";
+	
+	std::string output = toTurtle(input);
+	
+	REQUIRE(output.find("ex:s ex:p ex:o ,") != std::string::npos);
+	REQUIRE(output.find(":q \"2\"^^xsd:decimal ,") != std::string::npos);
+	REQUIRE(ntriples(output) == ntriples(input));
+	REQUIRE(toTurtle(output) == output); // stable
+}
+
+TEST_CASE("turtle lists", "[turtle]")
+{
+	std::string input =
+		"@prefix ex: <http://example.org/ns#> .\n"
+		"ex:x ex:list ( ex:a \"b\" ( ex:c ) () ) .\n"
+		"( 1 2 ) ex:p ex:o .\n";
+	
+	std::string output = toTurtle(input);
+	
+	REQUIRE(output.find("ex:x ex:list ( ex:a \"b\" ( ex:c ) ( ) ) .") != std::string::npos);
+	REQUIRE(output.find("( 1 2 ) ex:p ex:o .") != std::string::npos);
+	REQUIRE(ntriples(output).size() == ntriples(input).size());
+}
@@ -82,6 +82,27 @@ TEST_CASE("resolve", "[uri]") {
 	}
 }
 
+TEST_CASE("resolve into a buffer", "[uri]") {
+	turtle::Uri base("http://a/b/c/d;p?q");
+	const char *references[] = { "g", "./g", "/g", "//g", "?y", "#s", "", ".", "..", "../../../g", "g;x=1/../y", "g?y/../x", "//u@h:8/./x/../y?z#f" };
+	
+	std::string result;
+	for (const char *reference : references) {
+		base.resolve(reference, result); // the buffer is reused, the earlier result must not leak into this one
+		REQUIRE(result == resolve(base, reference));
+	}
+	
+	turtle::Uri noPath("http://a");
+	noPath.resolve("g", result);
+	REQUIRE(result == "http://a/g");
+	
+	turtle::Uri noDirectory("urn:x");
+	noDirectory.resolve("../g", result);
+	REQUIRE(result == "urn:g");
+	
+	REQUIRE_THROWS_AS(base.resolve("//u@:8/x", result), turtle::UriSyntaxException);
+}
+
 TEST_CASE("absolute", "[uri]") {
 	REQUIRE(turtle::Uri::absolute("g:h"));
 	REQUIRE_FALSE(turtle::Uri::absolute(":"));
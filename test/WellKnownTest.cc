@@ -0,0 +1,105 @@
+//
+// Copyright 2016 Giovanni Mels
+// 
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../src/WellKnown.hh"
+#include "../src/Model.hh"
+
+#include "catch.hpp"
+
+
+TEST_CASE("compile time and run time hashes agree", "[wellknown]")
+{
+	static_assert(turtle::WellKnown::hash(N3_RDF "type") != turtle::WellKnown::hash(N3_RDFS "label"), "computed at compile time");
+	
+	const char *iri = N3_RDF "type";
+	REQUIRE(turtle::WellKnown::hash(N3_RDF "type") == turtle::WellKnown::hash(iri, std::strlen(iri)));
+}
+
+TEST_CASE("every well-known IRI is found", "[wellknown]")
+{
+	for (int i = turtle::WellKnown::NONE + 1; i < turtle::WellKnown::COUNT; i++) {
+		turtle::WellKnown::Iri term = static_cast<turtle::WellKnown::Iri>(i);
+		std::string iri = turtle::WellKnown::iri(term);
+		
+		REQUIRE_FALSE(iri.empty());
+		REQUIRE(turtle::WellKnown::lookup(iri) == term);
+		
+		// a matching hash alone is not enough
+		REQUIRE(turtle::WellKnown::lookup(iri.data(), iri.length() - 1) == turtle::WellKnown::NONE);
+		REQUIRE(turtle::WellKnown::lookup(iri + "x") == turtle::WellKnown::NONE);
+	}
+	
+	REQUIRE(turtle::WellKnown::lookup("http://www.w3.org/2001/XMLSchema#integer") == turtle::WellKnown::XSD_INTEGER);
+	REQUIRE(turtle::WellKnown::lookup("http://www.w3.org/2002/07/owl#sameAs") == turtle::WellKnown::OWL_SAME_AS);
+	REQUIRE(turtle::WellKnown::lookup("http://example.org/type") == turtle::WellKnown::NONE);
+	REQUIRE(turtle::WellKnown::lookup("http://www.w3.org/") == turtle::WellKnown::NONE);
+	REQUIRE(turtle::WellKnown::lookup("") == turtle::WellKnown::NONE);
+	REQUIRE(std::string(turtle::WellKnown::iri(turtle::WellKnown::NONE)).empty());
+}
+
+TEST_CASE("resources know whether they are well-known", "[wellknown]")
+{
+	REQUIRE(turtle::RDF::type.wellKnown() == turtle::WellKnown::RDF_TYPE);
+	REQUIRE(turtle::RDF::nil.wellKnown() == turtle::WellKnown::RDF_NIL);
+	REQUIRE(turtle::URIResource(std::string(N3_RDFS "label")).wellKnown() == turtle::WellKnown::RDFS_LABEL);
+	REQUIRE(turtle::URIResource("http://example.org/label").wellKnown() == turtle::WellKnown::NONE);
+	
+	std::unique_ptr<turtle::URIResource> clone(turtle::RDF::type.clone());
+	REQUIRE(clone->wellKnown() == turtle::WellKnown::RDF_TYPE);
+}
+
+TEST_CASE("well-known IRI lookup speed", "[.][benchmark]")
+{
+	std::vector<std::string> iris = {
+		N3_XSD "integer", N3_XSD "string", N3_XSD "dateTime", N3_RDF "type", N3_RDFS "label",
+		"http://example.org/custom#type", "http://www.w3.org/ns/prov#wasDerivedFrom"
+	};
+	const std::string types[] = { N3_XSD "integer", N3_XSD "decimal", N3_XSD "boolean", N3_XSD "double", N3_XSD "string" };
+	
+	const int rounds = 1000000;
+	std::size_t found = 0;
+	
+	auto start = std::chrono::steady_clock::now();
+	for (int r = 0; r < rounds; r++) {
+		for (const std::string &iri : iris)
+			found += turtle::WellKnown::lookup(iri) != turtle::WellKnown::NONE;
+	}
+	std::chrono::duration<double, std::nano> lookup = std::chrono::steady_clock::now() - start;
+	
+	start = std::chrono::steady_clock::now();
+	for (int r = 0; r < rounds; r++) {
+		for (const std::string &iri : iris) {
+			for (const std::string &type : types) {
+				if (iri == type) {
+					found++;
+					break;
+				}
+			}
+		}
+	}
+	std::chrono::duration<double, std::nano> compare = std::chrono::steady_clock::now() - start;
+	
+	std::size_t n = rounds * iris.size();
+	std::cout << "lookup " << lookup.count() / n << " ns, five string comparisons " << compare.count() / n << " ns per IRI" << std::endl;
+	REQUIRE(found == rounds * 7u);
+}